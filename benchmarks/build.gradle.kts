@@ -0,0 +1,103 @@
+import org.jetbrains.kotlin.gradle.ExperimentalKotlinGradlePluginApi
+
+plugins {
+    alias(libs.plugins.kotlin.mpp)
+    alias(libs.plugins.kotlin.allopen)
+    alias(libs.plugins.kotlinx.benchmark)
+}
+
+kotlin {
+    jvm {
+        // The corpus throughput harness
+        @OptIn(ExperimentalKotlinGradlePluginApi::class)
+        mainRun {
+            mainClass.set("io.github.treesitter.ktreesitter.benchmarks.harness.HarnessKt")
+        }
+    }
+
+    linuxX64 {}
+    linuxArm64 {}
+    macosArm64 {}
+    macosX64 {}
+    mingwX64 {}
+
+    applyDefaultHierarchyTemplate()
+
+    jvmToolchain(17)
+
+    sourceSets {
+        commonMain {
+            @OptIn(ExperimentalKotlinGradlePluginApi::class)
+            languageSettings {
+                compilerOptions {
+                    freeCompilerArgs.add("-Xexpect-actual-classes")
+                }
+            }
+
+            dependencies {
+                implementation(libs.kotlin.stdlib)
+                implementation(libs.kotlinx.benchmark.runtime)
+                implementation(project(":ktreesitter"))
+                implementation(project(":languages:java"))
+            }
+        }
+    }
+}
+
+allOpen {
+    annotation("org.openjdk.jmh.annotations.State")
+}
+
+benchmark {
+    targets {
+        register("jvm")
+        register("linuxX64")
+        register("linuxArm64")
+        register("macosArm64")
+        register("macosX64")
+        register("mingwX64")
+    }
+
+    configurations {
+        named("main") {
+            warmups = 5
+            iterations = 10
+            iterationTime = 1
+            iterationTimeUnit = "s"
+            mode = "thrpt"
+            outputTimeUnit = "s"
+            reportFormat = "json"
+        }
+
+        // Reports the allocation rate on the JVM
+        register("gc") {
+            warmups = 5
+            iterations = 10
+            iterationTime = 1
+            iterationTimeUnit = "s"
+            reportFormat = "json"
+            advanced("jvmProfiler", "gc")
+        }
+
+        // Reports the average time per operation, which
+        // is comparable between the JVM and native targets
+        register("time") {
+            warmups = 5
+            iterations = 10
+            iterationTime = 1
+            iterationTimeUnit = "s"
+            mode = "avgt"
+            outputTimeUnit = "us"
+            reportFormat = "json"
+        }
+
+        // Runs every benchmark once, to check that they work
+        register("smoke") {
+            warmups = 1
+            iterations = 1
+            iterationTime = 100
+            iterationTimeUnit = "ms"
+            param("size", "small")
+        }
+    }
+}
@@ -0,0 +1,96 @@
+package io.github.treesitter.ktreesitter.benchmarks
+
+import io.github.treesitter.ktreesitter.InputEdit
+import io.github.treesitter.ktreesitter.Point
+import kotlin.random.Random
+
+/**
+ * A corpus of Java sources that are generated from a fixed seed,
+ * so that every run on every target parses exactly the same text.
+ *
+ * The sources only contain ASCII characters, so that
+ * their byte offsets are equal to their character offsets.
+ */
+internal object Corpus {
+    private const val SEED = 26
+
+    private const val METHODS_PER_CLASS = 20
+
+    /** The number of classes in each size of the corpus. */
+    private val classCounts = mapOf("small" to 1, "medium" to 10, "large" to 100)
+
+    private val types = listOf("int", "long", "String", "boolean", "double", "List<String>")
+
+    private val words = listOf(
+        "value", "count", "index", "name", "result", "buffer", "node", "item",
+        "total", "offset", "length", "state", "entry", "token", "cursor", "limit"
+    )
+
+    /** Generate the source of the given size, which is `small`, `medium` or `large`. */
+    fun source(size: String): String {
+        val classCount = classCounts[size]
+            ?: throw IllegalArgumentException("Invalid corpus size: $size")
+        val random = Random(SEED)
+        return buildString {
+            append("package io.github.treesitter.benchmark;\n\n")
+            append("import java.util.ArrayList;\n")
+            append("import java.util.List;\n\n")
+            repeat(classCount) { appendClass(random, it) }
+        }
+    }
+
+    /**
+     * Change the first integer literal after the middle of the source,
+     * which does not change the structure of the syntax tree.
+     *
+     * @return The new source and the edit that transforms the old one into it.
+     */
+    fun edit(source: String): Pair<String, InputEdit> {
+        val offset = source.indexOf(" = 0;", source.length / 2) + 3
+        val newSource = source.substring(0, offset) + "1" + source.substring(offset + 1)
+        val row = source.subSequence(0, offset).count { it == '\n' }
+        val column = offset - source.lastIndexOf('\n', offset - 1) - 1
+        val start = Point(row.toUInt(), column.toUInt())
+        val end = Point(row.toUInt(), column.toUInt() + 1U)
+        val byte = offset.toUInt()
+        return newSource to InputEdit(byte, byte + 1U, byte + 1U, start, end, end)
+    }
+
+    private fun StringBuilder.appendClass(random: Random, index: Int) {
+        val name = "Generated$index"
+        append("/** A generated class. */\n")
+        append("public class $name {\n")
+        append("    private static final int MAX_$index = ${random.nextInt(1000)};\n")
+        append("    private final List<String> names = new ArrayList<>();\n\n")
+        repeat(METHODS_PER_CLASS) { appendMethod(random, it) }
+        append("}\n\n")
+    }
+
+    private fun StringBuilder.appendMethod(random: Random, index: Int) {
+        val type = types[random.nextInt(types.size)]
+        val name = words[random.nextInt(words.size)] + index
+        val parameter = words[random.nextInt(words.size)]
+        append("    // Compute the $name.\n")
+        append("    public $type $name(int $parameter) {\n")
+        append("        int total = 0;\n")
+        append("        for (int i = 0; i < $parameter; i++) {\n")
+        append("            if (i % ${random.nextInt(2, 10)} == 0) {\n")
+        append("                total += i * ${random.nextInt(100)};\n")
+        append("            } else {\n")
+        append("                names.add(\"${words[random.nextInt(words.size)]}\" + i);\n")
+        append("            }\n")
+        append("        }\n")
+        append("        System.out.println(\"$name: \" + total);\n")
+        append("        ${returnStatement(type)}\n")
+        append("    }\n\n")
+    }
+
+    private fun returnStatement(type: String) = when (type) {
+        "int" -> "return total;"
+        "long" -> "return (long) total;"
+        "String" -> "return String.valueOf(total);"
+        "boolean" -> "return total > 0;"
+        "double" -> "return total / 2.0;"
+        else -> "return names;"
+    }
+}
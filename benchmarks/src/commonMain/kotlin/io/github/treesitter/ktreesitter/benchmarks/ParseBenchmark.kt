@@ -0,0 +1,48 @@
+package io.github.treesitter.ktreesitter.benchmarks
+
+import io.github.treesitter.ktreesitter.InputEdit
+import io.github.treesitter.ktreesitter.Language
+import io.github.treesitter.ktreesitter.Parser
+import io.github.treesitter.ktreesitter.Tree
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import kotlinx.benchmark.*
+
+/** Measures full and incremental parsing. */
+@State(Scope.Benchmark)
+class ParseBenchmark {
+    @Param("small", "medium", "large")
+    var size = ""
+
+    private lateinit var parser: Parser
+
+    private lateinit var source: String
+
+    private lateinit var editedSource: String
+
+    private lateinit var edit: InputEdit
+
+    private lateinit var tree: Tree
+
+    @Setup
+    fun setup() {
+        parser = Parser(Language(TreeSitterJava.language()))
+        source = Corpus.source(size)
+        Corpus.edit(source).let {
+            editedSource = it.first
+            edit = it.second
+        }
+        tree = parser.parse(source)
+    }
+
+    /** Parse the whole source. */
+    @Benchmark
+    fun parse() = parser.parse(source)
+
+    /** Parse the source again after changing a single character. */
+    @Benchmark
+    fun reparse(): Tree {
+        val oldTree = tree.copy()
+        oldTree.edit(edit)
+        return parser.parse(editedSource, oldTree = oldTree)
+    }
+}
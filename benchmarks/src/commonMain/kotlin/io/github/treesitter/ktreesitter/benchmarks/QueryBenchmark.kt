@@ -0,0 +1,54 @@
+package io.github.treesitter.ktreesitter.benchmarks
+
+import io.github.treesitter.ktreesitter.Language
+import io.github.treesitter.ktreesitter.Parser
+import io.github.treesitter.ktreesitter.Query
+import io.github.treesitter.ktreesitter.Tree
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import kotlinx.benchmark.*
+
+/** Measures query execution, with and without text predicates. */
+@State(Scope.Benchmark)
+class QueryBenchmark {
+    @Param("small", "medium", "large")
+    var size = ""
+
+    private lateinit var tree: Tree
+
+    private lateinit var query: Query
+
+    private lateinit var predicateQuery: Query
+
+    @Setup
+    fun setup() {
+        val language = Language(TreeSitterJava.language())
+        tree = Parser(language).parse(Corpus.source(size))
+        query = Query(
+            language,
+            """
+            (class_declaration name: (identifier) @class)
+            (method_declaration name: (identifier) @method)
+            (method_invocation name: (identifier) @call)
+            """.trimIndent()
+        )
+        predicateQuery = Query(
+            language,
+            """
+            ((identifier) @constant (#match? @constant "^[A-Z][A-Z0-9_]*$"))
+            ((method_invocation name: (identifier) @call) (#eq? @call "println"))
+            """.trimIndent()
+        )
+    }
+
+    /** Count the matches of the patterns without predicates. */
+    @Benchmark
+    fun matches() = query(tree.rootNode).matches().count()
+
+    /** Count the captures of the patterns without predicates. */
+    @Benchmark
+    fun captures() = query(tree.rootNode).captures().count()
+
+    /** Count the matches of the patterns with predicates. */
+    @Benchmark
+    fun predicates() = predicateQuery(tree.rootNode).matches().count()
+}
@@ -0,0 +1,79 @@
+package io.github.treesitter.ktreesitter.benchmarks
+
+import io.github.treesitter.ktreesitter.Language
+import io.github.treesitter.ktreesitter.Node
+import io.github.treesitter.ktreesitter.Parser
+import io.github.treesitter.ktreesitter.Tree
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import kotlinx.benchmark.*
+
+/** Measures the traversal of a syntax tree and the node accessors. */
+@State(Scope.Benchmark)
+class TreeBenchmark {
+    @Param("small", "medium", "large")
+    var size = ""
+
+    private lateinit var tree: Tree
+
+    private lateinit var identifiers: List<Node>
+
+    @Setup
+    fun setup() {
+        val parser = Parser(Language(TreeSitterJava.language()))
+        tree = parser.parse(Corpus.source(size))
+        identifiers = expand(tree.rootNode).filter { it.type == "identifier" }
+    }
+
+    /** Visit every node with a [cursor][io.github.treesitter.ktreesitter.TreeCursor]. */
+    @Benchmark
+    fun walk(): Int {
+        val cursor = tree.walk()
+        var count = 1
+        while (true) {
+            if (cursor.gotoFirstChild() || cursor.gotoNextSibling()) {
+                count += 1
+                continue
+            }
+            do {
+                if (!cursor.gotoParent()) return count
+            } while (!cursor.gotoNextSibling())
+            count += 1
+        }
+    }
+
+    /** Visit every node through [Node.children]. */
+    @Benchmark
+    fun children() = expand(tree.rootNode).size
+
+    /** Read the scalar properties of every identifier. */
+    @Benchmark
+    fun properties(blackhole: Blackhole) {
+        for (node in identifiers) {
+            blackhole.consume(node.symbol.toInt())
+            blackhole.consume(node.isNamed)
+            blackhole.consume(node.startByte.toInt())
+            blackhole.consume(node.endByte.toInt())
+            blackhole.consume(node.childCount.toInt())
+        }
+    }
+
+    /** Get the text of every identifier. */
+    @Benchmark
+    fun text(blackhole: Blackhole) {
+        for (node in identifiers) {
+            blackhole.consume(node.text())
+        }
+    }
+
+    private fun expand(root: Node): List<Node> {
+        val nodes = ArrayList<Node>()
+        val stack = ArrayDeque<Node>()
+        stack.addLast(root)
+        while (stack.isNotEmpty()) {
+            val node = stack.removeLast()
+            nodes.add(node)
+            stack.addAll(node.children)
+        }
+        return nodes
+    }
+}
@@ -0,0 +1,283 @@
+package io.github.treesitter.ktreesitter.benchmarks.harness
+
+import io.github.treesitter.ktreesitter.*
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import java.io.File
+import java.lang.management.ManagementFactory
+import java.util.concurrent.Executors
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicInteger
+import kotlin.random.Random
+import kotlin.system.exitProcess
+
+private const val USAGE = """Usage: harness [options] <directory>
+
+Parse and query every file of the directory whose extension has a language.
+
+Options:
+  --language <ext>=<library>  Load the language of an extension from a shared library
+  --query <ext>=<file>        Run the query in the file on every tree of an extension
+  --threads <count>           The number of parsing threads (default: 1)
+  --edits <count>             The number of edits to replay on every file (default: 0)
+  --seed <seed>               The seed of the edit scripts (default: 26)
+  --repeat <count>            The number of times to parse the corpus (default: 1)"""
+
+/** The options of the harness. */
+private class Options(
+    val directory: File,
+    val libraries: Map<String, String>,
+    val queries: Map<String, File>,
+    val threads: Int,
+    val edits: Int,
+    val seed: Int,
+    val repeat: Int
+) {
+    companion object {
+        @Throws(IllegalArgumentException::class)
+        fun parse(args: Array<String>): Options {
+            val libraries = mutableMapOf<String, String>()
+            val queries = mutableMapOf<String, File>()
+            var threads = 1
+            var edits = 0
+            var seed = 26
+            var repeat = 1
+            var directory: File? = null
+            val iterator = args.iterator()
+            while (iterator.hasNext()) {
+                when (val arg = iterator.next()) {
+                    "--language" -> iterator.pair(arg).let { libraries[it.first] = it.second }
+                    "--query" -> iterator.pair(arg).let { queries[it.first] = File(it.second) }
+                    "--threads" -> threads = iterator.count(arg)
+                    "--edits" -> edits = iterator.count(arg, 0)
+                    "--seed" -> seed = iterator.value(arg).toInt()
+                    "--repeat" -> repeat = iterator.count(arg)
+                    else -> {
+                        require(!arg.startsWith("--")) { "Unknown option: $arg" }
+                        require(directory == null) { "Only one directory can be given" }
+                        directory = File(arg)
+                    }
+                }
+            }
+            requireNotNull(directory) { "No directory was given" }
+            require(directory.isDirectory) { "Not a directory: $directory" }
+            return Options(directory, libraries, queries, threads, edits, seed, repeat)
+        }
+
+        private fun Iterator<String>.value(option: String): String {
+            require(hasNext()) { "Missing value for $option" }
+            return next()
+        }
+
+        private fun Iterator<String>.count(option: String, min: Int = 1): Int {
+            val value = value(option).toIntOrNull()
+            require(value != null && value >= min) { "Invalid value for $option" }
+            return value
+        }
+
+        private fun Iterator<String>.pair(option: String): Pair<String, String> {
+            val value = value(option)
+            val separator = value.indexOf('=')
+            require(separator > 0) { "Expected <ext>=<path> for $option" }
+            return value.substring(0, separator).removePrefix(".") to value.substring(separator + 1)
+        }
+    }
+}
+
+/** A file of the corpus with the language of its extension. */
+private class SourceFile(val path: String, val text: String, val bytes: Int, val language: Language)
+
+/** The time that each file took to parse and query, in nanoseconds. */
+private class Timings(size: Int) {
+    val parse = LongArray(size)
+    val query = LongArray(size)
+    val errors = AtomicInteger()
+}
+
+/** The state of a thread, since parsers and query cursors must not be shared. */
+private class Worker(private val queries: Map<Language, Query>) {
+    private val parser = Parser()
+
+    fun parse(file: SourceFile, oldTree: Tree? = null): Tree {
+        parser.language = file.language
+        return parser.parse(file.text, oldTree = oldTree)
+    }
+
+    fun query(tree: Tree) = queries[tree.language]?.invoke(tree.rootNode)?.matches()?.count() ?: 0
+}
+
+fun main(args: Array<String>) {
+    // The tracking allocator is needed to report the native memory
+    if (System.getProperty("ktreesitter.allocator") == null)
+        System.setProperty("ktreesitter.allocator", "tracking")
+
+    val options = try {
+        Options.parse(args)
+    } catch (ex: IllegalArgumentException) {
+        System.err.println("${ex.message}\n\n$USAGE")
+        exitProcess(2)
+    }
+
+    val registry = LanguageRegistry()
+    registry.register("java", Language(TreeSitterJava.language()), listOf("java"))
+    for ((extension, library) in options.libraries) {
+        registry.registerLibrary(extension, library, listOf(extension))
+    }
+    val queries = options.queries.mapNotNull { (extension, file) ->
+        registry.forExtension(extension)?.let { it to Query(it, file.readText()) }
+    }.toMap()
+
+    val files = options.directory.walkTopDown().filter { it.isFile }.mapNotNull { file ->
+        val language = registry.forPath(file.path) ?: return@mapNotNull null
+        val bytes = file.readBytes()
+        SourceFile(file.path, bytes.decodeToString(), bytes.size, language)
+    }.toList()
+    if (files.isEmpty()) {
+        System.err.println("No files with a known language were found in ${options.directory}")
+        exitProcess(1)
+    }
+
+    val totalBytes = files.sumOf { it.bytes.toLong() } * options.repeat
+    val gcBefore = gcStats()
+    val timings = Timings(files.size * options.repeat)
+    val start = System.nanoTime()
+    runParallel(options.threads, files.size * options.repeat, queries) { worker, index ->
+        val file = files[index % files.size]
+        val parseStart = System.nanoTime()
+        val tree = worker.parse(file)
+        val queryStart = System.nanoTime()
+        worker.query(tree)
+        timings.query[index] = System.nanoTime() - queryStart
+        timings.parse[index] = queryStart - parseStart
+        if (tree.rootNode.hasError) timings.errors.incrementAndGet()
+    }
+    val seconds = (System.nanoTime() - start) / 1e9
+    val gcAfter = gcStats()
+
+    println("Files:         ${files.size} (${formatBytes(totalBytes / options.repeat)})")
+    println("Threads:       ${options.threads}")
+    println("Throughput:    %.2f MB/s, %.1f files/s".format(
+        totalBytes / seconds / 1e6, timings.parse.size / seconds
+    ))
+    println("Parse latency: ${formatPercentiles(timings.parse)}")
+    if (queries.isNotEmpty()) println("Query latency: ${formatPercentiles(timings.query)}")
+    println("Syntax errors: ${timings.errors.get() / options.repeat} files")
+    println("GC time:       ${gcAfter.first - gcBefore.first} ms " +
+        "in ${gcAfter.second - gcBefore.second} collections")
+    println("Native memory: ${formatBytes(TreeSitter.peakAllocatedBytes.toLong())} peak, " +
+        "${formatBytes(TreeSitter.allocatedBytes.toLong())} live")
+    println("Peak RSS:      ${peakRss()?.let(::formatBytes) ?: "unavailable"}")
+
+    if (options.edits > 0) replayEdits(files, options, queries)
+}
+
+/** Replay random single character edits on every file, with incremental and full reparses. */
+private fun replayEdits(files: List<SourceFile>, options: Options, queries: Map<Language, Query>) {
+    val incremental = LongArray(files.size * options.edits)
+    val full = LongArray(files.size * options.edits)
+    runParallel(options.threads, files.size, queries) { worker, index ->
+        val file = files[index]
+        val random = Random(options.seed + index)
+        var text = file.text
+        var tree = worker.parse(file)
+        repeat(options.edits) { step ->
+            val (newText, edit) = randomEdit(text, random) ?: return@runParallel
+            val editedFile = SourceFile(file.path, newText, file.bytes, file.language)
+            val incrementalStart = System.nanoTime()
+            tree.edit(edit)
+            val newTree = worker.parse(editedFile, tree)
+            val fullStart = System.nanoTime()
+            worker.parse(editedFile)
+            full[index * options.edits + step] = System.nanoTime() - fullStart
+            incremental[index * options.edits + step] = fullStart - incrementalStart
+            text = newText
+            tree = newTree
+        }
+    }
+    val speedup = median(full).toDouble() / median(incremental).coerceAtLeast(1L)
+    println("Edits:         ${options.edits} per file")
+    println("Incremental:   ${formatPercentiles(incremental)}")
+    println("Full reparse:  ${formatPercentiles(full)}")
+    println("Speedup:       %.1fx at p50".format(speedup))
+}
+
+/**
+ * Replace a random letter or digit of the text with another one.
+ *
+ * @return The new text and its edit, or `null` if the text has no letters or digits.
+ */
+private fun randomEdit(text: String, random: Random): Pair<String, InputEdit>? {
+    if (text.none(Char::isLetterOrDigit)) return null
+    var offset = random.nextInt(text.length)
+    while (!text[offset].isLetterOrDigit()) offset = (offset + 1) % text.length
+    val replacement = if (text[offset] == 'x') 'y' else 'x'
+    val newText = text.substring(0, offset) + replacement + text.substring(offset + 1)
+
+    val lineStart = text.lastIndexOf('\n', offset - 1) + 1
+    val row = text.subSequence(0, lineStart).count { it == '\n' }.toUInt()
+    val column = text.substring(lineStart, offset).encodeToByteArray().size.toUInt()
+    val byte = lineStart.let { text.substring(0, it).encodeToByteArray().size.toUInt() } + column
+    val oldEnd = byte + text[offset].toString().encodeToByteArray().size.toUInt()
+    val newEnd = byte + 1U
+    return newText to InputEdit(
+        byte,
+        oldEnd,
+        newEnd,
+        Point(row, column),
+        Point(row, column + (oldEnd - byte)),
+        Point(row, column + 1U)
+    )
+}
+
+/** Run the task for every index on a pool of threads, each with its own [Worker]. */
+private fun runParallel(
+    threads: Int,
+    count: Int,
+    queries: Map<Language, Query>,
+    task: (Worker, Int) -> Unit
+) {
+    val next = AtomicInteger()
+    val executor = Executors.newFixedThreadPool(threads)
+    val futures = List(threads) {
+        executor.submit {
+            val worker = Worker(queries)
+            while (true) {
+                val index = next.getAndIncrement()
+                if (index >= count) break
+                task(worker, index)
+            }
+        }
+    }
+    executor.shutdown()
+    futures.forEach { it.get() }
+    executor.awaitTermination(1, TimeUnit.MINUTES)
+}
+
+private fun median(values: LongArray) = values.sortedArray()[values.size / 2]
+
+private fun formatPercentiles(values: LongArray): String {
+    val sorted = values.sortedArray()
+    fun percentile(p: Double) = sorted[((sorted.size - 1) * p).toInt()] / 1e6
+    return "p50 %.3f ms, p99 %.3f ms, p99.9 %.3f ms".format(
+        percentile(0.5), percentile(0.99), percentile(0.999)
+    )
+}
+
+private fun formatBytes(bytes: Long) = when {
+    bytes >= 1 shl 30 -> "%.2f GB".format(bytes / (1 shl 30).toDouble())
+    bytes >= 1 shl 20 -> "%.2f MB".format(bytes / (1 shl 20).toDouble())
+    bytes >= 1 shl 10 -> "%.2f KB".format(bytes / (1 shl 10).toDouble())
+    else -> "$bytes B"
+}
+
+/** Get the total time in milliseconds and the number of garbage collections. */
+private fun gcStats() = ManagementFactory.getGarbageCollectorMXBeans().fold(0L to 0L) { acc, bean ->
+    (acc.first + bean.collectionTime.coerceAtLeast(0)) to
+        (acc.second + bean.collectionCount.coerceAtLeast(0))
+}
+
+/** Get the peak resident set size of the process, which is only available on Linux. */
+private fun peakRss(): Long? {
+    val status = File("/proc/self/status").takeIf { it.canRead() } ?: return null
+    val line = status.readLines().firstOrNull { it.startsWith("VmHWM:") } ?: return null
+    return line.removePrefix("VmHWM:").trim().removeSuffix("kB").trim().toLongOrNull()?.times(1024)
+}
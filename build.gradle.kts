@@ -1,5 +1,7 @@
 plugins {
     alias(libs.plugins.kotlin.mpp) apply false
+    alias(libs.plugins.kotlin.allopen) apply false
+    alias(libs.plugins.kotlinx.benchmark) apply false
     alias(libs.plugins.android.library) apply false
     alias(libs.plugins.kotest) apply false
     alias(libs.plugins.ksp) apply false
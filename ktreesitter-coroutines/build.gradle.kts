@@ -0,0 +1,168 @@
+import org.jetbrains.kotlin.gradle.ExperimentalKotlinGradlePluginApi
+import org.jetbrains.kotlin.gradle.dsl.JvmTarget
+import org.jetbrains.kotlin.gradle.tasks.KotlinJvmCompile
+
+version = property("project.version") as String
+
+plugins {
+    `maven-publish`
+    signing
+    alias(libs.plugins.kotlin.mpp)
+    alias(libs.plugins.android.library)
+    alias(libs.plugins.kotest)
+    alias(libs.plugins.ksp)
+}
+
+kotlin {
+    jvm {}
+
+    androidTarget {
+        withSourcesJar(true)
+        publishLibraryVariants("release")
+    }
+
+    linuxX64 {}
+    linuxArm64 {}
+    mingwX64 {}
+    macosArm64 {}
+    macosX64 {}
+    iosArm64 {}
+    iosSimulatorArm64 {}
+
+    applyDefaultHierarchyTemplate()
+
+    jvmToolchain(17)
+
+    sourceSets {
+        commonMain {
+            @OptIn(ExperimentalKotlinGradlePluginApi::class)
+            languageSettings {
+                compilerOptions {
+                    freeCompilerArgs.add("-Xexpect-actual-classes")
+                }
+            }
+
+            dependencies {
+                implementation(libs.kotlin.stdlib)
+                api(project(":ktreesitter"))
+                api(libs.kotlinx.coroutines.core)
+            }
+        }
+
+        commonTest {
+            dependencies {
+                implementation(libs.bundles.kotest.core)
+                implementation(project(":languages:java"))
+            }
+        }
+
+        jvmTest {
+            dependencies {
+                implementation(libs.bundles.kotest.junit)
+                implementation(libs.kotest.symbolprocessor)
+            }
+        }
+
+        getByName("androidInstrumentedTest") {
+            dependencies {
+                implementation(libs.bundles.kotest.core)
+                implementation(libs.bundles.kotest.android)
+                implementation(project(":languages:java"))
+            }
+        }
+    }
+}
+
+android {
+    namespace = "io.github.treesitter.ktreesitter.coroutines"
+    compileSdk = (property("sdk.version.compile") as String).toInt()
+    defaultConfig {
+        minSdk = (property("sdk.version.min") as String).toInt()
+        testInstrumentationRunner = "androidx.test.runner.AndroidJUnitRunner"
+    }
+    compileOptions {
+        sourceCompatibility = JavaVersion.VERSION_17
+        targetCompatibility = JavaVersion.VERSION_17
+    }
+}
+
+tasks.register<Jar>("javadocJar") {
+    group = "documentation"
+    archiveClassifier.set("javadoc")
+    from(files(rootDir.resolve("README.md")))
+}
+
+publishing {
+    publications.withType(MavenPublication::class) {
+        artifact(tasks["javadocJar"])
+        pom {
+            name = "KTreeSitter Coroutines"
+            description = "Coroutine support for the Kotlin bindings to Tree-sitter"
+            url = "https://tree-sitter.github.io/kotlin-tree-sitter/"
+            inceptionYear = "2024"
+            organization {
+                name = "tree-sitter"
+                url = "https://github.com/tree-sitter"
+            }
+            licenses {
+                license {
+                    name = "MIT License"
+                    url = "https://spdx.org/licenses/MIT.html"
+                }
+            }
+            developers {
+                developer {
+                    id = "ObserverOfTime"
+                    name = "ObserverOfTime"
+                    email = "chronobserver@disroot.org"
+                    url = "https://github.com/ObserverOfTime"
+                }
+            }
+            scm {
+                url = "https://github.com/tree-sitter/kotlin-tree-sitter"
+                connection = "scm:git:git://github.com/tree-sitter/kotlin-tree-sitter.git"
+                developerConnection = "scm:git:ssh://github.com/tree-sitter/kotlin-tree-sitter.git"
+            }
+            issueManagement {
+                system = "GitHub Issues"
+                url = "https://github.com/tree-sitter/kotlin-tree-sitter/issues"
+            }
+        }
+    }
+
+    repositories {
+        maven {
+            name = "local"
+            url = uri(layout.buildDirectory.dir("repo"))
+        }
+    }
+}
+
+signing {
+    isRequired = System.getenv("CI") != null
+    if (isRequired) {
+        val key = System.getenv("SIGNING_KEY")
+        val password = System.getenv("SIGNING_PASSWORD")
+        useInMemoryPgpKeys(key, password)
+    }
+    sign(publishing.publications)
+}
+
+tasks.withType<KotlinJvmCompile>().configureEach {
+    compilerOptions {
+        jvmTarget.set(JvmTarget.JVM_17)
+        freeCompilerArgs.add("-Xlambdas=indy")
+    }
+}
+
+tasks.getByName<Test>("jvmTest") {
+    useJUnitPlatform()
+    reports.junitXml.apply {
+        required.set(true)
+        outputLocation.set(layout.buildDirectory.dir("reports/xml"))
+    }
+}
+
+tasks.withType<AbstractPublishToMaven>().configureEach {
+    mustRunAfter(tasks.withType<Sign>())
+}
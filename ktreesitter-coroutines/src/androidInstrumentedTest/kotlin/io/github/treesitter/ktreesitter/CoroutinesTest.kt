@@ -0,0 +1,70 @@
+package io.github.treesitter.ktreesitter
+
+import br.com.colman.kotest.KotestRunnerAndroid
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import io.kotest.assertions.throwables.shouldThrow
+import io.kotest.core.spec.style.FunSpec
+import io.kotest.matchers.*
+import io.kotest.matchers.collections.*
+import kotlinx.coroutines.CoroutineStart
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.coroutineScope
+import kotlinx.coroutines.flow.map
+import kotlinx.coroutines.flow.take
+import kotlinx.coroutines.flow.toList
+import kotlinx.coroutines.launch
+import org.junit.runner.RunWith
+
+@RunWith(KotestRunnerAndroid::class)
+class CoroutinesTest : FunSpec({
+    val language = Language(TreeSitterJava.language())
+    val query = Query(language, "(identifier) @identifier")
+
+    test("parseAsync(source)") {
+        val parser = Parser(language)
+        val tree = parser.parseAsync("class Foo {}")
+        tree.text() shouldBe "class Foo {}"
+        tree.rootNode.type shouldBe "program"
+        shouldThrow<IllegalStateException> { Parser().parseAsync("class Foo {}") }
+    }
+
+    test("parseAsync(readCallback)") {
+        val parser = Parser(language)
+        val source = "class Foo {}\n".repeat(1000)
+        val tree = parser.parseAsync { byte, _ ->
+            source.substring(byte.toInt(), minOf(byte.toInt() + 1024, source.length))
+                .ifEmpty { null }
+        }
+        tree.rootNode.childCount shouldBe 1000U
+
+        lateinit var job: Job
+        coroutineScope {
+            job = launch(start = CoroutineStart.LAZY) {
+                parser.parseAsync { byte, _ ->
+                    if (byte >= 4096U) job.cancel()
+                    source.substring(byte.toInt(), minOf(byte.toInt() + 1024, source.length))
+                        .ifEmpty { null }
+                }
+            }
+            job.start()
+        }
+        job.isCancelled shouldBe true
+        parser.progressListener shouldBe null
+        parser.parseAsync("class Bar {}").rootNode.hasError shouldBe false
+    }
+
+    test("matchesFlow()") {
+        val tree = Parser(language).parse("class Foo { int bar; }")
+        val names = query.matchesFlow(tree.rootNode).map {
+            it["identifier"].single().text().toString()
+        }
+        names.toList() shouldBe listOf("Foo", "bar")
+        query.matchesFlow(tree.rootNode).take(1).toList() shouldHaveSize 1
+    }
+
+    test("capturesFlow()") {
+        val tree = Parser(language).parse("class Foo { int bar; }")
+        val indices = query.capturesFlow(tree.rootNode).map { it.first }
+        indices.toList() shouldBe listOf(0U, 0U)
+    }
+})
@@ -0,0 +1,132 @@
+@file:kotlin.jvm.JvmName("KTreeSitterCoroutines")
+
+package io.github.treesitter.ktreesitter
+
+import kotlin.coroutines.CoroutineContext
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.currentCoroutineContext
+import kotlinx.coroutines.ensureActive
+import kotlinx.coroutines.flow.Flow
+import kotlinx.coroutines.flow.flow
+import kotlinx.coroutines.flow.flowOn
+import kotlinx.coroutines.job
+import kotlinx.coroutines.withContext
+
+/**
+ * Parse a source code string in the given [context] and create a syntax tree.
+ *
+ * When the coroutine is cancelled, the parse is halted the next time the parser checks
+ * its [progress listener][Parser.progressListener], which is temporarily wrapped to
+ * check for cancellation, and the parser is [reset][Parser.reset] so that it can be
+ * reused for any document. The parser must not be used elsewhere until this returns.
+ *
+ * @throws [IllegalStateException]
+ *  If the parser does not have a [language][Parser.language] assigned or if parsing was halted.
+ * @throws [MemoryLimitExceededException]
+ *  If the [memory limit][Parser.memoryLimitBytes] is exceeded.
+ * @see Parser.parse
+ * @since 0.26.0
+ */
+@Throws(IllegalStateException::class, CancellationException::class)
+suspend fun Parser.parseAsync(
+    source: String,
+    encoding: InputEncoding = InputEncoding.UTF_8,
+    oldTree: Tree? = null,
+    context: CoroutineContext = Dispatchers.Default
+): Tree = withContext(context) {
+    parseCancellable(coroutineContext.job) { parse(source, encoding, oldTree) }
+}
+
+/**
+ * Parse source code from a callback in the given [context] and create a syntax tree.
+ *
+ * When the coroutine is cancelled, the parse is halted the next time the parser checks
+ * its [progress listener][Parser.progressListener], which is temporarily wrapped to
+ * check for cancellation, and the parser is [reset][Parser.reset] so that it can be
+ * reused for any document. The parser must not be used elsewhere until this returns.
+ *
+ * @throws [IllegalStateException]
+ *  If the parser does not have a [language][Parser.language] assigned or if parsing was halted.
+ * @throws [MemoryLimitExceededException]
+ *  If the [memory limit][Parser.memoryLimitBytes] is exceeded.
+ * @see Parser.parse
+ * @since 0.26.0
+ */
+@Throws(IllegalStateException::class, CancellationException::class)
+suspend fun Parser.parseAsync(
+    encoding: InputEncoding = InputEncoding.UTF_8,
+    oldTree: Tree? = null,
+    context: CoroutineContext = Dispatchers.Default,
+    progressCallback: ParseProgressCallback? = null,
+    readCallback: ParseReadCallback
+): Tree = withContext(context) {
+    parseCancellable(coroutineContext.job) {
+        parse(encoding, oldTree, progressCallback, readCallback)
+    }
+}
+
+/**
+ * Execute the query on the given [node] in the given [context]
+ * and emit its matches in the order that they were found.
+ *
+ * When the collector is cancelled, the execution is halted the next
+ * time the cursor checks its [progress listener][QueryCursor.progressListener].
+ *
+ * @param predicate A function that handles custom predicates.
+ * @see QueryCursor.matches
+ * @since 0.26.0
+ */
+fun Query.matchesFlow(
+    node: Node,
+    context: CoroutineContext = Dispatchers.Default,
+    predicate: QueryPredicate.(QueryMatch) -> Boolean = { true }
+): Flow<QueryMatch> = flow {
+    val cursor = cancellableCursor(node)
+    cursor.matches(predicate).forEach { emit(it) }
+    currentCoroutineContext().ensureActive()
+}.flowOn(context)
+
+/**
+ * Execute the query on the given [node] in the given [context]
+ * and emit its individual captures in the order that they appear.
+ *
+ * When the collector is cancelled, the execution is halted the next
+ * time the cursor checks its [progress listener][QueryCursor.progressListener].
+ *
+ * @param predicate A function that handles custom predicates.
+ * @see QueryCursor.captures
+ * @since 0.26.0
+ */
+fun Query.capturesFlow(
+    node: Node,
+    context: CoroutineContext = Dispatchers.Default,
+    predicate: QueryPredicate.(QueryMatch) -> Boolean = { true }
+): Flow<Pair<UInt, QueryMatch>> = flow {
+    val cursor = cancellableCursor(node)
+    cursor.captures(predicate).forEach { emit(it) }
+    currentCoroutineContext().ensureActive()
+}.flowOn(context)
+
+private inline fun Parser.parseCancellable(job: Job, parse: Parser.() -> Tree): Tree {
+    val listener = progressListener
+    progressListener = ParseProgressListener { offset, hasError ->
+        !job.isActive || listener?.onProgress(offset, hasError) == true
+    }
+    try {
+        return parse()
+    } catch (e: IllegalStateException) {
+        if (job.isActive) throw e
+        // A cancelled parse must not be resumed by the next one.
+        reset()
+        throw CancellationException("Parsing was cancelled", e)
+    } finally {
+        progressListener = listener
+    }
+}
+
+private suspend fun Query.cancellableCursor(node: Node): QueryCursor {
+    val job = currentCoroutineContext().job
+    return invoke(node).apply { progressListener = QueryProgressListener { !job.isActive } }
+}
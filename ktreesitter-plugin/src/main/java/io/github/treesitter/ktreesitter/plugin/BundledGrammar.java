@@ -0,0 +1,41 @@
+package io.github.treesitter.ktreesitter.plugin;
+
+import java.io.File;
+import org.gradle.api.Named;
+import org.gradle.api.provider.MapProperty;
+import org.gradle.api.provider.Property;
+
+/** A grammar that is compiled into a {@linkplain GrammarBundleExtension bundle}. */
+public interface BundledGrammar extends Named {
+    /**
+     * The name of the grammar.
+     *
+     * <p><b>Required</b></p>
+     */
+    @Override
+    String getName();
+    /**
+     * The base directory of the grammar.
+     *
+     * <p><b>Required</b></p>
+     */
+    Property<File> getBaseDir();
+    /**
+     * The name of the package.
+     *
+     * <p><b>Required</b></p>
+     */
+    Property<String> getPackageName();
+    /**
+     * The name of the class.
+     *
+     * <p><b>Required</b></p>
+     */
+    Property<String> getClassName();
+    /**
+     * A map of Java methods to C functions.
+     *
+     * <p>Default: {@code language -> tree_sitter_${name}}</p>
+     */
+    MapProperty<String, String> getLanguageMethods();
+}
@@ -0,0 +1,42 @@
+package io.github.treesitter.ktreesitter.plugin;
+
+import java.io.File;
+import org.gradle.api.NamedDomainObjectContainer;
+import org.gradle.api.provider.Property;
+
+/**
+ * The grammar bundle configuration extension.
+ *
+ * <p>A bundle compiles many grammars together with the KTreeSitter
+ * JNI sources into a single shared library, which replaces the
+ * {@code ktreesitter} library and the libraries of the grammars.</p>
+ */
+public interface GrammarBundleExtension {
+    /**
+     * The directory of the {@code ktreesitter} module,
+     * which must be next to the {@code tree-sitter} submodule.
+     *
+     * <p><b>Required</b></p>
+     */
+    Property<File> getKtreesitterDir();
+    /**
+     * The name of the JNI library.
+     *
+     * <p>Default: {@code ktreesitter-bundle}</p>
+     */
+    Property<String> getLibraryName();
+    /**
+     * The name of the package of the bundle class.
+     *
+     * <p><b>Required</b></p>
+     */
+    Property<String> getPackageName();
+    /**
+     * The name of the bundle class.
+     *
+     * <p>Default: {@code TreeSitterBundle}</p>
+     */
+    Property<String> getClassName();
+    /** The grammars of the bundle. */
+    NamedDomainObjectContainer<BundledGrammar> getGrammars();
+}
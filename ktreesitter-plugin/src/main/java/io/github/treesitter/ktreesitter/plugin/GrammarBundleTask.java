@@ -0,0 +1,330 @@
+package io.github.treesitter.ktreesitter.plugin;
+
+import static io.github.treesitter.ktreesitter.plugin.Templates.*;
+
+import java.io.File;
+import java.nio.file.Path;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Map;
+import java.util.TreeMap;
+
+import org.gradle.api.DefaultTask;
+import org.gradle.api.GradleException;
+import org.gradle.api.NonNullApi;
+import org.gradle.api.file.DirectoryProperty;
+import org.gradle.api.file.RegularFileProperty;
+import org.gradle.api.tasks.*;
+
+/**
+ * The task that generates the source files for a bundle of grammars,
+ * which are compiled into a single JNI library with the KTreeSitter sources.
+ */
+@NonNullApi
+@CacheableTask
+public abstract class GrammarBundleTask extends DefaultTask {
+    private String ktreesitterPath;
+
+    private String libraryName;
+
+    private String packageName;
+
+    private String className;
+
+    private List<Grammar> grammars = List.of();
+
+    /** Get the path of the {@code ktreesitter} module. */
+    @Input
+    public final String getKtreesitterPath() {
+        return ktreesitterPath;
+    }
+
+    /** Set the path of the {@code ktreesitter} module. */
+    public final void setKtreesitterPath(String ktreesitterPath) {
+        this.ktreesitterPath = ktreesitterPath;
+    }
+
+    /** Get the name of the JNI library. */
+    @Input
+    public final String getLibraryName() {
+        return libraryName;
+    }
+
+    /** Set the name of the JNI library. */
+    public final void setLibraryName(String libraryName) {
+        this.libraryName = libraryName;
+    }
+
+    /** Get the name of the package of the bundle class. */
+    @Input
+    public final String getPackageName() {
+        return packageName;
+    }
+
+    /** Set the name of the package of the bundle class. */
+    public final void setPackageName(String packageName) throws GradleException {
+        checkPackageName(packageName);
+        this.packageName = packageName;
+    }
+
+    /** Get the name of the bundle class. */
+    @Input
+    public final String getClassName() {
+        return className;
+    }
+
+    /** Set the name of the bundle class. */
+    public final void setClassName(String className) throws GradleException {
+        checkClassName(className);
+        this.className = className;
+    }
+
+    /** Get the bundled grammars. */
+    @Nested
+    public final List<Grammar> getGrammars() {
+        return grammars;
+    }
+
+    /** Set the bundled grammars. */
+    public final void setGrammars(List<Grammar> grammars) {
+        this.grammars = List.copyOf(grammars);
+    }
+
+    /** Get the directory of the generated files. */
+    @OutputDirectory
+    public abstract DirectoryProperty getGeneratedSrc();
+
+    /** Get the generated {@code CMakeLists.txt} file. */
+    @OutputFile
+    public abstract RegularFileProperty getCmakeListsFile();
+
+    /** Generate the output files. */
+    @TaskAction
+    public final void generate() throws GradleException {
+        if (grammars.isEmpty())
+            throw new GradleException("The bundle does not contain any grammars");
+
+        var srcDir = getGeneratedSrc().get().getAsFile();
+        mkdirs(srcDir);
+
+        var srcPath = srcDir.toPath();
+        for (var grammar : grammars) {
+            generateGrammar(srcPath, grammar);
+        }
+        generateBundle(srcPath);
+        generateJniBinding(srcPath);
+        generateCmakeLists(srcPath);
+        generateLibraryResource(srcPath);
+    }
+
+    private void generateGrammar(Path srcDir, Grammar grammar) throws GradleException {
+        var methods = grammar.getLanguageMethods();
+        var common = readResource("common.kt.in")
+            .replace("@PACKAGE@", grammar.getPackageName())
+            .replace("@CLASS@", grammar.getClassName())
+            .replace("@METHODS@", commonMethods(methods));
+        writeFile(
+            classFile(srcDir, "commonMain", grammar.getPackageName(), grammar.getClassName()),
+            common
+        );
+
+        var jvm = readResource("bundle-jvm.kt.in")
+            .replace("@PACKAGE@", grammar.getPackageName())
+            .replace("@CLASS@", grammar.getClassName())
+            .replace("@BUNDLE@", packageName + "." + className)
+            .replace("@METHODS@", jvmMethods(methods));
+        writeFile(
+            classFile(srcDir, "jvmMain", grammar.getPackageName(), grammar.getClassName()),
+            jvm
+        );
+
+        var android = readResource("android.kt.in")
+            .replace("@PACKAGE@", grammar.getPackageName())
+            .replace("@CLASS@", grammar.getClassName())
+            .replace("@LIBRARY@", libraryName)
+            .replace("@METHODS@", androidMethods(methods));
+        writeFile(
+            classFile(srcDir, "androidMain", grammar.getPackageName(), grammar.getClassName()),
+            android
+        );
+    }
+
+    private void generateBundle(Path srcDir) throws GradleException {
+        var names = languageFunctions().keySet().stream().map("        \"%s\""::formatted);
+        var namesList = "listOf(\n%s\n    )".formatted(String.join(",\n", names.toList()));
+
+        var common = readResource("common.kt.in")
+            .replace("@PACKAGE@", packageName)
+            .replace("@CLASS@", className)
+            .replace("@METHODS@", """
+                        /** The names of the bundled languages. */
+                        val names: List<String>
+
+                        /** Get the language with the given name, or `null` if it is not bundled. */
+                        fun language(name: String): Any?
+                    """.stripTrailing());
+        writeFile(classFile(srcDir, "commonMain", packageName, className), common);
+
+        var methods = """
+                    actual val names = %s
+
+                    actual fun language(name: String): Any? {
+                        val index = names.indexOf(name)
+                        return if (index < 0) null else nativeLanguage(index)
+                    }
+
+                    internal fun load() {}
+
+                    @JvmStatic%s
+                    private external fun nativeLanguage(index: Int): Long
+                """;
+        var jvm = readResource("jvm.kt.in")
+            .replace("@PACKAGE@", packageName)
+            .replace("@CLASS@", className)
+            .replace("@LIBRARY@", libraryName)
+            .replace("@METHODS@", methods.formatted(namesList, ""));
+        writeFile(classFile(srcDir, "jvmMain", packageName, className), jvm);
+
+        var android = readResource("android.kt.in")
+            .replace("@PACKAGE@", packageName)
+            .replace("@CLASS@", className)
+            .replace("@LIBRARY@", libraryName)
+            .replace("@METHODS@", methods.formatted(namesList, "\n    @CriticalNative"));
+        writeFile(classFile(srcDir, "androidMain", packageName, className), android);
+    }
+
+    private void generateJniBinding(Path srcDir) throws GradleException {
+        var jniBinding = srcDir.resolve("jni").resolve("bundle.c");
+        mkdirs(jniBinding.getParent().toFile());
+
+        var includes = grammars.stream().map(grammar ->
+            "#include <tree-sitter-%s.h>".formatted(grammar.getName())
+        );
+        var table = languageFunctions().values().stream().map("    %s"::formatted);
+        var functions = grammars.stream().map(grammar -> jniFunctions(
+            grammar.getPackageName(), grammar.getClassName(), grammar.getLanguageMethods()
+        ));
+        var lookup = "Java_%s_%s_nativeLanguage".formatted(
+            jniTransform(packageName).replace('.', '_'), jniTransform(className)
+        );
+        var template = readResource("bundle.c.in")
+            .replace("@INCLUDES@", String.join("\n", includes.toList()))
+            .replace("@TABLE@", String.join(",\n", table.toList()))
+            .replace("@FUNCTIONS@", String.join("\n\n", functions.toList()))
+            .replace("@LOOKUP@", lookup);
+        writeFile(jniBinding.toFile(), template);
+    }
+
+    private void generateCmakeLists(Path srcDir) throws GradleException {
+        var jniBinding = srcDir.resolve("jni").resolve("bundle.c");
+        var includeDirs = new ArrayList<String>();
+        var sources = new ArrayList<String>();
+        sources.add(relative(jniBinding).toString());
+        for (var grammar : grammars) {
+            var grammarDir = grammar.getGrammarDir().toPath();
+            var cBindingDir = grammarDir.resolve("bindings/c");
+            includeDirs.add(relative(cBindingDir).toString());
+            includeDirs.add(relative(cBindingDir.resolve("tree-sitter")).toString());
+            sources.add(relative(grammarDir.resolve("src/parser.c")).toString());
+            var scannerFile = grammarDir.resolve("src/scanner.c");
+            if (scannerFile.toFile().exists()) sources.add(relative(scannerFile).toString());
+        }
+        var ktreesitterDir = relative(new File(ktreesitterPath).toPath());
+        var template = readResource("bundle-CMakeLists.txt.in")
+            .replace("@LIBRARY@", libraryName)
+            .replace("@KTREESITTER@", ktreesitterDir.toString())
+            .replace("@INCLUDE@", String.join("\n                    ", includeDirs))
+            .replace("@SOURCES@", String.join("\n            ", sources));
+        writeFile(getCmakeListsFile().get().getAsFile(), template);
+    }
+
+    /** Write the resource that makes KTreeSitter load the bundle instead of its own library. */
+    private void generateLibraryResource(Path srcDir) throws GradleException {
+        var resource = srcDir.resolve("jvmMain/resources/META-INF/ktreesitter/library");
+        mkdirs(resource.getParent().toFile());
+        writeFile(resource.toFile(), libraryName + "\n");
+    }
+
+    /** Get the C functions of the bundled languages, keyed by their names. */
+    private Map<String, String> languageFunctions() throws GradleException {
+        var functions = new TreeMap<String, String>();
+        for (var grammar : grammars) {
+            for (var function : grammar.getLanguageMethods().values()) {
+                var name = function.startsWith("tree_sitter_")
+                    ? function.substring("tree_sitter_".length())
+                    : function;
+                if (functions.put(name, function) != null)
+                    throw new GradleException("Duplicate language name: " + name);
+            }
+        }
+        return functions;
+    }
+
+    private Path relative(Path file) {
+        var cmakeDir = getCmakeListsFile().get().getAsFile().toPath().getParent();
+        return cmakeDir.toAbsolutePath().relativize(file.toAbsolutePath());
+    }
+
+    /** A grammar of the bundle. */
+    @NonNullApi
+    public static final class Grammar {
+        private final String name;
+
+        private final File grammarDir;
+
+        private final String packageName;
+
+        private final String className;
+
+        private final Map<String, String> languageMethods;
+
+        /** Create a new bundled grammar. */
+        public Grammar(
+            String name,
+            File grammarDir,
+            String packageName,
+            String className,
+            Map<String, String> languageMethods
+        ) throws GradleException {
+            checkPackageName(packageName);
+            checkClassName(className);
+            checkLanguageMethods(languageMethods);
+            this.name = name;
+            this.grammarDir = grammarDir;
+            this.packageName = packageName;
+            this.className = className;
+            this.languageMethods = new TreeMap<>(languageMethods);
+        }
+
+        /** Get the name of the grammar. */
+        @Input
+        public String getName() {
+            return name;
+        }
+
+        /** Get the base directory of the grammar. */
+        @InputDirectory
+        @PathSensitive(PathSensitivity.ABSOLUTE)
+        public File getGrammarDir() {
+            return grammarDir;
+        }
+
+        /** Get the name of the package. */
+        @Input
+        public String getPackageName() {
+            return packageName;
+        }
+
+        /** Get the name of the class. */
+        @Input
+        public String getClassName() {
+            return className;
+        }
+
+        /** Get the language methods. */
+        @Input
+        public Map<String, String> getLanguageMethods() {
+            return languageMethods;
+        }
+    }
+}
@@ -54,4 +54,12 @@ public interface GrammarExtension {
      * <p>Default: {@code language -> tree_sitter_${grammarName}}</p>
      */
     MapProperty<String, String> getLanguageMethods();
+    /**
+     * Whether to generate node type constants and wrappers from {@code src/node-types.json}.
+     *
+     * <p>The generated code uses the {@code ktreesitter} library.</p>
+     *
+     * <p>Default: {@code false}</p>
+     */
+    Property<Boolean> getNodeTypes();
 }
@@ -1,15 +1,10 @@
 package io.github.treesitter.ktreesitter.plugin;
 
+import static io.github.treesitter.ktreesitter.plugin.Templates.*;
+
 import java.io.File;
-import java.io.FileWriter;
-import java.io.IOException;
-import java.nio.charset.StandardCharsets;
 import java.nio.file.Path;
-import java.util.Arrays;
-import java.util.List;
 import java.util.Map;
-import java.util.Objects;
-import java.util.regex.Pattern;
 
 import org.gradle.api.DefaultTask;
 import org.gradle.api.GradleException;
@@ -36,8 +31,7 @@ public abstract class GrammarFilesTask extends DefaultTask {
 
     private Map<String, String> languageMethods;
 
-    private static final Pattern packageNameRegex =
-        Pattern.compile("^[A-Za-z_]\\w*(?:[.][A-Za-z_]\\w*)*$");
+    private boolean nodeTypes;
 
     /** Get the base directory of the grammar. */
     @InputDirectory
@@ -92,8 +86,7 @@ public abstract class GrammarFilesTask extends DefaultTask {
 
     /** Set the name of the package. */
     public final void setPackageName(String packageName) throws GradleException {
-        if (!packageNameRegex.matcher(packageName).matches())
-            throw new GradleException("Package name is not valid: " + packageName);
+        checkPackageName(packageName);
         this.packageName = packageName;
     }
 
@@ -105,8 +98,7 @@ public abstract class GrammarFilesTask extends DefaultTask {
 
     /** Set the name of the class. */
     public final void setClassName(String className) throws GradleException {
-        if (invalidIdentifier(className))
-            throw new GradleException("Class name is not valid: " + className);
+        checkClassName(className);
         this.className = className;
     }
 
@@ -120,15 +112,21 @@ public abstract class GrammarFilesTask extends DefaultTask {
     public final void setLanguageMethods(
         Map<String, String> languageMethods
     ) throws GradleException {
-        for (var method : languageMethods.entrySet()) {
-            if (invalidIdentifier(method.getKey()))
-                throw new GradleException("Method name is not valid: " + method.getKey());
-            if (invalidIdentifier(method.getValue()))
-                throw new GradleException("Method name is not valid: " + method.getValue());
-        }
+        checkLanguageMethods(languageMethods);
         this.languageMethods = languageMethods;
     }
 
+    /** Get whether to generate node type constants and wrappers. */
+    @Input
+    public final boolean getNodeTypes() {
+        return nodeTypes;
+    }
+
+    /** Set whether to generate node type constants and wrappers. */
+    public final void setNodeTypes(boolean nodeTypes) {
+        this.nodeTypes = nodeTypes;
+    }
+
     /** Get the directory of the generated files. */
     @OutputDirectory
     public abstract DirectoryProperty getGeneratedSrc();
@@ -155,32 +153,22 @@ public abstract class GrammarFilesTask extends DefaultTask {
         generateJniBinding(srcPath);
         generateCmakeLists(srcPath);
         generateInterop();
+        if (nodeTypes) {
+            new NodeTypesGenerator(grammarDir, packageName).generate(srcPath);
+        }
     }
 
     private void generateCommon(Path srcDir) throws GradleException {
-        var classFile = srcDir.resolve(
-            "commonMain/kotlin/%s/%s.kt".formatted(
-                packageName.replace('.', '/'), className
-            )
-        );
-        mkdirs(classFile.getParent().toFile());
-
-        var methods = languageMethods.keySet().stream().map("    fun %s(): Any"::formatted);
+        var classFile = classFile(srcDir, "commonMain", packageName, className);
         var template = readResource("common.kt.in")
             .replace("@PACKAGE@", packageName)
             .replace("@CLASS@", className)
-            .replace("@METHODS@", String.join("\n\n", methods.toList()));
-        writeFile(classFile.toFile(), template);
+            .replace("@METHODS@", commonMethods(languageMethods));
+        writeFile(classFile, template);
     }
 
     private void generateNative(Path srcDir) throws GradleException {
-        var classFile = srcDir.resolve(
-            "nativeMain/kotlin/%s/%s.kt".formatted(
-                packageName.replace('.', '/'), className
-            )
-        );
-        mkdirs(classFile.getParent().toFile());
-
+        var classFile = classFile(srcDir, "nativeMain", packageName, className);
         var imports = languageMethods.values().stream().map(method ->
             "import %s.internal.%s".formatted(packageName, method)
         );
@@ -192,77 +180,36 @@ public abstract class GrammarFilesTask extends DefaultTask {
             .replace("@CLASS@", className)
             .replace("@IMPORTS@", String.join("\n\n", imports.toList()))
             .replace("@METHODS@", String.join("\n\n", methods.toList()));
-        writeFile(classFile.toFile(), template);
+        writeFile(classFile, template);
     }
 
     private void generateJvm(Path srcDir) throws GradleException {
-        var classFile = srcDir.resolve(
-            "jvmMain/kotlin/%s/%s.kt".formatted(
-                packageName.replace('.', '/'), className
-            )
-        );
-        mkdirs(classFile.getParent().toFile());
-
-        var methods = languageMethods.entrySet().stream().map(method ->
-            """
-                    actual fun %s(): Any = %s()
-
-                    @JvmStatic
-                    private external fun %s(): Long
-                """.stripIndent().formatted(
-                method.getKey(), method.getValue(), method.getValue()
-            )
-        );
+        var classFile = classFile(srcDir, "jvmMain", packageName, className);
         var template = readResource("jvm.kt.in")
             .replace("@PACKAGE@", packageName)
             .replace("@CLASS@", className)
             .replace("@LIBRARY@", libraryName)
-            .replace("@METHODS@", String.join("\n\n", methods.toList()));
-        writeFile(classFile.toFile(), template);
+            .replace("@METHODS@", jvmMethods(languageMethods));
+        writeFile(classFile, template);
     }
 
     private void generateAndroid(Path srcDir) throws GradleException {
-        var classFile = srcDir.resolve(
-            "androidMain/kotlin/%s/%s.kt".formatted(
-                packageName.replace('.', '/'), className
-            )
-        );
-        mkdirs(classFile.getParent().toFile());
-
-        var methods = languageMethods.entrySet().stream().map(method ->
-                """
-                        actual fun %s(): Any = %s()
-
-                        @JvmStatic
-                        @CriticalNative
-                        private external fun %s(): Long
-                    """.stripIndent().formatted(
-                        method.getKey(), method.getValue(), method.getValue()
-                )
-        );
+        var classFile = classFile(srcDir, "androidMain", packageName, className);
         var template = readResource("android.kt.in")
             .replace("@PACKAGE@", packageName)
             .replace("@CLASS@", className)
             .replace("@LIBRARY@", libraryName)
-            .replace("@METHODS@", String.join("\n\n", methods.toList()));
-        writeFile(classFile.toFile(), template);
+            .replace("@METHODS@", androidMethods(languageMethods));
+        writeFile(classFile, template);
     }
 
     private void generateJniBinding(Path srcDir) throws GradleException {
         var jniBinding = srcDir.resolve("jni").resolve("binding.c");
         mkdirs(jniBinding.getParent().toFile());
 
-        var jniClassName = jniTransform(className);
-        var jniPackageName = jniTransform(packageName).replace('.', '_');
-        var jniPrefix = "Java_%s_%s_".formatted(jniPackageName, jniClassName);
-        var methods = languageMethods.values().stream().map(name ->
-            "NATIVE_FUNCTION(%s%s) {\n    return (jlong)%s();\n}".formatted(
-                jniPrefix, jniTransform(name), name
-            )
-        );
         var template = readResource("jni.c.in")
             .replace("@GRAMMAR@", grammarName)
-            .replace("@FUNCTIONS@", String.join("", methods.toList()));
+            .replace("@FUNCTIONS@", jniFunctions(packageName, className, languageMethods));
         writeFile(jniBinding.toFile(), template);
     }
 
@@ -304,49 +251,4 @@ public abstract class GrammarFilesTask extends DefaultTask {
             relative(grammarSrcDir.resolve("parser.c")),
             relative(scannerFile));
     }
-
-    private String readResource(String file) throws GradleException {
-        try (var stream = getClass().getResourceAsStream("/" + file)) {
-            var bytes = Objects.requireNonNull(stream).readAllBytes();
-            return new String(bytes, StandardCharsets.UTF_8);
-        } catch (IOException | NullPointerException ex) {
-            throw new GradleException("Failed to read resource file: " + file, ex);
-        }
-    }
-
-    private static void writeFile(File file, String content) throws GradleException {
-        try (var writer = new FileWriter(file)) {
-            writer.write(content);
-        } catch (IOException e) {
-            throw new GradleException("Failed to write to file: " + file, e);
-        }
-    }
-
-    private static String jniTransform(String input) {
-        var builder = new StringBuilder();
-        for (char c : input.toCharArray()) {
-            switch (c) {
-                case '_':
-                    builder.append("_1");
-                    break;
-                case ';':
-                    builder.append("_2");
-                    break;
-                case '[':
-                    builder.append("_3");
-                    break;
-                default:
-                    builder.append(c <= 0x7F ? c : "_0%04x".formatted((int)c));
-            }
-        }
-        return builder.toString();
-    }
-
-    private static boolean invalidIdentifier(String input) {
-        if (!Character.isJavaIdentifierStart(input.charAt(0))) return true;
-        return !input.substring(1).chars().allMatch(Character::isJavaIdentifierPart);
-    }
-
-    @SuppressWarnings("ResultOfMethodCallIgnored")
-    private static void mkdirs(File file) { file.mkdirs(); }
 }
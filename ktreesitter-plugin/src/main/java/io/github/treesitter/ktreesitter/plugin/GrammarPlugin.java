@@ -26,6 +26,7 @@ public abstract class GrammarPlugin implements Plugin<Project> {
         extension.getLanguageMethods().convention(
             extension.getGrammarName().map(name -> Map.of("language", "tree_sitter_" + name))
         );
+        extension.getNodeTypes().convention(false);
 
         project.getTasks().register("generateGrammarFiles", GrammarFilesTask.class, it -> {
             it.setGrammarDir(extension.getBaseDir().get());
@@ -35,6 +36,7 @@ public abstract class GrammarPlugin implements Plugin<Project> {
             it.setPackageName(extension.getPackageName().get());
             it.setClassName(extension.getClassName().get());
             it.setLanguageMethods(extension.getLanguageMethods().get());
+            it.setNodeTypes(extension.getNodeTypes().get());
 
             var generatedDir = project.getLayout().getBuildDirectory().get().dir("generated");
             it.getGeneratedSrc().set(generatedDir.dir("src"));
@@ -46,5 +48,36 @@ public abstract class GrammarPlugin implements Plugin<Project> {
             it.getOutputs().dir(it.getGeneratedSrc());
             it.getOutputs().files(it.getCmakeListsFile(), it.getInteropFile());
         });
+
+        var bundle = project.getExtensions().create("grammarBundle", GrammarBundleExtension.class);
+        bundle.getLibraryName().convention("ktreesitter-bundle");
+        bundle.getClassName().convention("TreeSitterBundle");
+        bundle.getGrammars().configureEach(grammar -> grammar.getLanguageMethods().convention(
+            Map.of("language", "tree_sitter_" + grammar.getName())
+        ));
+
+        project.getTasks().register("generateGrammarBundle", GrammarBundleTask.class, it -> {
+            it.setKtreesitterPath(bundle.getKtreesitterDir().get().getAbsolutePath());
+            it.setLibraryName(bundle.getLibraryName().get());
+            it.setPackageName(bundle.getPackageName().get());
+            it.setClassName(bundle.getClassName().get());
+            it.setGrammars(bundle.getGrammars().stream().map(grammar ->
+                new GrammarBundleTask.Grammar(
+                    grammar.getName(),
+                    grammar.getBaseDir().get(),
+                    grammar.getPackageName().get(),
+                    grammar.getClassName().get(),
+                    grammar.getLanguageMethods().get()
+                )
+            ).toList());
+
+            var generatedDir = project.getLayout().getBuildDirectory().get()
+                .dir("generated").dir("bundle");
+            it.getGeneratedSrc().set(generatedDir.dir("src"));
+            it.getCmakeListsFile().set(generatedDir.file("CMakeLists.txt"));
+
+            it.getOutputs().dir(it.getGeneratedSrc());
+            it.getOutputs().file(it.getCmakeListsFile());
+        });
     }
 }
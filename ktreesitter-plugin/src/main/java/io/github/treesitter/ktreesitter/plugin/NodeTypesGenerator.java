@@ -0,0 +1,368 @@
+package io.github.treesitter.ktreesitter.plugin;
+
+import static io.github.treesitter.ktreesitter.plugin.Templates.*;
+
+import groovy.json.JsonSlurper;
+import java.io.File;
+import java.io.IOException;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.HashSet;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Locale;
+import java.util.Map;
+import java.util.Set;
+import java.util.TreeMap;
+import java.util.TreeSet;
+import java.util.regex.Pattern;
+
+import org.gradle.api.GradleException;
+import org.gradle.api.NonNullApi;
+
+/**
+ * The generator of the node type constants and wrappers of a grammar.
+ *
+ * <p>The node types are read from {@code src/node-types.json}, and their
+ * numerical IDs are read from the tables of the generated {@code src/parser.c},
+ * since the former does not contain them.</p>
+ */
+@NonNullApi
+final class NodeTypesGenerator {
+    private static final Pattern enumRegex =
+        Pattern.compile("enum(?: \\w+)? \\{\\n(.*?)\\n};", Pattern.DOTALL);
+
+    private static final Pattern enumEntryRegex =
+        Pattern.compile("^\\s*(\\w+) = (\\d+),$", Pattern.MULTILINE);
+
+    private static final Pattern nameEntryRegex =
+        Pattern.compile("^\\s*\\[(\\w+)] = \"((?:[^\"\\\\]|\\\\.)*)\",$", Pattern.MULTILINE);
+
+    private static final Pattern mapEntryRegex =
+        Pattern.compile("^\\s*\\[(\\w+)] = (\\w+),$", Pattern.MULTILINE);
+
+    private static final Pattern metadataEntryRegex =
+        Pattern.compile("\\[(\\w+)] = \\{([^}]*)}");
+
+    private static final Set<String> keywords = Set.of(
+        "as", "break", "class", "continue", "do", "else", "false", "for", "fun", "if",
+        "in", "interface", "is", "null", "object", "package", "return", "super", "this",
+        "throw", "true", "try", "typealias", "typeof", "val", "var", "when", "while"
+    );
+
+    private static final Set<String> reservedClasses =
+        Set.of("Fields", "JvmInline", "Node", "Supertypes", "Symbols");
+
+    private final String packageName;
+
+    private final String parserSource;
+
+    private final List<Map<String, Object>> nodeTypes;
+
+    /** The constant names of the symbols, keyed by their type name and whether they are named. */
+    private final Map<String, String> symbolConstants = new LinkedHashMap<>();
+
+    /** Create a new generator for the grammar in the given directory. */
+    @SuppressWarnings("unchecked")
+    NodeTypesGenerator(File grammarDir, String packageName) throws GradleException {
+        var srcDir = grammarDir.toPath().resolve("src");
+        this.packageName = packageName + ".nodes";
+        this.parserSource = readFile(srcDir.resolve("parser.c"));
+        var json = new JsonSlurper().parseText(readFile(srcDir.resolve("node-types.json")));
+        this.nodeTypes = (List<Map<String, Object>>) json;
+    }
+
+    /** Generate the files in the given source directory. */
+    void generate(Path srcDir) throws GradleException {
+        var outputDir = srcDir.resolve("commonMain/kotlin/" + packageName.replace('.', '/'));
+        mkdirs(outputDir.toFile());
+        writeFile(outputDir.resolve("Symbols.kt").toFile(), generateSymbols());
+        writeFile(outputDir.resolve("Fields.kt").toFile(), generateFields());
+        writeFile(outputDir.resolve("Supertypes.kt").toFile(), generateSupertypes());
+        writeFile(outputDir.resolve("Nodes.kt").toFile(), generateNodes());
+    }
+
+    private String generateSymbols() throws GradleException {
+        var ids = enumValues();
+        var names = tableEntries("ts_symbol_names", nameEntryRegex);
+        var symbolMap = tableEntries("ts_symbol_map", mapEntryRegex);
+        var metadata = tableEntries("ts_symbol_metadata", metadataEntryRegex);
+
+        // Order the symbols by their IDs, like the loop of ts_language_symbol_for_name.
+        var symbols = new TreeMap<Integer, String>();
+        for (var name : names.keySet()) symbols.put(id(ids, name), name);
+
+        var constants = new StringBuilder();
+        var used = new HashSet<String>();
+        for (var nodeType : nodeTypes) {
+            if (nodeType.containsKey("subtypes")) continue;
+            var type = (String) nodeType.get("type");
+            var named = (Boolean) nodeType.get("named");
+            String identifier = null;
+            for (var symbol : symbols.values()) {
+                var flags = metadata.getOrDefault(symbol, "");
+                if (!flags.contains(".visible = true")) continue;
+                if (flags.contains(".named = true") != named) continue;
+                if (!unescape(names.get(symbol)).equals(type)) continue;
+                identifier = symbolMap.getOrDefault(symbol, symbol);
+                break;
+            }
+            if (identifier == null)
+                throw new GradleException("Unknown node type: " + type);
+
+            var id = id(ids, identifier);
+            var constant = named ? constantName(type) : "ANON_" + constantName(
+                identifier.replaceFirst("^(anon_sym|alias_sym|aux_sym|sym)_", "")
+            );
+            if (!used.add(constant)) {
+                constant += "_" + id;
+                used.add(constant);
+            }
+            symbolConstants.put(key(type, named), constant);
+            constants.append(documentation("The `%s` node type.", type, "    "))
+                .append("    const val %s: UShort = %dU\n\n".formatted(constant, id));
+        }
+        return header() + """
+            /** The symbols of the node types of the grammar. */
+            object Symbols {
+            %s}
+            """.formatted(constants.toString().stripTrailing() + "\n");
+    }
+
+    private String generateFields() throws GradleException {
+        var ids = enumValues();
+        var names = tableEntries("ts_field_names", nameEntryRegex);
+        var constants = new StringBuilder();
+        for (var field : names.entrySet()) {
+            var name = unescape(field.getValue());
+            constants.append(documentation("The `%s` field.", name, "    "))
+                .append("    const val %s: UShort = %dU\n\n".formatted(
+                    constantName(name), id(ids, field.getKey())
+                ));
+        }
+        return header() + """
+            /** The IDs of the fields of the grammar. */
+            object Fields {
+            %s}
+            """.formatted(constants.toString().stripTrailing() + "\n");
+    }
+
+    @SuppressWarnings("unchecked")
+    private String generateSupertypes() throws GradleException {
+        var supertypes = new LinkedHashMap<String, List<Map<String, Object>>>();
+        for (var nodeType : nodeTypes) {
+            if (nodeType.containsKey("subtypes")) {
+                var subtypes = (List<Map<String, Object>>) nodeType.get("subtypes");
+                supertypes.put((String) nodeType.get("type"), subtypes);
+            }
+        }
+
+        var functions = new ArrayList<String>();
+        for (var supertype : supertypes.keySet()) {
+            var constants = new TreeSet<String>();
+            collectSubtypes(supertype, supertypes, constants, new HashSet<>());
+            var doc = documentation("Check if the symbol is a subtype of `%s`.", supertype, "    ");
+            if (constants.isEmpty()) {
+                functions.add(doc + "    fun is%s(symbol: UShort) = false\n".formatted(
+                    className(supertype)
+                ));
+                continue;
+            }
+            functions.add(doc + """
+                    fun is%s(symbol: UShort) = when (symbol) {
+                        %s -> true
+                        else -> false
+                    }
+                """.formatted(className(supertype), String.join(",\n        ", constants)));
+        }
+        return header() + """
+            /** The subtypes of the supertypes of the grammar. */
+            object Supertypes {
+            %s}
+            """.formatted(String.join("\n", functions));
+    }
+
+    private void collectSubtypes(
+        String supertype,
+        Map<String, List<Map<String, Object>>> supertypes,
+        Set<String> constants,
+        Set<String> visited
+    ) {
+        if (!visited.add(supertype)) return;
+        for (var subtype : supertypes.get(supertype)) {
+            var type = (String) subtype.get("type");
+            var named = (Boolean) subtype.get("named");
+            if (named && supertypes.containsKey(type)) {
+                collectSubtypes(type, supertypes, constants, visited);
+            } else {
+                var constant = symbolConstants.get(key(type, named));
+                if (constant != null) constants.add("Symbols." + constant);
+            }
+        }
+    }
+
+    @SuppressWarnings("unchecked")
+    private String generateNodes() {
+        var classes = new ArrayList<String>();
+        var used = new HashSet<>(reservedClasses);
+        for (var nodeType : nodeTypes) {
+            var fields = (Map<String, Map<String, Object>>) nodeType.get("fields");
+            if (fields == null || fields.isEmpty()) continue;
+            var type = (String) nodeType.get("type");
+            var constant = symbolConstants.get(key(type, true));
+            if (constant == null) continue;
+
+            var className = className(type);
+            if (!used.add(className)) {
+                className += "Node";
+                used.add(className);
+            }
+            var properties = new StringBuilder();
+            for (var field : new TreeMap<>(fields).entrySet()) {
+                var name = field.getKey();
+                var multiple = Boolean.TRUE.equals(field.getValue().get("multiple"));
+                properties.append(documentation("The `%s` field.", name, "    "))
+                    .append("    val %s: %s\n        get() = node.%s(Fields.%s)\n\n".formatted(
+                        propertyName(name),
+                        multiple ? "kotlin.collections.List<Node>" : "Node?",
+                        multiple ? "childrenByFieldId" : "childByFieldId",
+                        constantName(name)
+                    ));
+            }
+            classes.add(documentation("A `%s` node.", type, "") + """
+                @JvmInline
+                value class %1$s(val node: Node) {
+                %2$s    companion object {
+                        /** Wrap the given node if it has the right type. */
+                        fun of(node: Node): %1$s? =
+                            if (node.symbol == Symbols.%3$s) %1$s(node) else null
+                    }
+                }
+                """.formatted(className, properties, constant));
+        }
+        return header() + """
+            import io.github.treesitter.ktreesitter.Node
+            import kotlin.jvm.JvmInline
+
+            """ + String.join("\n", classes);
+    }
+
+    private String header() {
+        return """
+            // Automatically generated file. DO NOT MODIFY
+
+            package %s
+
+            """.formatted(packageName);
+    }
+
+    /** Get the values of the enums of the parser. */
+    private Map<String, Integer> enumValues() {
+        var values = new HashMap<String, Integer>();
+        values.put("ts_builtin_sym_end", 0);
+        var enums = enumRegex.matcher(parserSource);
+        while (enums.find()) {
+            var entries = enumEntryRegex.matcher(enums.group(1));
+            while (entries.find()) {
+                values.put(entries.group(1), Integer.parseInt(entries.group(2)));
+            }
+        }
+        return values;
+    }
+
+    /** Get the entries of the table with the given name in the parser. */
+    private Map<String, String> tableEntries(String table, Pattern entryRegex)
+        throws GradleException {
+        var start = parserSource.indexOf(table + "[] = {");
+        if (start == -1)
+            throw new GradleException("Table not found in parser.c: " + table);
+        var end = parserSource.indexOf("\n};", start);
+        var entries = entryRegex.matcher(parserSource.substring(start, end));
+        var result = new LinkedHashMap<String, String>();
+        while (entries.find()) result.put(entries.group(1), entries.group(2));
+        return result;
+    }
+
+    private static int id(Map<String, Integer> ids, String identifier) throws GradleException {
+        var id = ids.get(identifier);
+        if (id == null)
+            throw new GradleException("Unknown identifier in parser.c: " + identifier);
+        return id;
+    }
+
+    private static String key(String type, boolean named) {
+        return (named ? "+" : "-") + type;
+    }
+
+    private static String documentation(String format, String name, String indent) {
+        // Names that would break out of the comment are left undocumented.
+        if (name.contains("*/") || name.contains("`")) return "";
+        var escaped = name.replace("\\", "\\\\")
+            .replace("\n", "\\n")
+            .replace("\r", "\\r")
+            .replace("\t", "\\t");
+        return indent + "/** " + format.formatted(escaped) + " */\n";
+    }
+
+    /** Convert a name to an upper snake case constant name. */
+    private static String constantName(String name) {
+        var constant = name.replaceAll("\\W+", "_").replaceAll("^_+|_+$", "");
+        if (constant.isEmpty()) constant = "UNNAMED";
+        if (Character.isDigit(constant.charAt(0))) constant = "_" + constant;
+        return constant.toUpperCase(Locale.ROOT);
+    }
+
+    /** Convert a name to a pascal case class name. */
+    private static String className(String name) {
+        var builder = new StringBuilder();
+        for (var part : name.split("\\W|_")) {
+            if (part.isEmpty()) continue;
+            builder.append(Character.toUpperCase(part.charAt(0))).append(part.substring(1));
+        }
+        if (builder.isEmpty() || Character.isDigit(builder.charAt(0))) builder.insert(0, '_');
+        return builder.toString();
+    }
+
+    /** Convert a name to a camel case property name. */
+    private static String propertyName(String name) {
+        var className = className(name);
+        var property = Character.toLowerCase(className.charAt(0)) + className.substring(1);
+        if (property.equals("node")) return "nodeField";
+        return keywords.contains(property) ? "`" + property + "`" : property;
+    }
+
+    /** Unescape a C string literal. */
+    private static String unescape(String literal) {
+        var builder = new StringBuilder(literal.length());
+        for (int i = 0; i < literal.length(); ++i) {
+            char c = literal.charAt(i);
+            if (c != '\\' || i + 1 == literal.length()) {
+                builder.append(c);
+                continue;
+            }
+            c = literal.charAt(++i);
+            switch (c) {
+                case 'n' -> builder.append('\n');
+                case 'r' -> builder.append('\r');
+                case 't' -> builder.append('\t');
+                case 'f' -> builder.append('\f');
+                case 'v' -> builder.append('\u000B');
+                case 'b' -> builder.append('\b');
+                case '0' -> builder.append('\0');
+                default -> builder.append(c);
+            }
+        }
+        return builder.toString();
+    }
+
+    private static String readFile(Path file) throws GradleException {
+        try {
+            return Files.readString(file, StandardCharsets.UTF_8);
+        } catch (IOException ex) {
+            throw new GradleException("Failed to read file: " + file, ex);
+        }
+    }
+}
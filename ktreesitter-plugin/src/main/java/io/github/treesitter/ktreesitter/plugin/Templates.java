@@ -0,0 +1,150 @@
+package io.github.treesitter.ktreesitter.plugin;
+
+import java.io.File;
+import java.io.FileWriter;
+import java.io.IOException;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Path;
+import java.util.Map;
+import java.util.Objects;
+import java.util.regex.Pattern;
+
+import org.gradle.api.GradleException;
+import org.gradle.api.NonNullApi;
+
+/** The helpers that fill in the templates of the generated files. */
+@NonNullApi
+final class Templates {
+    private static final Pattern packageNameRegex =
+        Pattern.compile("^[A-Za-z_]\\w*(?:[.][A-Za-z_]\\w*)*$");
+
+    private Templates() {}
+
+    /** Get the Kotlin file of a class in the given source set. */
+    static File classFile(Path srcDir, String sourceSet, String packageName, String className) {
+        var classFile = srcDir.resolve(
+            "%s/kotlin/%s/%s.kt".formatted(sourceSet, packageName.replace('.', '/'), className)
+        );
+        mkdirs(classFile.getParent().toFile());
+        return classFile.toFile();
+    }
+
+    /** Get the {@code expect} declarations of the language methods. */
+    static String commonMethods(Map<String, String> languageMethods) {
+        var methods = languageMethods.keySet().stream().map("    fun %s(): Any"::formatted);
+        return String.join("\n\n", methods.toList());
+    }
+
+    /** Get the JVM {@code actual} declarations of the language methods. */
+    static String jvmMethods(Map<String, String> languageMethods) {
+        var methods = languageMethods.entrySet().stream().map(method ->
+            """
+                    actual fun %s(): Any = %s()
+
+                    @JvmStatic
+                    private external fun %s(): Long
+                """.stripIndent().formatted(
+                method.getKey(), method.getValue(), method.getValue()
+            )
+        );
+        return String.join("\n\n", methods.toList());
+    }
+
+    /** Get the Android {@code actual} declarations of the language methods. */
+    static String androidMethods(Map<String, String> languageMethods) {
+        var methods = languageMethods.entrySet().stream().map(method ->
+                """
+                        actual fun %s(): Any = %s()
+
+                        @JvmStatic
+                        @CriticalNative
+                        private external fun %s(): Long
+                    """.stripIndent().formatted(
+                        method.getKey(), method.getValue(), method.getValue()
+                )
+        );
+        return String.join("\n\n", methods.toList());
+    }
+
+    /** Get the JNI functions that return the languages of the given class. */
+    static String jniFunctions(
+        String packageName,
+        String className,
+        Map<String, String> languageMethods
+    ) {
+        var jniClassName = jniTransform(className);
+        var jniPackageName = jniTransform(packageName).replace('.', '_');
+        var jniPrefix = "Java_%s_%s_".formatted(jniPackageName, jniClassName);
+        var methods = languageMethods.values().stream().map(name ->
+            "NATIVE_FUNCTION(%s%s) {\n    return (jlong)%s();\n}".formatted(
+                jniPrefix, jniTransform(name), name
+            )
+        );
+        return String.join("\n\n", methods.toList());
+    }
+
+    /** Get the JNI name of a method or class. */
+    static String jniTransform(String input) {
+        var builder = new StringBuilder();
+        for (char c : input.toCharArray()) {
+            switch (c) {
+                case '_':
+                    builder.append("_1");
+                    break;
+                case ';':
+                    builder.append("_2");
+                    break;
+                case '[':
+                    builder.append("_3");
+                    break;
+                default:
+                    builder.append(c <= 0x7F ? c : "_0%04x".formatted((int)c));
+            }
+        }
+        return builder.toString();
+    }
+
+    static String readResource(String file) throws GradleException {
+        try (var stream = Templates.class.getResourceAsStream("/" + file)) {
+            var bytes = Objects.requireNonNull(stream).readAllBytes();
+            return new String(bytes, StandardCharsets.UTF_8);
+        } catch (IOException | NullPointerException ex) {
+            throw new GradleException("Failed to read resource file: " + file, ex);
+        }
+    }
+
+    static void writeFile(File file, String content) throws GradleException {
+        try (var writer = new FileWriter(file)) {
+            writer.write(content);
+        } catch (IOException e) {
+            throw new GradleException("Failed to write to file: " + file, e);
+        }
+    }
+
+    static void checkPackageName(String packageName) throws GradleException {
+        if (!packageNameRegex.matcher(packageName).matches())
+            throw new GradleException("Package name is not valid: " + packageName);
+    }
+
+    static void checkClassName(String className) throws GradleException {
+        if (invalidIdentifier(className))
+            throw new GradleException("Class name is not valid: " + className);
+    }
+
+    static void checkLanguageMethods(Map<String, String> languageMethods) throws GradleException {
+        for (var method : languageMethods.entrySet()) {
+            if (invalidIdentifier(method.getKey()))
+                throw new GradleException("Method name is not valid: " + method.getKey());
+            if (invalidIdentifier(method.getValue()))
+                throw new GradleException("Method name is not valid: " + method.getValue());
+        }
+    }
+
+    static boolean invalidIdentifier(String input) {
+        if (!Character.isJavaIdentifierStart(input.charAt(0))) return true;
+        return !input.substring(1).chars().allMatch(Character::isJavaIdentifierPart);
+    }
+
+    @SuppressWarnings("ResultOfMethodCallIgnored")
+    static void mkdirs(File file) { file.mkdirs(); }
+}
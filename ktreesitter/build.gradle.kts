@@ -16,8 +16,8 @@ fun KotlinNativeTarget.treesitter() {
         cinterops.register("treesitter") {
             val srcDir = treesitterDir.resolve("lib/src")
             val includeDir = treesitterDir.resolve("lib/include")
-            includeDirs.allHeaders(srcDir, includeDir)
-            includeDirs.headerFilterOnly(includeDir)
+            includeDirs.allHeaders(srcDir, includeDir, nativeSrcDir)
+            includeDirs.headerFilterOnly(includeDir, nativeSrcDir)
             extraOpts("-libraryPath", libsDir.dir(konanTarget.name))
         }
     }
@@ -26,6 +26,7 @@ fun KotlinNativeTarget.treesitter() {
 val os: OperatingSystem = OperatingSystem.current()
 val libsDir = layout.buildDirectory.get().dir("libs")
 val treesitterDir = rootDir.resolve("tree-sitter")
+val nativeSrcDir = projectDir.resolve("src/lib")
 
 version = property("project.version") as String
 
@@ -273,7 +274,16 @@ tasks.withType<CInteropProcess>().configureEach {
     val libFile = libsDir.dir(konanTarget.name).file(
         "${konanTarget.family.staticPrefix}tree-sitter.${konanTarget.family.staticSuffix}"
     ).asFile
-    val objectFile = treesitterDir.resolve("lib.o")
+    val objectFiles = listOf(
+        "lib.o",
+        "accounting.o",
+        "allocator.o",
+        "diff.o",
+        "loader.o",
+        "log_buffer.o",
+        "symbols.o",
+        "tree_diff.o"
+    ).map(treesitterDir::resolve)
 
     doFirst {
         val argsFile = File.createTempFile("args", null)
@@ -290,6 +300,13 @@ tasks.withType<CInteropProcess>().configureEach {
             write("-g\n")
             write("-c\n")
             write(treesitterDir.resolve("lib/src/lib.c").unixPath + "\n")
+            write(nativeSrcDir.resolve("accounting.c").unixPath + "\n")
+            write(nativeSrcDir.resolve("allocator.c").unixPath + "\n")
+            write(nativeSrcDir.resolve("diff.c").unixPath + "\n")
+            write(nativeSrcDir.resolve("loader.c").unixPath + "\n")
+            write(nativeSrcDir.resolve("log_buffer.c").unixPath + "\n")
+            write(nativeSrcDir.resolve("symbols.c").unixPath + "\n")
+            write(nativeSrcDir.resolve("tree_diff.c").unixPath + "\n")
         }
 
         exec {
@@ -303,7 +320,8 @@ tasks.withType<CInteropProcess>().configureEach {
             executable = runKonan
             workingDir = treesitterDir
             standardOutput = nullOutputStream()
-            args("llvm", "llvm-ar", "rcs", libFile.path, objectFile.path)
+            args("llvm", "llvm-ar", "rcs", libFile.path)
+            args(objectFiles.map { it.path })
         }
     }
 
@@ -317,6 +335,20 @@ tasks.getByName<Test>("jvmTest") {
         outputLocation.set(layout.buildDirectory.dir("reports/xml"))
     }
     systemProperty("gradle.build.dir", layout.buildDirectory.get().asFile.path)
+    systemProperty("ktreesitter.allocator", "pooled")
+}
+
+tasks.register<Test>("jvmForeignTest") {
+    description = "Runs the JVM tests with the foreign function backend."
+    group = "verification"
+    val jvmTest = tasks.getByName<Test>("jvmTest")
+    testClassesDirs = jvmTest.testClassesDirs
+    classpath = jvmTest.classpath
+    useJUnitPlatform()
+    javaLauncher.set(javaToolchains.launcherFor { languageVersion.set(JavaLanguageVersion.of(22)) })
+    jvmArgs("--enable-native-access=ALL-UNNAMED")
+    systemProperty("gradle.build.dir", layout.buildDirectory.get().asFile.path)
+    systemProperty("ktreesitter.backend", "foreign")
 }
 
 tasks.withType<AbstractPublishToMaven>().configureEach {
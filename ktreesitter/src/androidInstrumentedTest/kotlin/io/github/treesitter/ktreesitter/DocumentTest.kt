@@ -0,0 +1,66 @@
+package io.github.treesitter.ktreesitter
+
+import br.com.colman.kotest.KotestRunnerAndroid
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import io.kotest.assertions.throwables.shouldThrow
+import io.kotest.core.spec.style.FunSpec
+import io.kotest.matchers.*
+import io.kotest.matchers.types.*
+import org.junit.runner.RunWith
+
+@RunWith(KotestRunnerAndroid::class)
+class DocumentTest : FunSpec({
+    val language = Language(TreeSitterJava.language())
+    val parser = Parser(language)
+
+    test("length") {
+        val document = Document(parser, "class Foo {}")
+        document.length shouldBe 12
+        document.byteLength shouldBe 12U
+    }
+
+    test("tree") {
+        val document = Document(parser, "class Foo {}")
+        val tree = document.tree
+        tree.rootNode.type shouldBe "program"
+        document.tree shouldBeSameInstanceAs tree
+        document.edit(12, 12, "\n")
+        document.tree shouldNotBeSameInstanceAs tree
+    }
+
+    test("edit()") {
+        val document = Document(parser, "class Foo {}")
+        document.tree
+        val edit = document.edit(11, 11, "\n  int bar;\n")
+        edit.startByte shouldBe 11U
+        edit.oldEndByte shouldBe 11U
+        edit.newEndByte shouldBe 23U
+        edit.startPoint shouldBe Point(0U, 11U)
+        edit.newEndPoint shouldBe Point(2U, 0U)
+        document.text() shouldBe "class Foo {\n  int bar;\n}"
+
+        val body = document.tree.rootNode.child(0U)!!.child(2U)!!
+        body.child(1U)?.type shouldBe "field_declaration"
+        document.tree.rootNode.hasError shouldBe false
+
+        shouldThrow<IndexOutOfBoundsException> { document.edit(0, 100, "") }
+    }
+
+    test("editBytes()") {
+        val document = Document(parser, "class Foo {}")
+        document.editBytes(6U, 9U, "Bar")
+        document.text() shouldBe "class Bar {}"
+        document.tree.rootNode.child(0U)?.child(1U)?.endByte shouldBe 9U
+    }
+
+    test("large document") {
+        val members = (0 until 2000).joinToString("\n") { "  int field$it;" }
+        val document = Document(parser, "class Foo {\n$members\n}")
+        document.tree.rootNode.hasError shouldBe false
+        val index = document.text().indexOf("field1000")
+        document.edit(index, index + 9, "renamed")
+        document.text().contains("int renamed;") shouldBe true
+        document.tree.rootNode.hasError shouldBe false
+        document.tree.rootNode.endByte shouldBe document.byteLength
+    }
+})
@@ -0,0 +1,75 @@
+package io.github.treesitter.ktreesitter
+
+import br.com.colman.kotest.KotestRunnerAndroid
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import io.kotest.assertions.throwables.shouldThrow
+import io.kotest.core.spec.style.FunSpec
+import io.kotest.matchers.*
+import io.kotest.matchers.booleans.*
+import io.kotest.matchers.collections.*
+import io.kotest.matchers.nulls.*
+import org.junit.runner.RunWith
+
+@RunWith(KotestRunnerAndroid::class)
+class LanguageRegistryTest : FunSpec({
+    val language = Language(TreeSitterJava.language())
+
+    test("register()") {
+        val registry = LanguageRegistry()
+        var loads = 0
+        registry.register("java", listOf(".java")) {
+            loads += 1
+            language
+        }
+        ("java" in registry).shouldBeTrue()
+        registry.isLoaded("java").shouldBeFalse()
+        registry["java"] shouldBe language
+        registry["java"] shouldBe language
+        registry.isLoaded("java").shouldBeTrue()
+        loads shouldBe 1
+        registry["kotlin"].shouldBeNull()
+    }
+
+    test("registerLibrary()") {
+        val registry = LanguageRegistry()
+        registry.registerLibrary("java", "/nonexistent/libtree-sitter-java.so", listOf("java"))
+        registry.isLoaded("java").shouldBeFalse()
+        shouldThrow<IllegalArgumentException> { registry.forExtension("java") }
+        registry.isLoaded("java").shouldBeFalse()
+    }
+
+    test("unregister()") {
+        val registry = LanguageRegistry()
+        registry.register("java", language, listOf("java"))
+        registry.unregister("java").shouldBeTrue()
+        registry.unregister("java").shouldBeFalse()
+        registry.names.shouldBeEmpty()
+        registry.forExtension("java").shouldBeNull()
+    }
+
+    test("forExtension()") {
+        val registry = LanguageRegistry()
+        registry.register("java", language, listOf("java"))
+        registry.forExtension("java") shouldBe language
+        registry.forExtension(".java") shouldBe language
+        registry.forExtension("kt").shouldBeNull()
+        registry.register("java", language, listOf("jav"))
+        registry.forExtension("java").shouldBeNull()
+        registry.names shouldContainExactly setOf("java")
+    }
+
+    test("forPath()") {
+        val registry = LanguageRegistry()
+        registry.register("java", language, listOf("java"))
+        registry.register("template", language.copy(), listOf("tpl.java"))
+        registry.forPath("src/Main.java") shouldBe language
+        registry.forPath("C:\\src\\Main.tpl.java") shouldBe language
+        registry.forPath("src.java/Main").shouldBeNull()
+    }
+
+    test("languageSymbolName()") {
+        languageSymbolName("/usr/lib/libtree-sitter-java.so") shouldBe "tree_sitter_java"
+        languageSymbolName("tree-sitter-c-sharp.dll") shouldBe "tree_sitter_c_sharp"
+        languageSymbolName("kotlin.dylib") shouldBe "tree_sitter_kotlin"
+    }
+})
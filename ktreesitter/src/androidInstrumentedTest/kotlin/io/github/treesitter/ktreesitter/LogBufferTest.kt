@@ -0,0 +1,84 @@
+package io.github.treesitter.ktreesitter
+
+import br.com.colman.kotest.KotestRunnerAndroid
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import io.kotest.assertions.throwables.shouldThrow
+import io.kotest.core.spec.style.FunSpec
+import io.kotest.inspectors.forAll
+import io.kotest.matchers.*
+import io.kotest.matchers.collections.*
+import io.kotest.matchers.ints.*
+import io.kotest.matchers.longs.*
+import io.kotest.matchers.nulls.*
+import io.kotest.matchers.types.*
+import org.junit.runner.RunWith
+
+@RunWith(KotestRunnerAndroid::class)
+class LogBufferTest : FunSpec({
+    val language = Language(TreeSitterJava.language())
+    val source = "class Foo {}"
+
+    test("constructor") {
+        shouldThrow<IllegalArgumentException> { LogBuffer(16) }
+        shouldThrow<IllegalArgumentException> { LogBuffer(types = emptySet()) }
+        val buffer = LogBuffer()
+        buffer.capacity shouldBe 65536
+        buffer.types shouldContainExactlyInAnyOrder Parser.LogType.entries
+        buffer.size shouldBe 0
+    }
+
+    test("drain()") {
+        val parser = Parser(language)
+        val logged = mutableListOf<Pair<Parser.LogType, String>>()
+        parser.logger = { type, message -> logged += type to message }
+        parser.parse(source)
+
+        val buffer = LogBuffer()
+        parser.logBuffer = buffer
+        parser.parse(source)
+        val drained = mutableListOf<Pair<Parser.LogType, String>>()
+        buffer.drain { type, message -> drained += type to message } shouldBe logged.size
+        drained shouldBe logged
+        buffer.size shouldBe 0
+        buffer.drain { _, _ -> } shouldBe 0
+    }
+
+    test("types") {
+        val parser = Parser(language)
+        val buffer = LogBuffer(types = setOf(Parser.LogType.PARSE))
+        parser.logBuffer = buffer
+        parser.parse(source)
+        buffer.size shouldBeGreaterThan 0
+        buffer.drain { type, _ -> type shouldBe Parser.LogType.PARSE }
+    }
+
+    test("droppedCount") {
+        val parser = Parser(language)
+        val buffer = LogBuffer(64)
+        parser.logBuffer = buffer
+        parser.parse(source)
+        buffer.droppedCount shouldBeGreaterThan 0L
+        val messages = mutableListOf<String>()
+        buffer.drain { _, message -> messages += message }
+        messages.shouldNotBeEmpty().forAll { it.length shouldBeLessThanOrEqual 59 }
+        buffer.droppedCount shouldBeGreaterThan 0L
+        buffer.clear()
+        buffer.droppedCount shouldBe 0L
+    }
+
+    test("Parser.logBuffer") {
+        val parser = Parser(language)
+        val buffer = LogBuffer()
+        parser.logBuffer.shouldBeNull()
+        parser.logBuffer = buffer
+        parser.logBuffer shouldBeSameInstanceAs buffer
+        parser.logger = { _, _ -> }
+        parser.logBuffer.shouldBeNull()
+        parser.parse(source)
+        buffer.size shouldBe 0
+        parser.logBuffer = buffer
+        parser.logBuffer = null
+        parser.parse(source)
+        buffer.size shouldBe 0
+    }
+})
@@ -0,0 +1,94 @@
+package io.github.treesitter.ktreesitter
+
+import br.com.colman.kotest.KotestRunnerAndroid
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import io.kotest.assertions.throwables.shouldThrow
+import io.kotest.assertions.throwables.shouldThrowWithMessage
+import io.kotest.core.spec.style.FunSpec
+import io.kotest.matchers.*
+import io.kotest.matchers.collections.*
+import org.junit.runner.RunWith
+
+@RunWith(KotestRunnerAndroid::class)
+class TaggerTest : FunSpec({
+    val language = Language(TreeSitterJava.language())
+    val parser = Parser(language)
+    val query = """
+    (class_declaration name: (identifier) @name) @definition.class
+
+    ((block_comment)* @doc
+     .
+     (method_declaration name: (identifier) @name) @definition.method
+     (#strip! @doc "^/\\*\\*\\s*|\\s*\\*/$")
+     (#select-adjacent! @doc @definition.method))
+
+    (method_invocation name: (identifier) @name) @reference.call
+    """.trimIndent()
+    val source = """
+    class Foo {
+        /** Bar. */
+        void bar() { baz(); }
+    }
+    """.trimIndent()
+
+    fun TagBuffer.toList() = List(size) {
+        listOf(
+            syntaxType(it),
+            isDefinition(it),
+            nameStartByte(it),
+            nameEndByte(it),
+            startByte(it),
+            endByte(it),
+            row(it),
+            docs(it)
+        )
+    }
+
+    test("constructor") {
+        Tagger(language, query).syntaxTypes shouldBe listOf("class", "method", "call")
+        shouldThrowWithMessage<QueryError.Predicate>(
+            "Invalid predicate in pattern at row 0: #strip! expects a capture and a string literal"
+        ) {
+            Tagger(language, "((block_comment) @doc (#strip! @doc @doc))")
+        }
+    }
+
+    test("tag()") {
+        val tags = Tagger(language, query).tag(parser.parse(source))
+        tags.size shouldBe 3
+        tags.toList() shouldBe listOf(
+            listOf("class", true, 6U, 9U, 0U, 55U, 0U, null),
+            listOf("method", true, 37U, 40U, 32U, 53U, 2U, "Bar."),
+            listOf("call", false, 45U, 48U, 45U, 50U, 2U, null)
+        )
+        shouldThrow<IndexOutOfBoundsException> { tags.row(3) }
+    }
+
+    test("retag()") {
+        val tagger = Tagger(language, query)
+        val tree = parser.parse(source)
+        val tags = tagger.tag(tree)
+
+        val newSource = source.replace("baz();", "baz(); qux();")
+        val edit = InputEdit(51U, 51U, 58U, Point(2U, 23U), Point(2U, 23U), Point(2U, 30U))
+        tree.edit(edit)
+        val newTree = parser.parse(newSource, oldTree = tree)
+        tagger.retag(tags, newTree, listOf(edit), tree.changedRanges(newTree))
+        tags.toList() shouldBe tagger.tag(newTree).toList()
+        tags.toList().map { it[0] } shouldBe listOf("class", "method", "call", "call")
+    }
+
+    test("retag() with edited docs") {
+        val tagger = Tagger(language, query)
+        val tree = parser.parse(source)
+        val tags = tagger.tag(tree)
+
+        val newSource = source.replace("Bar.", "Baz.")
+        val edit = InputEdit(22U, 23U, 23U, Point(1U, 10U), Point(1U, 11U), Point(1U, 11U))
+        tree.edit(edit)
+        val newTree = parser.parse(newSource, oldTree = tree)
+        tagger.retag(tags, newTree, listOf(edit), tree.changedRanges(newTree))
+        tags.toList() shouldBe tagger.tag(newTree).toList()
+        tags.docs(1) shouldBe "Baz."
+    }
+})
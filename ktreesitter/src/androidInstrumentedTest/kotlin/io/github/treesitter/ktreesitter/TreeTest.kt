@@ -5,6 +5,7 @@ import io.github.treesitter.ktreesitter.java.TreeSitterJava
 import io.kotest.core.spec.style.FunSpec
 import io.kotest.matchers.*
 import io.kotest.matchers.collections.*
+import io.kotest.matchers.comparables.*
 import io.kotest.matchers.nulls.*
 import io.kotest.matchers.types.*
 import org.junit.runner.RunWith
@@ -15,6 +16,12 @@ class TreeTest : FunSpec({
     val parser = Parser(language)
     var source = "class Foo {}"
     var tree = parser.parse(source)
+    val diffSource = "class Foo {\n  int x;\n  void a() {}\n  void b() {}\n\n}"
+
+    fun TreeDiff.edits(type: TreeDiff.Kind) = (0..<size).filter { kind(it) == type }.map {
+        val name = language.symbolName(symbol(it))
+        listOf(name, oldStartByte(it), oldEndByte(it), newStartByte(it), newEndByte(it))
+    }
 
     test("language") {
         tree.language shouldBeSameInstanceAs language
@@ -30,6 +37,16 @@ class TreeTest : FunSpec({
         }
     }
 
+    test("nativeSizeBytes") {
+        val size = tree.nativeSizeBytes
+        if (TreeSitter.allocator == NativeAllocator.SYSTEM) {
+            size shouldBe 0UL
+        } else {
+            size shouldBeGreaterThan 0UL
+            tree.copy().nativeSizeBytes shouldBeLessThan size
+        }
+    }
+
     test("rootNodeWithOffset()") {
         val node = tree.rootNodeWithOffset(6U, Point(0U, 6U))
         node?.text() shouldBe "Foo {}"
@@ -48,6 +65,15 @@ class TreeTest : FunSpec({
         tree.text() shouldBe source
     }
 
+    test("edit(edits)") {
+        val edit = InputEdit(0U, 0U, 1U, Point(0U, 0U), Point(0U, 0U), Point(0U, 1U))
+        val copy = tree.copy()
+        val node = copy.rootNode
+        copy.edit(listOf(edit, edit), listOf(node))
+        copy.text().shouldBeNull()
+        node.hasChanges shouldBe true
+    }
+
     test("walk()") {
         val cursor = tree.walk()
         cursor.tree shouldBeSameInstanceAs tree
@@ -61,4 +87,61 @@ class TreeTest : FunSpec({
             it.endByte == 7U && it.endPoint.column == 7U
         }
     }
+
+    test("diff()") {
+        val oldTree = parser.parse("class Foo {}")
+        val edit = InputEdit(11U, 11U, 24U, Point(0U, 11U), Point(0U, 11U), Point(0U, 24U))
+        oldTree.edit(edit)
+        val newTree = parser.parse("class Foo {void bar() {}}", oldTree)
+        val diff = oldTree.diff(newTree)
+        diff.size shouldBe 1
+        diff.kind(0) shouldBe TreeDiff.Kind.INSERTED
+        language.symbolName(diff.symbol(0)) shouldBe "method_declaration"
+        diff.oldStartByte(0) shouldBe UInt.MAX_VALUE
+        diff.newStartByte(0) shouldBe 11U
+        diff.newEndByte(0) shouldBe 24U
+        oldTree.diff(oldTree.copy()).size shouldBe 0
+    }
+
+    test("diff() with a deleted node") {
+        val oldTree = parser.parse(diffSource)
+        // the deleted node collapses to the start of the edit
+        val edit = InputEdit(35U, 48U, 35U, Point(3U, 0U), Point(3U, 13U), Point(3U, 0U))
+        oldTree.edit(edit)
+        val newTree = parser.parse("class Foo {\n  int x;\n  void a() {}\n\n\n}", oldTree)
+        val diff = oldTree.diff(newTree)
+        diff.edits(TreeDiff.Kind.INSERTED).shouldBeEmpty()
+        diff.edits(TreeDiff.Kind.DELETED) shouldBe listOf(
+            listOf("method_declaration", 35U, 35U, UInt.MAX_VALUE, UInt.MAX_VALUE)
+        )
+    }
+
+    test("diff() with an updated node") {
+        val oldTree = parser.parse(diffSource)
+        val edit = InputEdit(28U, 29U, 29U, Point(2U, 7U), Point(2U, 8U), Point(2U, 8U))
+        oldTree.edit(edit)
+        val newSource = "class Foo {\n  int x;\n  void c() {}\n  void b() {}\n\n}"
+        val newTree = parser.parse(newSource, oldTree)
+        val diff = oldTree.diff(newTree)
+        diff.edits(TreeDiff.Kind.INSERTED).shouldBeEmpty()
+        diff.edits(TreeDiff.Kind.DELETED).shouldBeEmpty()
+        diff.edits(TreeDiff.Kind.UPDATED).filter { it[0] == "identifier" } shouldBe listOf(
+            listOf("identifier", 28U, 29U, 28U, 29U)
+        )
+    }
+
+    test("diff() with a moved node") {
+        val oldTree = parser.parse(diffSource)
+        // move a() after b() so that the parser reuses b()
+        oldTree.edit(InputEdit(21U, 34U, 21U, Point(2U, 0U), Point(2U, 13U), Point(2U, 0U)))
+        oldTree.edit(InputEdit(37U, 37U, 51U, Point(5U, 0U), Point(5U, 0U), Point(6U, 0U)))
+        val newSource = "class Foo {\n  int x;\n\n  void b() {}\n\n  void a() {}\n}"
+        val newTree = parser.parse(newSource, oldTree)
+        val diff = oldTree.diff(newTree)
+        diff.edits(TreeDiff.Kind.INSERTED).shouldBeEmpty()
+        diff.edits(TreeDiff.Kind.DELETED).shouldBeEmpty()
+        diff.edits(TreeDiff.Kind.MOVED) shouldBe listOf(
+            listOf("method_declaration", 24U, 35U, 24U, 35U)
+        )
+    }
 })
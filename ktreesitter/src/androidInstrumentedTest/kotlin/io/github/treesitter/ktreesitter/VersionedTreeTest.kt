@@ -0,0 +1,61 @@
+package io.github.treesitter.ktreesitter
+
+import br.com.colman.kotest.KotestRunnerAndroid
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import io.kotest.assertions.throwables.shouldThrow
+import io.kotest.core.spec.style.FunSpec
+import io.kotest.matchers.*
+import io.kotest.matchers.types.*
+import org.junit.runner.RunWith
+
+@RunWith(KotestRunnerAndroid::class)
+class VersionedTreeTest : FunSpec({
+    val language = Language(TreeSitterJava.language())
+
+    test("snapshot()") {
+        val versionedTree = VersionedTree(Parser(language), "class Foo {}")
+        versionedTree.version shouldBe 0L
+        val first = versionedTree.snapshot()
+        val second = versionedTree.snapshot()
+        first.version shouldBe 0L
+        first.tree shouldNotBeSameInstanceAs second.tree
+        first.text() shouldBe "class Foo {}"
+        first.close()
+        shouldThrow<IllegalStateException> { first.tree }
+        second.tree.rootNode.type shouldBe "program"
+        second.close()
+        versionedTree.close()
+        shouldThrow<IllegalStateException> { versionedTree.snapshot() }
+    }
+
+    test("update()") {
+        val versionedTree = VersionedTree(Parser(language), "class Foo {}")
+        val old = versionedTree.snapshot()
+        versionedTree.update("class Foo { int bar; }") shouldBe 1L
+        val edit = InputEdit(12U, 12U, 20U, Point(0U, 12U), Point(0U, 12U), Point(0U, 20U))
+        versionedTree.update("class Foo { int bar; int baz; }", listOf(edit)) shouldBe 2L
+        versionedTree.snapshot().use {
+            it.version shouldBe 2L
+            it.text() shouldBe "class Foo { int bar; int baz; }"
+            it.tree.rootNode.hasError shouldBe false
+        }
+        old.text() shouldBe "class Foo {}"
+        old.tree.rootNode.endByte shouldBe 12U
+        old.close()
+        versionedTree.close()
+    }
+
+    test("close()") {
+        val versionedTree = VersionedTree(Parser(language), "class Foo {}")
+        val snapshot = versionedTree.snapshot()
+        val tree = snapshot.tree
+        val node = tree.rootNode.child(0U)!!
+        snapshot.close()
+        versionedTree.update("class Bar {}")
+        versionedTree.close()
+        shouldThrow<IllegalStateException> { snapshot.tree.rootNode }
+        tree.rootNode.type shouldBe "program"
+        node.type shouldBe "class_declaration"
+        node.endByte shouldBe 12U
+    }
+})
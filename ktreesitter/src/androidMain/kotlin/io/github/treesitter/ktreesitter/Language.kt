@@ -165,6 +165,22 @@ actual class Language @Throws(IllegalArgumentException::class) actual constructo
     @Throws(IllegalArgumentException::class)
     actual fun lookaheadIterator(state: UShort) = LookaheadIterator(this, state)
 
+    /**
+     * Get the symbols that are valid in the given parse state.
+     *
+     * This is equivalent to collecting the [symbols][LookaheadIterator.symbols]
+     * of a [lookaheadIterator], but the array is filled in a single native call.
+     *
+     * @throws [IllegalArgumentException] If the state is invalid for this language.
+     * @see ValidSymbolsCache
+     * @since 0.26.0
+     */
+    @FastNative
+    @JvmName("validSymbols")
+    @Throws(IllegalArgumentException::class)
+    @OptIn(ExperimentalUnsignedTypes::class)
+    actual external fun validSymbols(state: UShort): UShortArray
+
     /**
      * Create a new [Query] from a string containing one or more S-expression
      * [patterns](https://tree-sitter.github.io/tree-sitter/using-parsers/queries/1-syntax.html).
@@ -207,11 +223,39 @@ actual class Language @Throws(IllegalArgumentException::class) actual constructo
         }
     }
 
-    private companion object {
+    /** The methods that load a language at runtime. */
+    actual companion object {
+        /**
+         * Load a language from the shared library at the given [path].
+         *
+         * The language is returned by the function with the given [symbolName],
+         * which defaults to `tree_sitter_<name>`, where the name is derived from
+         * the file name of the library by removing its `lib` and `tree-sitter-`
+         * prefixes and its extension. For example, `libtree-sitter-c-sharp.so`
+         * defines `tree_sitter_c_sharp`.
+         *
+         * The library is never unloaded, and loading it again returns the same language.
+         *
+         * @throws [IllegalArgumentException]
+         *  If the library or the symbol could not be loaded,
+         *  or if the [version][abiVersion] is incompatible.
+         * @see LanguageRegistry
+         * @since 0.26.0
+         */
+        @JvmStatic
+        @JvmOverloads
+        @Throws(IllegalArgumentException::class)
+        actual fun load(path: String, symbolName: String?) =
+            Language(loadSymbol(path, symbolName ?: languageSymbolName(path)))
+
         @JvmStatic
         @CriticalNative
         private external fun copy(self: Long): Long
 
+        @JvmStatic
+        @Throws(IllegalArgumentException::class)
+        private external fun loadSymbol(path: String, symbol: String): Long
+
         init {
             System.loadLibrary("ktreesitter")
         }
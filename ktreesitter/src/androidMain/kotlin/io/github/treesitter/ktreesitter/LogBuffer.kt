@@ -0,0 +1,84 @@
+package io.github.treesitter.ktreesitter
+
+import dalvik.annotation.optimization.CriticalNative
+import dalvik.annotation.optimization.FastNative
+
+/**
+ * A buffer that records the log messages of a [parser][Parser.logBuffer] in native memory.
+ *
+ * Unlike a [logger][Parser.logger], which calls into Kotlin for every message,
+ * the buffer copies each message into a ring of [capacity] bytes without leaving
+ * native code, and drops the oldest messages once it is full. The messages
+ * can then be [drained][drain] in bulk, for example only when a parse fails,
+ * so logging can be left enabled at a low cost.
+ *
+ * A buffer must only be used by one parser at a time, and it must not be drained
+ * while that parser is parsing. Messages longer than the capacity are truncated.
+ *
+ * __NOTE:__ If you're targeting Android SDK level < 33,
+ * you must `use` or [close] the instance to free up resources.
+ *
+ * @constructor Create a new buffer that records the messages of the given [types].
+ * @throws [IllegalArgumentException]
+ *  If the capacity is less than `64` bytes or if there are no types.
+ * @since 0.26.0
+ */
+actual class LogBuffer @Throws(IllegalArgumentException::class) actual constructor(
+    actual val capacity: Int,
+    types: Set<Parser.LogType>
+) : AutoCloseable {
+    /** The types of messages that are recorded. */
+    actual val types: Set<Parser.LogType> = types.toSet()
+
+    private val self: Long
+
+    init {
+        require(capacity >= 64) { "The capacity must be at least 64 bytes" }
+        require(types.isNotEmpty()) { "At least one type must be recorded" }
+        self = init(capacity, Parser.LogType.LEX in types, Parser.LogType.PARSE in types)
+        if (self == 0L) throw OutOfMemoryError("Failed to allocate the log buffer")
+        RefCleaner(this, CleanAction(self))
+    }
+
+    /** The number of messages in the buffer. */
+    actual val size: Int
+        @FastNative external get
+
+    /** The number of messages that were dropped to make room since the buffer was cleared. */
+    actual val droppedCount: Long
+        @FastNative external get
+
+    /**
+     * Remove every message from the buffer, from the oldest to the newest,
+     * and pass it to the given [function].
+     *
+     * @return The number of messages that were drained.
+     */
+    actual external fun drain(function: LogFunction): Int
+
+    /** Remove every message from the buffer and reset the [dropped count][droppedCount]. */
+    @FastNative
+    actual external fun clear()
+
+    override fun close() = delete(self)
+
+    override fun toString() = "LogBuffer(capacity=$capacity, types=$types)"
+
+    private class CleanAction(private val ptr: Long) : Runnable {
+        override fun run() = delete(ptr)
+    }
+
+    private companion object {
+        @JvmStatic
+        @CriticalNative
+        private external fun init(capacity: Int, lex: Boolean, parse: Boolean): Long
+
+        @JvmStatic
+        @CriticalNative
+        private external fun delete(self: Long)
+
+        init {
+            System.loadLibrary("ktreesitter")
+        }
+    }
+}
@@ -1,5 +1,6 @@
 package io.github.treesitter.ktreesitter
 
+import dalvik.annotation.optimization.CriticalNative
 import dalvik.annotation.optimization.FastNative
 
 /** A single node within a [syntax tree][Tree]. */
@@ -23,7 +24,7 @@ actual class Node internal constructor(
     /** The numerical ID of the node's type. */
     @get:JvmName("getSymbol")
     actual val symbol: UShort
-        @FastNative external get
+        get() = fields(::nativeSymbol).toUShort()
 
     /**
      * The numerical ID of the node's type,
@@ -31,7 +32,7 @@ actual class Node internal constructor(
      */
     @get:JvmName("getGrammarSymbol")
     actual val grammarSymbol: UShort
-        @FastNative external get
+        get() = fields(::nativeGrammarSymbol).toUShort()
 
     /** The type of the node. */
     actual val type: String
@@ -51,7 +52,7 @@ actual class Node internal constructor(
      * whereas _anonymous_ nodes correspond to string literals.
      */
     actual val isNamed: Boolean
-        @FastNative external get
+        get() = fields(::nativeIsNamed)
 
     /**
      * Check if the node is _extra_.
@@ -60,11 +61,11 @@ actual class Node internal constructor(
      * by the grammar but can appear anywhere (e.g. whitespace).
      */
     actual val isExtra: Boolean
-        @FastNative external get
+        get() = fields(::nativeIsExtra)
 
     /** Check if the node is a syntax error. */
     actual val isError: Boolean
-        @FastNative external get
+        get() = fields(::nativeIsError)
 
     /**
      * Check if the node is _missing_.
@@ -73,12 +74,12 @@ actual class Node internal constructor(
      * to recover from certain kinds of syntax errors.
      */
     actual val isMissing: Boolean
-        @FastNative external get
+        get() = fields(::nativeIsMissing)
 
     /** Check if the node has been edited. */
     @get:JvmName("hasChanges")
     actual val hasChanges: Boolean
-        @FastNative external get
+        get() = fields(::nativeHasChanges)
 
     /**
      * Check if the node is a syntax error,
@@ -86,27 +87,27 @@ actual class Node internal constructor(
      */
     @get:JvmName("hasError")
     actual val hasError: Boolean
-        @FastNative external get
+        get() = fields(::nativeHasError)
 
     /** The parse state of this node. */
     @get:JvmName("getParseState")
     actual val parseState: UShort
-        @FastNative external get
+        get() = fields(::nativeParseState).toUShort()
 
     /** The parse state after this node. */
     @get:JvmName("getNextParseState")
     actual val nextParseState: UShort
-        @FastNative external get
+        get() = fields(::nativeNextParseState).toUShort()
 
     /** The start byte of the node. */
     @get:JvmName("getStartByte")
     actual val startByte: UInt
-        @FastNative external get
+        get() = fields(::nativeStartByte).toUInt()
 
     /** The end byte of the node. */
     @get:JvmName("getEndByte")
     actual val endByte: UInt
-        @FastNative external get
+        get() = fields(::nativeEndByte).toUInt()
 
     /** The range of the node in terms of bytes. */
     actual val byteRange: UIntRange
@@ -127,12 +128,12 @@ actual class Node internal constructor(
     /** The number of this node's children. */
     @get:JvmName("getChildCount")
     actual val childCount: UInt
-        @FastNative external get
+        get() = fields(::nativeChildCount).toUInt()
 
     /** The number of this node's _named_ children. */
     @get:JvmName("getNamedChildCount")
     actual val namedChildCount: UInt
-        @FastNative external get
+        get() = fields(::nativeNamedChildCount).toUInt()
 
     /**
      * The number of this node's descendants,
@@ -140,7 +141,7 @@ actual class Node internal constructor(
      */
     @get:JvmName("getDescendantCount")
     actual val descendantCount: UInt
-        @FastNative external get
+        get() = fields(::nativeDescendantCount).toUInt()
 
     /** The node's immediate parent, if any. */
     actual val parent: Node?
@@ -329,6 +330,21 @@ actual class Node internal constructor(
     /** Get the S-expression of the node. */
     actual external fun sexp(): String
 
+    /**
+     * Count the nodes of each symbol in the subtree of this node, including itself.
+     *
+     * The result is indexed by the [symbol] of the nodes and has the size of the
+     * [symbol count][Language.symbolCount] of the language. Only the visible nodes,
+     * which are the ones that queries can match, are counted in a single native pass.
+     *
+     * @see QueryPlanner
+     * @since 0.26.0
+     */
+    @JvmName("symbolHistogram")
+    @OptIn(ExperimentalUnsignedTypes::class)
+    @FastNative
+    actual external fun symbolHistogram(): UIntArray
+
     actual override fun equals(other: Any?) =
         this === other || (other is Node && nativeEquals(other))
 
@@ -339,4 +355,184 @@ actual class Node internal constructor(
 
     @FastNative
     private external fun nativeEquals(that: Node): Boolean
+
+    /**
+     * Call a getter with the fields of the node, so that the
+     * native function does not have to look them up through JNI.
+     */
+    private inline fun <T> fields(getter: (Long, Int, Int, Int, Int, Long) -> T): T {
+        val context = context
+        try {
+            return getter(id.toLong(), context[0], context[1], context[2], context[3], tree.self)
+        } finally {
+            RefCleaner.keepAlive(tree)
+        }
+    }
+
+    private companion object {
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeSymbol(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Short
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeGrammarSymbol(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Short
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeIsNamed(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Boolean
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeIsExtra(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Boolean
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeIsError(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Boolean
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeIsMissing(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Boolean
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeHasError(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Boolean
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeHasChanges(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Boolean
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeParseState(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Short
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeNextParseState(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Short
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeStartByte(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Int
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeEndByte(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Int
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeChildCount(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Int
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeNamedChildCount(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Int
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeDescendantCount(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Int
+    }
 }
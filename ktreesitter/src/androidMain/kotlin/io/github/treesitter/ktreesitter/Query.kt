@@ -20,12 +20,23 @@ actual class Query @Throws(QueryError::class) actual constructor(
 ) : AutoCloseable {
     internal val self: Long = init(language.self, source)
 
-    internal val predicates: List<MutableList<QueryPredicate>>
+    internal actual val predicates: List<MutableList<QueryPredicate>>
 
     private val settingList: List<MutableMap<String, String?>>
 
     private val assertionList: List<MutableMap<String, Pair<String?, Boolean>>>
 
+    /**
+     * The number of bytes of native memory that are held by the query.
+     *
+     * This is always `0` when the [allocator][TreeSitter.allocator] is [NativeAllocator.SYSTEM].
+     *
+     * @since 0.26.0
+     */
+    @get:JvmName("getNativeSizeBytes")
+    actual val nativeSizeBytes: ULong
+        @FastNative external get
+
     /** The number of patterns in the query. */
     @get:JvmName("getPatternCount")
     actual val patternCount: UInt
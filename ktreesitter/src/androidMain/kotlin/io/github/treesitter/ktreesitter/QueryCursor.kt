@@ -14,14 +14,14 @@ import dalvik.annotation.optimization.FastNative
 actual class QueryCursor internal constructor(
     private val query: Query,
     private val node: Node,
-    progressCallback: QueryProgressCallback? = null
+    private val progressCallback: QueryProgressCallback? = null
 ) : AutoCloseable {
     private val self: Long = init()
 
     init {
         RefCleaner(this, CleanAction(self))
 
-        exec(query.self, node, progressCallback)
+        exec(query.self, node)
     }
 
     /**
@@ -68,6 +68,68 @@ actual class QueryCursor internal constructor(
     actual var maxStartDepth: UInt = UInt.MAX_VALUE
         @FastNative external set
 
+    /**
+     * The maximum number of bytes that a single execution
+     * of the query may allocate, or `0` if there is no limit.
+     *
+     * When the limit is exceeded, the execution is halted and iterating over
+     * the [matches] or [captures] throws a [MemoryLimitExceededException].
+     *
+     * Default: `0`
+     *
+     * @throws [IllegalStateException]
+     *  If a limit is set while the [allocator][TreeSitter.allocator] does not track memory.
+     * @since 0.26.0
+     */
+    @get:JvmName("getMemoryLimitBytes")
+    @set:JvmName("setMemoryLimitBytes")
+    @set:Throws(IllegalStateException::class)
+    actual var memoryLimitBytes: ULong = 0UL
+        set(value) {
+            checkMemoryLimit(value)
+            field = value
+        }
+
+    /**
+     * A listener that can halt the execution of the query.
+     *
+     * Unlike a [QueryProgressCallback], the listener receives an unboxed argument and is
+     * only called once every [progressIntervalBytes] or [progressIntervalMicros], so it
+     * is cheap enough to be kept around for cancellation.
+     *
+     * @since 0.26.0
+     */
+    actual var progressListener: QueryProgressListener? = null
+
+    /**
+     * The number of bytes that the cursor must advance
+     * before the [progressListener] is called again.
+     *
+     * If both this and [progressIntervalMicros] are `0`, the listener is called
+     * every time the cursor checks its progress. Otherwise, it is called as soon
+     * as either of the intervals has passed.
+     *
+     * Default: `0`
+     *
+     * @since 0.26.0
+     */
+    @get:JvmName("getProgressIntervalBytes")
+    @set:JvmName("setProgressIntervalBytes")
+    actual var progressIntervalBytes: UInt = 0U
+
+    /**
+     * The number of microseconds that must pass before
+     * the [progressListener] is called again.
+     *
+     * Default: `0`
+     *
+     * @see progressIntervalBytes
+     * @since 0.26.0
+     */
+    @get:JvmName("getProgressIntervalMicros")
+    @set:JvmName("setProgressIntervalMicros")
+    actual var progressIntervalMicros: ULong = 0UL
+
     /**
      * The range of bytes in which the query will be executed.
      *
@@ -116,6 +178,24 @@ actual class QueryCursor internal constructor(
     actual val didExceedMatchLimit: Boolean
         @FastNative external get
 
+    /**
+     * The profile that records the statistics of every pattern
+     * that is matched by this cursor, or `null` if it is not profiled.
+     *
+     * Default: `null`
+     *
+     * @throws [IllegalArgumentException] If the profile was created for a different query.
+     * @since 0.26.0
+     */
+    @set:Throws(IllegalArgumentException::class)
+    actual var profile: QueryProfile? = null
+        set(value) {
+            require(value == null || value.query === query) {
+                "The profile was created for a different query"
+            }
+            field = value
+        }
+
     /**
      * Iterate over all the matches in the order that they were found.
      *
@@ -140,6 +220,7 @@ actual class QueryCursor internal constructor(
             if (result != null) yield(result)
             match = nextMatch(query.captureNames, node.tree)
         }
+        profile?.finish(didExceedMatchLimit)
     }
 
     /**
@@ -155,10 +236,13 @@ actual class QueryCursor internal constructor(
             var capture = nextCapture(query.captureNames, node.tree)
             while (capture != null) {
                 val index = capture.first
-                val match = capture.second.check(predicate)
+                // The same match is returned for each of its captures, in order
+                val isLast = index == capture.second.captures.size.toUInt() - 1U
+                val match = capture.second.check(predicate, isLast)
                 if (match != null) yield(index to match)
                 capture = nextCapture(query.captureNames, node.tree)
             }
+            profile?.finish(didExceedMatchLimit)
         }
 
     override fun toString() = "QueryCursor(query=$query, node=$node)"
@@ -181,16 +265,24 @@ actual class QueryCursor internal constructor(
     ): Pair<UInt, QueryMatch>?
 
     @FastNative
-    private external fun exec(query: Long, node: Node, progressCallback: QueryProgressCallback?)
+    private external fun exec(query: Long, node: Node)
 
+    /** Evaluate the predicates of the match, and [record] it in the profile if there is one. */
     private inline fun QueryMatch.check(
-        predicate: QueryPredicate.(QueryMatch) -> Boolean
+        predicate: QueryPredicate.(QueryMatch) -> Boolean,
+        record: Boolean = true
     ): QueryMatch? {
-        if (node.tree.text() == null) return this
-        val result = query.predicates[patternIndex.toInt()].all {
+        val profile = profile?.takeIf { record } ?: return takeIf { evaluate(predicate) }
+        return takeIf { profile.record(this) { evaluate(predicate) } }
+    }
+
+    private inline fun QueryMatch.evaluate(
+        predicate: QueryPredicate.(QueryMatch) -> Boolean
+    ): Boolean {
+        if (node.tree.text() == null) return true
+        return query.predicates[patternIndex.toInt()].all {
             if (it !is QueryPredicate.Generic) it(this) else predicate(it, this)
         }
-        return if (result) this else null
     }
 
     private class CleanAction(private val ptr: Long) : Runnable {
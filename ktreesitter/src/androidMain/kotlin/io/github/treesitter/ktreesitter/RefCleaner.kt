@@ -5,12 +5,23 @@ package io.github.treesitter.ktreesitter
 import android.os.Build.VERSION.SDK_INT
 import android.os.Build.VERSION_CODES.TIRAMISU
 import java.lang.ref.Cleaner
+import java.lang.ref.Reference
 
 internal object RefCleaner {
     private val INSTANCE = if (SDK_INT < TIRAMISU) null else Cleaner.create()
 
     @JvmName("register")
-    operator fun invoke(obj: Any, action: Runnable) {
-        if (SDK_INT >= TIRAMISU) INSTANCE!!.register(obj, action)
+    operator fun invoke(obj: Any, action: Runnable): Cleaner.Cleanable? =
+        if (SDK_INT >= TIRAMISU) INSTANCE!!.register(obj, action) else null
+
+    /**
+     * Keep the object from being cleaned until this point, so that a native
+     * call which only received its pointer cannot outlive the object.
+     *
+     * Objects are only cleaned automatically on SDK level 33 and above.
+     */
+    @JvmStatic
+    fun keepAlive(obj: Any) {
+        if (SDK_INT >= TIRAMISU) Reference.reachabilityFence(obj)
     }
 }
@@ -0,0 +1,10 @@
+package io.github.treesitter.ktreesitter
+
+// The parser reads strings as modified UTF-8, which encodes
+// NUL as two bytes and every surrogate as three bytes.
+internal actual fun Char.encodedSize() = when {
+    this == '\u0000' -> 2
+    this < '\u0080' -> 1
+    this < '\u0800' -> 2
+    else -> 3
+}
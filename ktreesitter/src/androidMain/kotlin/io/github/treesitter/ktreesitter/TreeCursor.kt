@@ -34,7 +34,7 @@ actual class TreeCursor private constructor(
      */
     @get:JvmName("getCurrentDepth")
     actual val currentDepth: UInt
-        @FastNative external get
+        get() = call(::nativeCurrentDepth).toUInt()
 
     /**
      * The field ID of the tree cursor's current node, or `0`.
@@ -44,7 +44,7 @@ actual class TreeCursor private constructor(
      */
     @get:JvmName("getCurrentFieldId")
     actual val currentFieldId: UShort
-        @FastNative external get
+        get() = call(::nativeCurrentFieldId).toUShort()
 
     /**
      * The field name of the tree cursor's current node, if available.
@@ -60,7 +60,7 @@ actual class TreeCursor private constructor(
      */
     @get:JvmName("getCurrentDescendantIndex")
     actual val currentDescendantIndex: UInt
-        @FastNative external get
+        get() = call(::nativeCurrentDescendantIndex).toUInt()
 
     /** Create a shallow copy of the tree cursor. */
     actual fun copy() = TreeCursor(copy(self), tree)
@@ -80,8 +80,11 @@ actual class TreeCursor private constructor(
      *  `true` if the cursor successfully moved,
      *  or `false` if there were no children.
      */
-    @FastNative
-    actual external fun gotoFirstChild(): Boolean
+    actual fun gotoFirstChild(): Boolean {
+        if (!call(::nativeGotoFirstChild)) return false
+        internalNode = null
+        return true
+    }
 
     /**
      * Move the cursor to the last child of its current node.
@@ -90,8 +93,11 @@ actual class TreeCursor private constructor(
      *  `true` if the cursor successfully moved,
      *  or `false` if there were no children.
      */
-    @FastNative
-    actual external fun gotoLastChild(): Boolean
+    actual fun gotoLastChild(): Boolean {
+        if (!call(::nativeGotoLastChild)) return false
+        internalNode = null
+        return true
+    }
 
     /**
      * Move the cursor to the parent of its current node.
@@ -100,8 +106,11 @@ actual class TreeCursor private constructor(
      *  `true` if the cursor successfully moved,
      *  or `false` if there was no parent node.
      */
-    @FastNative
-    actual external fun gotoParent(): Boolean
+    actual fun gotoParent(): Boolean {
+        if (!call(::nativeGotoParent)) return false
+        internalNode = null
+        return true
+    }
 
     /**
      * Move the cursor to the next sibling of its current node.
@@ -110,8 +119,11 @@ actual class TreeCursor private constructor(
      *  `true` if the cursor successfully moved,
      *  or `false` if there was no next sibling node.
      */
-    @FastNative
-    actual external fun gotoNextSibling(): Boolean
+    actual fun gotoNextSibling(): Boolean {
+        if (!call(::nativeGotoNextSibling)) return false
+        internalNode = null
+        return true
+    }
 
     /**
      * Move the cursor to the previous sibling of its current node.
@@ -124,16 +136,22 @@ actual class TreeCursor private constructor(
      *  `true` if the cursor successfully moved,
      *  or `false` if there was no previous sibling node.
      */
-    actual external fun gotoPreviousSibling(): Boolean
+    actual fun gotoPreviousSibling(): Boolean {
+        if (!call(::nativeGotoPreviousSibling)) return false
+        internalNode = null
+        return true
+    }
 
     /**
      * Move the cursor to the node that is the nth descendant of
      * the original node that the cursor was constructed with,
      * where `0` represents the original node itself.
      */
-    @FastNative
     @JvmName("gotoDescendant")
-    actual external fun gotoDescendant(index: UInt)
+    actual fun gotoDescendant(index: UInt) {
+        call { nativeGotoDescendant(it, index.toInt()) }
+        internalNode = null
+    }
 
     /**
      * Move the cursor to the first child of its current
@@ -143,7 +161,7 @@ actual class TreeCursor private constructor(
      */
     @JvmName("gotoFirstChildForByte")
     actual fun gotoFirstChildForByte(byte: UInt): UInt? {
-        val result = nativeGotoFirstChildForByte(byte)
+        val result = call { nativeGotoFirstChildForByte(it, byte.toInt()) }
         if (result == -1L) return null
         internalNode = null
         return result.toUInt()
@@ -165,11 +183,16 @@ actual class TreeCursor private constructor(
 
     override fun toString() = "TreeCursor(tree=$tree)"
 
-    override fun close() = delete(self)
+    /** Call a native function that only receives the pointer, keeping the cursor alive. */
+    private inline fun <T> call(native: (Long) -> T): T {
+        try {
+            return native(self)
+        } finally {
+            RefCleaner.keepAlive(this)
+        }
+    }
 
-    @FastNative
-    @JvmName("nativeGotoFirstChildForByte")
-    private external fun nativeGotoFirstChildForByte(byte: UInt): Long
+    override fun close() = delete(self)
 
     @FastNative
     @JvmName("nativeGotoFirstChildForPoint")
@@ -191,5 +214,45 @@ actual class TreeCursor private constructor(
         @JvmStatic
         @CriticalNative
         private external fun delete(self: Long)
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeCurrentDepth(self: Long): Int
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeCurrentFieldId(self: Long): Short
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeCurrentDescendantIndex(self: Long): Int
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeGotoFirstChild(self: Long): Boolean
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeGotoLastChild(self: Long): Boolean
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeGotoParent(self: Long): Boolean
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeGotoNextSibling(self: Long): Boolean
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeGotoPreviousSibling(self: Long): Boolean
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeGotoDescendant(self: Long, index: Int)
+
+        @JvmStatic
+        @CriticalNative
+        private external fun nativeGotoFirstChildForByte(self: Long, byte: Int): Long
     }
 }
@@ -0,0 +1,190 @@
+package io.github.treesitter.ktreesitter
+
+import dalvik.annotation.optimization.CriticalNative
+import dalvik.annotation.optimization.FastNative
+
+/**
+ * Global settings and statistics of the native library.
+ *
+ * The [allocator] is chosen when the library is loaded, using the
+ * `ktreesitter.allocator` system property or the `KTREESITTER_ALLOCATOR`
+ * environment variable, which can be set to `tracking` or `pooled`.
+ *
+ * @since 0.26.0
+ */
+actual object TreeSitter {
+    /** The allocator that is used by the native library. */
+    @JvmStatic
+    actual val allocator: NativeAllocator
+        get() = NativeAllocator.entries[allocatorKind()]
+
+    /**
+     * The number of bytes that are currently allocated by the native library.
+     *
+     * This is always `0` when the [allocator] is [NativeAllocator.SYSTEM].
+     */
+    @JvmStatic
+    @get:JvmName("getAllocatedBytes")
+    actual val allocatedBytes: ULong
+        get() = nativeAllocatedBytes().toULong()
+
+    /**
+     * The highest number of bytes that have been allocated at once.
+     *
+     * This is always `0` when the [allocator] is [NativeAllocator.SYSTEM].
+     */
+    @JvmStatic
+    @get:JvmName("getPeakAllocatedBytes")
+    actual val peakAllocatedBytes: ULong
+        get() = nativePeakAllocatedBytes().toULong()
+
+    /**
+     * The number of memory blocks that are currently allocated by the native library.
+     *
+     * This is always `0` when the [allocator] is [NativeAllocator.SYSTEM].
+     */
+    @JvmStatic
+    @get:JvmName("getAllocationCount")
+    actual val allocationCount: ULong
+        get() = nativeAllocationCount().toULong()
+
+    /**
+     * Get the native memory that is held by the live parsers, trees and queries.
+     */
+    @JvmStatic
+    actual fun nativeMemoryStats() = NativeMemoryStats(
+        objectStats(OBJECT_PARSER),
+        objectStats(OBJECT_TREE),
+        objectStats(OBJECT_QUERY)
+    )
+
+    /**
+     * Get the number of bytes of native memory that are held by the given trees.
+     *
+     * Unlike the sum of their [sizes][Tree.nativeSizeBytes],
+     * subtrees that are shared between the trees are only counted once.
+     */
+    @JvmStatic
+    actual fun nativeSizeBytes(trees: Collection<Tree>) =
+        nativeTreeSize(trees.map(Tree::self).toLongArray()).toULong()
+
+    /**
+     * Whether the counters of the bindings are incremented.
+     *
+     * The counters measure the [JNI calls][jniCalls] into the cursor and query
+     * functions and the [nodes][nodesMarshaled] and [other objects][objectsMarshaled]
+     * that are marshaled into the JVM. They are disabled by default, in which
+     * case they cost a single branch, and are shared by all the threads.
+     *
+     * @since 0.26.0
+     */
+    @JvmStatic
+    var countersEnabled: Boolean
+        get() = nativeCountersEnabled()
+        set(value) = nativeSetCountersEnabled(value)
+
+    /**
+     * The number of calls into the native cursor and query functions.
+     *
+     * @see countersEnabled
+     * @since 0.26.0
+     */
+    @JvmStatic
+    @get:JvmName("getJniCalls")
+    val jniCalls: ULong
+        get() = nativeCounter(COUNTER_JNI_CALLS).toULong()
+
+    /**
+     * The number of nodes that have been marshaled into the JVM.
+     *
+     * @see countersEnabled
+     * @since 0.26.0
+     */
+    @JvmStatic
+    @get:JvmName("getNodesMarshaled")
+    val nodesMarshaled: ULong
+        get() = nativeCounter(COUNTER_NODES).toULong()
+
+    /**
+     * The number of points, ranges, captures and matches
+     * that have been marshaled into the JVM.
+     *
+     * @see countersEnabled
+     * @since 0.26.0
+     */
+    @JvmStatic
+    @get:JvmName("getObjectsMarshaled")
+    val objectsMarshaled: ULong
+        get() = nativeCounter(COUNTER_OBJECTS).toULong()
+
+    /**
+     * Set all the counters back to `0`.
+     *
+     * @see countersEnabled
+     * @since 0.26.0
+     */
+    @JvmStatic
+    @CriticalNative
+    external fun resetCounters()
+
+    private fun objectStats(kind: Int) = NativeMemoryStats.ObjectStats(
+        nativeLiveObjects(kind).toULong(),
+        nativeObjectBytes(kind).toULong()
+    )
+
+    @JvmStatic
+    @CriticalNative
+    private external fun allocatorKind(): Int
+
+    @JvmStatic
+    @CriticalNative
+    private external fun nativeAllocatedBytes(): Long
+
+    @JvmStatic
+    @CriticalNative
+    private external fun nativePeakAllocatedBytes(): Long
+
+    @JvmStatic
+    @CriticalNative
+    private external fun nativeAllocationCount(): Long
+
+    @JvmStatic
+    @CriticalNative
+    private external fun nativeLiveObjects(kind: Int): Long
+
+    @JvmStatic
+    @CriticalNative
+    private external fun nativeObjectBytes(kind: Int): Long
+
+    @JvmStatic
+    @FastNative
+    private external fun nativeTreeSize(trees: LongArray): Long
+
+    @JvmStatic
+    @CriticalNative
+    private external fun nativeCountersEnabled(): Boolean
+
+    @JvmStatic
+    @CriticalNative
+    private external fun nativeSetCountersEnabled(enabled: Boolean)
+
+    @JvmStatic
+    @CriticalNative
+    private external fun nativeCounter(kind: Int): Long
+
+    private const val OBJECT_PARSER = 0
+
+    private const val OBJECT_TREE = 1
+
+    private const val OBJECT_QUERY = 2
+
+    private const val COUNTER_JNI_CALLS = 0
+
+    private const val COUNTER_NODES = 1
+
+    private const val COUNTER_OBJECTS = 2
+
+    init {
+        System.loadLibrary("ktreesitter")
+    }
+}
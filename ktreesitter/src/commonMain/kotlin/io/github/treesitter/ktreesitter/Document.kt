@@ -0,0 +1,114 @@
+package io.github.treesitter.ktreesitter
+
+import kotlin.jvm.JvmName
+
+/**
+ * A text document that keeps a syntax tree in sync with its edits.
+ *
+ * The text is stored in chunks, so editing it does not copy the whole document,
+ * and the [InputEdit] of every edit is computed and applied to the current tree.
+ * The document is only parsed again when its [tree] is requested, and the
+ * parser reads the chunks directly instead of a single string.
+ *
+ * The byte offsets and points of the document are those of the text that the
+ * parser reads, which is UTF-8 on native platforms and modified UTF-8 on the JVM.
+ *
+ * Documents are not thread safe.
+ *
+ * @constructor Create a new document with the given [parser] and initial [text].
+ * @since 0.26.0
+ */
+class Document(val parser: Parser, text: CharSequence = "") {
+    private val rope = TextRope(text)
+
+    private var currentTree: Tree? = null
+
+    private var isStale = true
+
+    /** The length of the document in UTF-16 characters. */
+    val length: Int
+        get() = rope.length
+
+    /** The length of the document in bytes. */
+    @get:JvmName("byteLength")
+    val byteLength: UInt
+        get() = rope.byteLength.toUInt()
+
+    /**
+     * The syntax tree of the document.
+     *
+     * If the document has been edited since the last parse, it is parsed again,
+     * reusing the unchanged parts of the previous tree. Trees that were previously
+     * returned are edited along with the document, so [copy][Tree.copy] them
+     * if you need a snapshot of an earlier version.
+     *
+     * @throws [IllegalStateException]
+     *  If the parser does not have a [language][Parser.language] assigned.
+     * @throws [MemoryLimitExceededException]
+     *  If the [memory limit][Parser.memoryLimitBytes] of the parser is exceeded.
+     */
+    val tree: Tree
+        get() {
+            val tree = currentTree
+            if (tree != null && !isStale) return tree
+            return parser.parse(InputEncoding.UTF_8, tree) { byte, _ ->
+                rope.read(byte.toInt())
+            }.also {
+                currentTree = it
+                isStale = false
+            }
+        }
+
+    /**
+     * Replace the UTF-16 characters between [startIndex] and [endIndex] with the given [text].
+     *
+     * @return The edit that was applied to the syntax tree.
+     * @throws [IndexOutOfBoundsException] If the range is not within the document.
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun edit(startIndex: Int, endIndex: Int, text: CharSequence): InputEdit {
+        if (startIndex < 0 || startIndex > endIndex || endIndex > length) {
+            throw IndexOutOfBoundsException(
+                "Range $startIndex..$endIndex is out of bounds for length $length"
+            )
+        }
+        val start = rope.position(startIndex)
+        val oldEnd = rope.position(endIndex)
+        rope.replace(startIndex, endIndex, text)
+        val newEnd = rope.position(startIndex + text.length)
+        val edit = InputEdit(
+            start.byte,
+            oldEnd.byte,
+            newEnd.byte,
+            start.point,
+            oldEnd.point,
+            newEnd.point
+        )
+        currentTree?.edit(edit)
+        isStale = true
+        return edit
+    }
+
+    /**
+     * Replace the bytes between [startByte] and [endByte] with the given [text].
+     *
+     * @return The edit that was applied to the syntax tree.
+     * @throws [IndexOutOfBoundsException] If the range is not within the document.
+     * @throws [IllegalArgumentException] If an offset is not at a character boundary.
+     */
+    @JvmName("editBytes")
+    @Throws(IndexOutOfBoundsException::class, IllegalArgumentException::class)
+    fun editBytes(startByte: UInt, endByte: UInt, text: CharSequence): InputEdit {
+        if (startByte > endByte || endByte > byteLength) {
+            throw IndexOutOfBoundsException(
+                "Range $startByte..$endByte is out of bounds for length $byteLength"
+            )
+        }
+        return edit(rope.index(startByte.toInt()), rope.index(endByte.toInt()), text)
+    }
+
+    /** Get the full text of the document. */
+    fun text(): String = rope.toString()
+
+    override fun toString() = "Document(length=$length, language=${parser.language})"
+}
@@ -11,3 +11,32 @@ data class InputEdit(
     @get:JvmName("oldEndPoint") val oldEndPoint: Point,
     @get:JvmName("newEndPoint") val newEndPoint: Point
 )
+
+/** Pack the edits into an array with nine integers per edit, in field order. */
+internal fun List<InputEdit>.pack(): IntArray {
+    val packed = IntArray(size * 9)
+    forEachIndexed { i, edit ->
+        val offset = i * 9
+        packed[offset] = edit.startByte.toInt()
+        packed[offset + 1] = edit.oldEndByte.toInt()
+        packed[offset + 2] = edit.newEndByte.toInt()
+        packed[offset + 3] = edit.startPoint.row.toInt()
+        packed[offset + 4] = edit.startPoint.column.toInt()
+        packed[offset + 5] = edit.oldEndPoint.row.toInt()
+        packed[offset + 6] = edit.oldEndPoint.column.toInt()
+        packed[offset + 7] = edit.newEndPoint.row.toInt()
+        packed[offset + 8] = edit.newEndPoint.column.toInt()
+    }
+    return packed
+}
+
+/**
+ * Get the offset of the given byte after the edit.
+ *
+ * Offsets that were inside the replaced text are moved to the start of the edit.
+ */
+internal fun InputEdit.shift(byte: UInt) = when {
+    byte >= oldEndByte -> byte - oldEndByte + newEndByte
+    byte > startByte -> startByte
+    else -> byte
+}
@@ -0,0 +1,180 @@
+package io.github.treesitter.ktreesitter
+
+import kotlin.concurrent.atomics.AtomicReference
+import kotlin.concurrent.atomics.ExperimentalAtomicApi
+
+/**
+ * A registry of languages, which are looked up by name or by file extension
+ * and are only loaded the first time that they are requested.
+ *
+ * Registering a grammar library does not load it, so that a registry can
+ * describe every supported language without paying for the ones that are
+ * never used. Once loaded, a language is cached for the lifetime of the registry.
+ *
+ * The registry is thread safe. Lookups never block, and if two threads request
+ * the same language before it has been cached, both of them load it, which
+ * returns the same language since a library is only loaded once.
+ *
+ * #### Example
+ *
+ * ```kotlin
+ * val registry = LanguageRegistry()
+ * registry.registerLibrary("java", "/usr/lib/libtree-sitter-java.so", listOf("java"))
+ * val language = registry.forPath("src/Main.java")
+ * ```
+ *
+ * @since 0.26.0
+ */
+@OptIn(ExperimentalAtomicApi::class)
+class LanguageRegistry {
+    private val state = AtomicReference(State(emptyMap(), emptyMap()))
+
+    /** The names of the registered languages. */
+    val names: Set<String>
+        get() = state.load().entries.keys
+
+    /**
+     * Register a language that is created by the given [loader]
+     * the first time that it is requested.
+     *
+     * If a language with the same name was already registered, it is replaced.
+     * If an extension was already registered, it refers to the new language.
+     *
+     * @param extensions The file extensions of the language, without a leading dot.
+     */
+    fun register(
+        name: String,
+        extensions: Collection<String> = emptyList(),
+        loader: () -> Language
+    ) {
+        val entry = Entry(extensions.map { it.removePrefix(".") }, loader)
+        while (true) {
+            val current = state.load()
+            val byExtension = current.extensions.filterValues { it != name }.toMutableMap()
+            entry.extensions.associateWithTo(byExtension) { name }
+            val next = State(current.entries + (name to entry), byExtension)
+            if (state.compareAndSet(current, next)) return
+        }
+    }
+
+    /**
+     * Register a language that has already been created.
+     *
+     * @param extensions The file extensions of the language, without a leading dot.
+     */
+    fun register(name: String, language: Language, extensions: Collection<String> = emptyList()) {
+        register(name, extensions) { language }
+    }
+
+    /**
+     * Register a language that is [loaded][Language.load] from the
+     * shared library at the given [path] the first time that it is requested.
+     *
+     * @param extensions The file extensions of the language, without a leading dot.
+     * @param symbolName The name of the language function,
+     *  which is derived from the file name if `null`.
+     */
+    fun registerLibrary(
+        name: String,
+        path: String,
+        extensions: Collection<String> = emptyList(),
+        symbolName: String? = null
+    ) {
+        register(name, extensions) { Language.load(path, symbolName) }
+    }
+
+    /**
+     * Remove the language with the given name and its extensions.
+     *
+     * @return `false` if the language was not registered.
+     */
+    fun unregister(name: String): Boolean {
+        while (true) {
+            val current = state.load()
+            if (name !in current.entries) return false
+            val next = State(
+                current.entries - name,
+                current.extensions.filterValues { it != name }
+            )
+            if (state.compareAndSet(current, next)) return true
+        }
+    }
+
+    /** Check if a language with the given name is registered. */
+    operator fun contains(name: String) = name in state.load().entries
+
+    /** Check if the language with the given name has already been loaded. */
+    fun isLoaded(name: String) = state.load().entries[name]?.language?.load() != null
+
+    /**
+     * Get the language with the given name, loading it if necessary.
+     *
+     * @return The language, or `null` if it is not registered.
+     * @throws [IllegalArgumentException] If the language could not be loaded.
+     */
+    @Throws(IllegalArgumentException::class)
+    operator fun get(name: String): Language? = state.load().entries[name]?.get()
+
+    /**
+     * Get the language of the given file extension, loading it if necessary.
+     *
+     * @return The language, or `null` if no language has this extension.
+     * @throws [IllegalArgumentException] If the language could not be loaded.
+     */
+    @Throws(IllegalArgumentException::class)
+    fun forExtension(extension: String): Language? {
+        val current = state.load()
+        val name = current.extensions[extension.removePrefix(".")] ?: return null
+        return current.entries[name]?.get()
+    }
+
+    /**
+     * Get the language of the file at the given path, loading it if necessary.
+     *
+     * Compound extensions are matched before simple ones, so
+     * `index.d.ts` is matched with `d.ts` before `ts`.
+     *
+     * @return The language, or `null` if no language matches the file name.
+     * @throws [IllegalArgumentException] If the language could not be loaded.
+     */
+    @Throws(IllegalArgumentException::class)
+    fun forPath(path: String): Language? {
+        val current = state.load()
+        val fileName = path.substring(path.lastIndexOfAny(charArrayOf('/', '\\')) + 1)
+        var dot = fileName.indexOf('.')
+        while (dot != -1) {
+            val name = current.extensions[fileName.substring(dot + 1)]
+            if (name != null) return current.entries[name]?.get()
+            dot = fileName.indexOf('.', dot + 1)
+        }
+        return null
+    }
+
+    override fun toString() = "LanguageRegistry(names=$names)"
+
+    private class State(val entries: Map<String, Entry>, val extensions: Map<String, String>)
+
+    private class Entry(val extensions: List<String>, val loader: () -> Language) {
+        val language = AtomicReference<Language?>(null)
+
+        fun get(): Language {
+            language.load()?.let { return it }
+            val loaded = loader()
+            return if (language.compareAndSet(null, loaded)) loaded else language.load()!!
+        }
+    }
+}
+
+/**
+ * Derive the name of the language function of a grammar library from its path.
+ *
+ * For example, `libtree-sitter-c-sharp.so` defines `tree_sitter_c_sharp`.
+ */
+internal fun languageSymbolName(path: String): String {
+    val fileName = path.substring(path.lastIndexOfAny(charArrayOf('/', '\\')) + 1)
+    val name = fileName.substringBefore('.')
+        .removePrefix("lib")
+        .removePrefix("tree-sitter-")
+        .removePrefix("tree_sitter_")
+    return "tree_sitter_" + name.replace('-', '_')
+}
@@ -0,0 +1,247 @@
+package io.github.treesitter.ktreesitter
+
+import kotlin.jvm.JvmName
+
+/**
+ * An index of the lines of a text, which converts between byte offsets,
+ * [points][Point], UTF-16 character indices and UTF-16 [positions][Position].
+ *
+ * Lines are separated by `\n`, like the rows of a [Point]. Byte offsets are
+ * those of the text that the parser reads, so that they match the offsets
+ * of the [nodes][Node] in a syntax tree that was parsed from the same text.
+ *
+ * Locating a line takes logarithmic time, and converting a column only
+ * has to walk the characters of the line if it contains non-ASCII text.
+ *
+ * @constructor Index the lines of the given [text] with a single scan.
+ * @since 0.26.0
+ */
+class LineIndex(text: CharSequence) {
+    private var text: CharSequence = text
+
+    /** The character index of the start of every line. */
+    private var lineStarts = IntArray(16)
+
+    /** The byte offset of the start of every line. */
+    private var lineBytes = IntArray(16)
+
+    /** Whether every line consists only of ASCII characters. */
+    private var asciiLines = BooleanArray(16)
+
+    /** The number of lines in the text. */
+    var lineCount: Int = 0
+        private set
+
+    init {
+        lineCount = scan(0, 0, 0, text.length) + 1
+    }
+
+    /** A position in a text, as a line and a UTF-16 character offset in that line. */
+    data class Position(
+        @get:JvmName("line") val line: UInt,
+        @get:JvmName("character") val character: UInt
+    )
+
+    /** Get the point of the given byte offset. */
+    @JvmName("pointAt")
+    fun pointAt(byte: UInt): Point {
+        val line = lineOfByte(byte.toInt())
+        return Point(line.toUInt(), byte - lineBytes[line].toUInt())
+    }
+
+    /** Get the byte offset of the given point. */
+    fun byteAt(point: Point): UInt {
+        val line = point.row.toInt().coerceIn(0, lineCount - 1)
+        return minOf(lineBytes[line].toUInt() + point.column, lineEndByte(line).toUInt())
+    }
+
+    /** Get the UTF-16 character index of the given byte offset. */
+    @JvmName("indexAt")
+    fun indexAt(byte: UInt): Int {
+        val line = lineOfByte(byte.toInt())
+        return lineStarts[line] + characterOf(line, byte.toInt() - lineBytes[line])
+    }
+
+    /** Get the byte offset of the given UTF-16 character index. */
+    fun byteAt(index: Int): UInt {
+        val line = lineOfIndex(index)
+        return (lineBytes[line] + columnOf(line, index - lineStarts[line])).toUInt()
+    }
+
+    /** Get the position of the given byte offset. */
+    @JvmName("positionAt")
+    fun positionAt(byte: UInt): Position {
+        val line = lineOfByte(byte.toInt())
+        val character = characterOf(line, byte.toInt() - lineBytes[line])
+        return Position(line.toUInt(), character.toUInt())
+    }
+
+    /** Get the position of the given point. */
+    fun positionAt(point: Point) = positionAt(byteAt(point))
+
+    /** Get the byte offset of the given position. */
+    fun byteAt(position: Position): UInt {
+        val line = position.line.toInt().coerceIn(0, lineCount - 1)
+        val length = lineEnd(line) - lineStarts[line]
+        val character = minOf(position.character.toInt(), length)
+        return (lineBytes[line] + columnOf(line, character)).toUInt()
+    }
+
+    /** Get the point of the given position. */
+    fun pointAt(position: Position) = pointAt(byteAt(position))
+
+    /** Get the position of the start of the given node. */
+    fun startPosition(node: Node) = positionAt(node.startByte)
+
+    /** Get the position of the end of the given node. */
+    fun endPosition(node: Node) = positionAt(node.endByte)
+
+    /**
+     * Update the index after the characters between [startIndex] and [oldEndIndex]
+     * were replaced with the characters between [startIndex] and [newEndIndex]
+     * of the [new text][newText]. Only the lines of the edited range are scanned.
+     *
+     * @return The edit that should be applied to the syntax tree.
+     * @throws [IndexOutOfBoundsException] If the range is not within the text.
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun edit(
+        newText: CharSequence,
+        startIndex: Int,
+        oldEndIndex: Int,
+        newEndIndex: Int
+    ): InputEdit {
+        if (startIndex < 0 || startIndex > oldEndIndex || oldEndIndex > text.length ||
+            startIndex > newEndIndex || newEndIndex > newText.length
+        ) {
+            throw IndexOutOfBoundsException(
+                "Edit $startIndex..$oldEndIndex -> $startIndex..$newEndIndex is out of bounds"
+            )
+        }
+
+        val startByte = byteAt(startIndex)
+        val oldEndByte = byteAt(oldEndIndex)
+        val startPoint = pointAt(startByte)
+        val oldEndPoint = pointAt(oldEndByte)
+        val startLine = startPoint.row.toInt()
+        val oldEndLine = oldEndPoint.row.toInt()
+
+        // Keep the lines after the edit, so that they can be shifted.
+        val tailCount = lineCount - oldEndLine - 1
+        val tailStarts = lineStarts.copyOfRange(oldEndLine + 1, lineCount)
+        val tailBytes = lineBytes.copyOfRange(oldEndLine + 1, lineCount)
+        val tailAscii = asciiLines.copyOfRange(oldEndLine + 1, lineCount)
+
+        // Scan the edited lines, up to the start of the first line after the edit.
+        text = newText
+        val charDelta = newEndIndex - oldEndIndex
+        val scanEnd = if (tailCount > 0) tailStarts[0] + charDelta else newText.length
+        val lastLine = scan(startLine, lineStarts[startLine], lineBytes[startLine], scanEnd)
+        if (tailCount > 0) {
+            val byteDelta = lineBytes[lastLine] - tailBytes[0]
+            ensureCapacity(lastLine + tailCount)
+            for (i in 0 until tailCount) {
+                lineStarts[lastLine + i] = tailStarts[i] + charDelta
+                lineBytes[lastLine + i] = tailBytes[i] + byteDelta
+                asciiLines[lastLine + i] = tailAscii[i]
+            }
+            lineCount = lastLine + tailCount
+        } else {
+            lineCount = lastLine + 1
+        }
+
+        val newEndByte = byteAt(newEndIndex)
+        return InputEdit(
+            startByte,
+            oldEndByte,
+            newEndByte,
+            startPoint,
+            oldEndPoint,
+            pointAt(newEndByte)
+        )
+    }
+
+    override fun toString() = "LineIndex(lineCount=$lineCount)"
+
+    /**
+     * Scan the characters between [start] and [end], which
+     * is the start of the given [line], and record their lines.
+     *
+     * @return The index of the last line, which is still open at [end].
+     */
+    private fun scan(line: Int, start: Int, startByte: Int, end: Int): Int {
+        var current = line
+        var byte = startByte
+        var ascii = true
+        ensureCapacity(current + 1)
+        lineStarts[current] = start
+        lineBytes[current] = byte
+        for (index in start until end) {
+            val char = text[index]
+            val size = char.encodedSize()
+            byte += size
+            if (size != 1) ascii = false
+            if (char == '\n') {
+                asciiLines[current++] = ascii
+                ensureCapacity(current + 1)
+                lineStarts[current] = index + 1
+                lineBytes[current] = byte
+                ascii = true
+            }
+        }
+        asciiLines[current] = ascii
+        return current
+    }
+
+    private fun ensureCapacity(capacity: Int) {
+        if (capacity <= lineStarts.size) return
+        val size = maxOf(capacity, lineStarts.size * 2)
+        lineStarts = lineStarts.copyOf(size)
+        lineBytes = lineBytes.copyOf(size)
+        asciiLines = asciiLines.copyOf(size)
+    }
+
+    private fun lineOfIndex(index: Int) = lineOf(lineStarts, index.coerceIn(0, text.length))
+
+    private fun lineOfByte(byte: Int) = lineOf(lineBytes, byte)
+
+    private fun lineOf(starts: IntArray, value: Int): Int {
+        var low = 0
+        var high = lineCount - 1
+        while (low < high) {
+            val mid = (low + high + 1) ushr 1
+            if (starts[mid] <= value) low = mid else high = mid - 1
+        }
+        return low
+    }
+
+    /** Get the character index of the end of the line, excluding its line break. */
+    private fun lineEnd(line: Int): Int {
+        if (line + 1 == lineCount) return text.length
+        return lineStarts[line + 1] - 1
+    }
+
+    private fun lineEndByte(line: Int): Int {
+        if (line + 1 < lineCount) return lineBytes[line + 1] - 1
+        return lineBytes[line] + columnOf(line, text.length - lineStarts[line])
+    }
+
+    /** Convert a character offset in the line to a byte offset. */
+    private fun columnOf(line: Int, character: Int): Int {
+        if (asciiLines[line]) return character
+        var column = 0
+        val start = lineStarts[line]
+        for (i in start until start + character) column += text[i].encodedSize()
+        return column
+    }
+
+    /** Convert a byte offset in the line to a character offset. */
+    private fun characterOf(line: Int, column: Int): Int {
+        if (asciiLines[line]) return minOf(column, lineEnd(line) - lineStarts[line])
+        var byte = 0
+        var index = lineStarts[line]
+        val end = lineEnd(line)
+        while (index < end && byte < column) byte += text[index++].encodedSize()
+        return index - lineStarts[line]
+    }
+}
@@ -0,0 +1,46 @@
+package io.github.treesitter.ktreesitter
+
+/**
+ * A buffer that records the log messages of a [parser][Parser.logBuffer] in native memory.
+ *
+ * Unlike a [logger][Parser.logger], which calls into Kotlin for every message,
+ * the buffer copies each message into a ring of [capacity] bytes without leaving
+ * native code, and drops the oldest messages once it is full. The messages
+ * can then be [drained][drain] in bulk, for example only when a parse fails,
+ * so logging can be left enabled at a low cost.
+ *
+ * A buffer must only be used by one parser at a time, and it must not be drained
+ * while that parser is parsing. Messages longer than the capacity are truncated.
+ *
+ * @constructor Create a new buffer that records the messages of the given [types].
+ * @throws [IllegalArgumentException]
+ *  If the capacity is less than `64` bytes or if there are no types.
+ * @since 0.26.0
+ */
+expect class LogBuffer @Throws(IllegalArgumentException::class) constructor(
+    capacity: Int = 65536,
+    types: Set<Parser.LogType> = setOf(Parser.LogType.LEX, Parser.LogType.PARSE)
+) {
+    /** The capacity of the buffer in bytes. */
+    val capacity: Int
+
+    /** The types of messages that are recorded. */
+    val types: Set<Parser.LogType>
+
+    /** The number of messages in the buffer. */
+    val size: Int
+
+    /** The number of messages that were dropped to make room since the buffer was cleared. */
+    val droppedCount: Long
+
+    /**
+     * Remove every message from the buffer, from the oldest to the newest,
+     * and pass it to the given [function].
+     *
+     * @return The number of messages that were drained.
+     */
+    fun drain(function: LogFunction): Int
+
+    /** Remove every message from the buffer and reset the [dropped count][droppedCount]. */
+    fun clear()
+}
@@ -0,0 +1,9 @@
+package io.github.treesitter.ktreesitter
+
+/**
+ * An exception that is thrown when a [Parser] or a [QueryCursor]
+ * allocates more native memory than its memory limit allows.
+ *
+ * @since 0.26.0
+ */
+class MemoryLimitExceededException(message: String) : IllegalStateException(message)
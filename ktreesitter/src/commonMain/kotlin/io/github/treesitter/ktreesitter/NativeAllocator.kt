@@ -0,0 +1,20 @@
+package io.github.treesitter.ktreesitter
+
+/**
+ * The allocator that the native library uses for its memory.
+ *
+ * @since 0.26.0
+ */
+enum class NativeAllocator {
+    /** The system allocator, without any bookkeeping. */
+    SYSTEM,
+
+    /** The system allocator, wrapped in order to keep track of the allocated bytes. */
+    TRACKING,
+
+    /**
+     * A tracking allocator that serves small blocks from
+     * size-class pools with a free list cache per thread.
+     */
+    POOLED
+}
@@ -0,0 +1,35 @@
+package io.github.treesitter.ktreesitter
+
+import kotlin.jvm.JvmName
+
+/**
+ * The native memory that is held by the live objects of the library.
+ *
+ * The bytes are attributed to each object by the allocator, so they are
+ * only counted when the [allocator][TreeSitter.allocator] tracks memory.
+ * The nodes of a syntax tree are attributed to the tree that created them,
+ * even if they are later shared with newer trees via incremental parsing.
+ *
+ * @property parsers The statistics of the live [Parser] objects.
+ * @property trees The statistics of the live [Tree] objects.
+ * @property queries The statistics of the live [Query] objects.
+ * @since 0.26.0
+ */
+@ConsistentCopyVisibility
+data class NativeMemoryStats internal constructor(
+    @get:JvmName("parsers") val parsers: ObjectStats,
+    @get:JvmName("trees") val trees: ObjectStats,
+    @get:JvmName("queries") val queries: ObjectStats
+) {
+    /**
+     * The native memory that is held by the live objects of a single type.
+     *
+     * @property liveObjects The number of objects whose native memory has not been freed.
+     * @property bytes The number of bytes that are attributed to the objects.
+     */
+    @ConsistentCopyVisibility
+    data class ObjectStats internal constructor(
+        @get:JvmName("liveObjects") val liveObjects: ULong,
+        @get:JvmName("bytes") val bytes: ULong
+    )
+}
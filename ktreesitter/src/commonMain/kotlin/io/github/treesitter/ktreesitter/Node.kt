@@ -253,6 +253,19 @@ expect class Node {
     /** Get the S-expression of the node. */
     fun sexp(): String
 
+    /**
+     * Count the nodes of each symbol in the subtree of this node, including itself.
+     *
+     * The result is indexed by the [symbol] of the nodes and has the size of the
+     * [symbol count][Language.symbolCount] of the language. Only the visible nodes,
+     * which are the ones that queries can match, are counted in a single native pass.
+     *
+     * @see QueryPlanner
+     * @since 0.26.0
+     */
+    @OptIn(ExperimentalUnsignedTypes::class)
+    fun symbolHistogram(): UIntArray
+
     override fun equals(other: Any?): Boolean
 
     override fun hashCode(): Int
@@ -0,0 +1,151 @@
+package io.github.treesitter.ktreesitter
+
+import kotlin.time.Duration
+import kotlin.time.Duration.Companion.milliseconds
+import kotlin.time.TimeSource
+
+/**
+ * A scheduler that shares parsing time between many documents.
+ *
+ * Every call to [runSlice] parses one [task][Task] for at most [sliceDuration],
+ * after which the parse is halted and later resumed where it left off. Tasks with
+ * a higher [priority][Task.priority] always run first, and among tasks of the same
+ * priority, the one that has used the least time runs next, so that small documents
+ * are not stuck behind a huge one.
+ *
+ * The scheduler is not thread safe; it should be driven from a single thread.
+ *
+ * @constructor Create a new scheduler with the given [slice duration][sliceDuration].
+ * @since 0.26.0
+ */
+class ParseScheduler(sliceDuration: Duration = 5.milliseconds) {
+    private val tasks = ArrayList<Task>()
+
+    private var nextSequence = 0L
+
+    /**
+     * The maximum duration of a slice.
+     *
+     * @throws [IllegalArgumentException] If the duration is not positive.
+     */
+    var sliceDuration: Duration = sliceDuration
+        @Throws(IllegalArgumentException::class)
+        set(value) {
+            require(value.isPositive()) { "The slice duration must be positive" }
+            field = value
+        }
+
+    init {
+        this.sliceDuration = sliceDuration
+    }
+
+    /** The number of tasks that have not finished yet. */
+    val pendingTasks: Int
+        get() = tasks.size
+
+    /**
+     * Schedule a parse of the given [source] code.
+     *
+     * The [parser] must not be used for anything else until the task is done,
+     * since a halted parse can only be resumed by the same parser. The resulting
+     * tree is passed to [onComplete], and it does not hold the [source][Tree.text].
+     *
+     * @param oldTree A previous syntax tree, which must have been edited to match [source].
+     * @param priority The priority of the task, where higher priorities run first.
+     * @param onComplete A function that is called with the result once the task is done.
+     * @throws [IllegalArgumentException] If the parser is already used by another task.
+     */
+    @Throws(IllegalArgumentException::class)
+    fun submit(
+        parser: Parser,
+        source: CharSequence,
+        oldTree: Tree? = null,
+        priority: Int = 0,
+        onComplete: (Result<Tree>) -> Unit
+    ): Task {
+        require(tasks.none { it.parser === parser }) {
+            "The parser is already used by another task"
+        }
+        val task = Task(parser, TextRope(source), oldTree, priority, nextSequence++, onComplete)
+        tasks += task
+        return task
+    }
+
+    /**
+     * Run the next task for at most one slice.
+     *
+     * @return `true` if there are tasks that have not finished yet.
+     */
+    fun runSlice(): Boolean {
+        val task = tasks.minWithOrNull(ORDER) ?: return false
+        val start = TimeSource.Monotonic.markNow()
+        val deadline = start + sliceDuration
+        var halted = false
+        val result = runCatching {
+            task.parser.parse(InputEncoding.UTF_8, task.oldTree, { _, _ ->
+                deadline.hasPassedNow().also { halted = it }
+            }) { byte, _ -> task.rope.read(byte.toInt()) }
+        }
+        task.elapsed += start.elapsedNow()
+        task.slices += 1
+        if (!halted || result.isSuccess) {
+            tasks.remove(task)
+            task.isDone = true
+            task.onComplete(result)
+        }
+        return tasks.isNotEmpty()
+    }
+
+    /** Run slices until every task has finished. */
+    fun runUntilIdle() {
+        while (runSlice()) continue
+    }
+
+    override fun toString() =
+        "ParseScheduler(sliceDuration=$sliceDuration, pendingTasks=$pendingTasks)"
+
+    /** A parse that has been [submitted][submit] to a scheduler. */
+    inner class Task internal constructor(
+        internal val parser: Parser,
+        internal val rope: TextRope,
+        internal val oldTree: Tree?,
+        /** The priority of the task, which can be changed while it is pending. */
+        var priority: Int,
+        internal val sequence: Long,
+        internal val onComplete: (Result<Tree>) -> Unit
+    ) {
+        /** The total time that the task has spent parsing. */
+        var elapsed: Duration = Duration.ZERO
+            internal set
+
+        /** The number of slices that the task has run. */
+        var slices: Int = 0
+            internal set
+
+        /** Whether the task has completed or has been cancelled. */
+        var isDone: Boolean = false
+            internal set
+
+        /**
+         * Cancel the task and [reset][Parser.reset] its parser.
+         *
+         * The completion function is not called for cancelled tasks.
+         *
+         * @return `false` if the task was already done.
+         */
+        fun cancel(): Boolean {
+            if (isDone || !tasks.remove(this)) return false
+            isDone = true
+            parser.reset()
+            return true
+        }
+
+        override fun toString() = "Task(priority=$priority, slices=$slices, elapsed=$elapsed)"
+    }
+
+    private companion object {
+        val ORDER = compareByDescending<Task> { it.priority }
+            .thenBy { it.elapsed }
+            .thenBy { it.sequence }
+    }
+}
@@ -13,12 +13,26 @@ typealias ParseReadCallback = (byte: UInt, point: Point) -> CharSequence?
  * The first argument contains the current byte offset and the second
  * argument indicates whether the parser has encountered an error.
  *
- * If the function returns `false`, parsing will halt early.
+ * If the function returns `true`, parsing will halt early.
  *
  * @since 0.25.0
  */
 typealias ParseProgressCallback = (currentByteOffset: UInt, hasError: Boolean) -> Boolean
 
+/**
+ * A listener that is called during parsing, without boxing its arguments.
+ *
+ * @see Parser.progressListener
+ * @since 0.26.0
+ */
+fun interface ParseProgressListener {
+    /**
+     * Called with the current byte offset of the parser and whether
+     * it has encountered an error. Return `true` to halt parsing early.
+     */
+    fun onProgress(currentByteOffset: Int, hasError: Boolean): Boolean
+}
+
 /**
  * A function that logs parsing results.
  *
@@ -60,10 +74,83 @@ expect class Parser() {
     @Deprecated("Use the progressCallback in parse()")
     var timeoutMicros: ULong
 
+    /**
+     * The maximum number of bytes that a single parse
+     * may allocate, or `0` if there is no limit.
+     *
+     * When the limit is exceeded, parsing is halted and
+     * a [MemoryLimitExceededException] is thrown.
+     *
+     * Default: `0`
+     *
+     * @throws [IllegalStateException]
+     *  If a limit is set while the [allocator][TreeSitter.allocator] does not track memory.
+     * @since 0.26.0
+     */
+    @set:Throws(IllegalStateException::class)
+    var memoryLimitBytes: ULong
+
+    /**
+     * The number of bytes of native memory that are held by the parser,
+     * not including the syntax trees that it has produced.
+     *
+     * This is always `0` when the [allocator][TreeSitter.allocator] is [NativeAllocator.SYSTEM].
+     *
+     * @since 0.26.0
+     */
+    val nativeSizeBytes: ULong
+
+    /**
+     * A listener that can halt any parse, including the parses of strings.
+     *
+     * Unlike a [ParseProgressCallback], the listener receives unboxed arguments and is
+     * only called once every [progressIntervalBytes] or [progressIntervalMicros], so it
+     * is cheap enough to be kept around for cancellation. When it returns `true`,
+     * parsing is halted and can be resumed like a parse halted by a callback.
+     *
+     * @since 0.26.0
+     */
+    var progressListener: ParseProgressListener?
+
+    /**
+     * The number of bytes that must be parsed before
+     * the [progressListener] is called again.
+     *
+     * If both this and [progressIntervalMicros] are `0`, the listener is called
+     * every time the parser checks its progress. Otherwise, it is called as soon
+     * as either of the intervals has passed.
+     *
+     * Default: `0`
+     *
+     * @since 0.26.0
+     */
+    var progressIntervalBytes: UInt
+
+    /**
+     * The number of microseconds that must pass before
+     * the [progressListener] is called again.
+     *
+     * Default: `0`
+     *
+     * @see progressIntervalBytes
+     * @since 0.26.0
+     */
+    var progressIntervalMicros: ULong
+
     /** The logger that the parser will use during parsing. */
     @get:Deprecated("The logger can't be called directly.", level = DeprecationLevel.HIDDEN)
     var logger: LogFunction?
 
+    /**
+     * The buffer that records the log messages of the parser in native memory.
+     *
+     * A parser has either a [logger] or a log buffer,
+     * so setting one of them replaces the other.
+     *
+     * @since 0.26.0
+     */
+    var logBuffer: LogBuffer?
+
     /**
      * Parse a source code string and create a syntax tree.
      *
@@ -75,6 +162,7 @@ expect class Parser() {
      *
      * @throws [IllegalStateException]
      *  If the parser does not have a [language] assigned or if parsing was halted.
+     * @throws [MemoryLimitExceededException] If the [memory limit][memoryLimitBytes] is exceeded.
      */
     @Throws(IllegalStateException::class)
     fun parse(
@@ -94,6 +182,7 @@ expect class Parser() {
      *
      * @throws [IllegalStateException]
      *  If the parser does not have a [language] assigned or if parsing was halted.
+     * @throws [MemoryLimitExceededException] If the [memory limit][memoryLimitBytes] is exceeded.
      */
     @Throws(IllegalStateException::class)
     fun parse(
@@ -103,6 +192,27 @@ expect class Parser() {
         readCallback: ParseReadCallback
     ): Tree
 
+    /**
+     * Parse a new version of the source code of an old syntax tree.
+     *
+     * The changes between the [source text][Tree.text] of the old tree and [newSource]
+     * are computed and applied to a copy of the old tree, so that the unchanged parts
+     * of it can be reused without having to call [Tree.edit] manually. The old tree
+     * itself is left untouched. The edits are computed line by line and fall back
+     * to a single edit that spans all the changes when the versions differ too much.
+     * The old tree must have been parsed as [UTF-8][InputEncoding.UTF_8],
+     * and the new tree is parsed as UTF-8 as well.
+     *
+     * @throws [IllegalArgumentException]
+     *  If the old tree has no source text or was not parsed as UTF-8.
+     * @throws [IllegalStateException]
+     *  If the parser does not have a [language] assigned or if parsing was halted.
+     * @throws [MemoryLimitExceededException] If the [memory limit][memoryLimitBytes] is exceeded.
+     * @since 0.26.0
+     */
+    @Throws(IllegalArgumentException::class, IllegalStateException::class)
+    fun reparse(oldTree: Tree, newSource: String): Tree
+
     /**
      * Instruct the parser to start the next [parse] from the beginning.
      *
@@ -5,12 +5,26 @@ package io.github.treesitter.ktreesitter
  *
  * The argument contains the current byte offset.
  *
- * If the function returns `false`, the execution will halt early.
+ * If the function returns `true`, the execution will halt early.
  *
  * @since 0.25.0
  */
 typealias QueryProgressCallback = (currentByteOffset: UInt) -> Boolean
 
+/**
+ * A listener that is called while executing a query, without boxing its argument.
+ *
+ * @see QueryCursor.progressListener
+ * @since 0.26.0
+ */
+fun interface QueryProgressListener {
+    /**
+     * Called with the current byte offset of the cursor.
+     * Return `true` to halt the execution early.
+     */
+    fun onProgress(currentByteOffset: Int): Boolean
+}
+
 /**
  * A class that represents a set of patterns which match nodes in a syntax tree.
  *
@@ -20,6 +34,15 @@ typealias QueryProgressCallback = (currentByteOffset: UInt) -> Boolean
  * @throws [QueryError] If any error occurred while creating the query.
  */
 expect class Query @Throws(QueryError::class) constructor(language: Language, source: String) {
+    /**
+     * The number of bytes of native memory that are held by the query.
+     *
+     * This is always `0` when the [allocator][TreeSitter.allocator] is [NativeAllocator.SYSTEM].
+     *
+     * @since 0.26.0
+     */
+    val nativeSizeBytes: ULong
+
     /** The number of patterns in the query. */
     val patternCount: UInt
 
@@ -41,6 +64,9 @@ expect class Query @Throws(QueryError::class) constructor(language: Language, so
      */
     val stringValues: List<String>
 
+    /** The predicates of every pattern, indexed by the pattern index. */
+    internal val predicates: List<MutableList<QueryPredicate>>
+
     /**
      * Execute the query on the given [Node].
      *
@@ -36,6 +36,58 @@ expect class QueryCursor {
      */
     var maxStartDepth: UInt
 
+    /**
+     * The maximum number of bytes that a single execution
+     * of the query may allocate, or `0` if there is no limit.
+     *
+     * When the limit is exceeded, the execution is halted and iterating over
+     * the [matches] or [captures] throws a [MemoryLimitExceededException].
+     *
+     * Default: `0`
+     *
+     * @throws [IllegalStateException]
+     *  If a limit is set while the [allocator][TreeSitter.allocator] does not track memory.
+     * @since 0.26.0
+     */
+    @set:Throws(IllegalStateException::class)
+    var memoryLimitBytes: ULong
+
+    /**
+     * A listener that can halt the execution of the query.
+     *
+     * Unlike a [QueryProgressCallback], the listener receives an unboxed argument and is
+     * only called once every [progressIntervalBytes] or [progressIntervalMicros], so it
+     * is cheap enough to be kept around for cancellation.
+     *
+     * @since 0.26.0
+     */
+    var progressListener: QueryProgressListener?
+
+    /**
+     * The number of bytes that the cursor must advance
+     * before the [progressListener] is called again.
+     *
+     * If both this and [progressIntervalMicros] are `0`, the listener is called
+     * every time the cursor checks its progress. Otherwise, it is called as soon
+     * as either of the intervals has passed.
+     *
+     * Default: `0`
+     *
+     * @since 0.26.0
+     */
+    var progressIntervalBytes: UInt
+
+    /**
+     * The number of microseconds that must pass before
+     * the [progressListener] is called again.
+     *
+     * Default: `0`
+     *
+     * @see progressIntervalBytes
+     * @since 0.26.0
+     */
+    var progressIntervalMicros: ULong
+
     /**
      * The range of bytes in which the query will be executed.
      *
@@ -72,6 +124,18 @@ expect class QueryCursor {
      */
     val didExceedMatchLimit: Boolean
 
+    /**
+     * The profile that records the statistics of every pattern
+     * that is matched by this cursor, or `null` if it is not profiled.
+     *
+     * Default: `null`
+     *
+     * @throws [IllegalArgumentException] If the profile was created for a different query.
+     * @since 0.26.0
+     */
+    @set:Throws(IllegalArgumentException::class)
+    var profile: QueryProfile?
+
     /**
      * Iterate over all the matches in the order that they were found.
      *
@@ -0,0 +1,361 @@
+package io.github.treesitter.ktreesitter
+
+/**
+ * A planner that skips the patterns of a query which cannot match a node.
+ *
+ * When the planner is created, it finds the node types that each pattern requires:
+ * the named and anonymous nodes of the pattern which are not optional and are not
+ * only part of some alternatives. Before the query is executed on a node, the
+ * [histogram][Node.symbolHistogram] of its subtree is computed in a single native
+ * walk, and the patterns that require a missing node type are skipped. This makes
+ * large queries much cheaper on files that only use a few of the constructs they
+ * look for.
+ *
+ * Since [disabled][Query.disablePattern] patterns cannot be enabled again, the
+ * planner executes a copy of the query in which the skipped patterns are disabled.
+ * The copies are cached by their skipped patterns, and every match keeps the
+ * [pattern index][QueryMatch.patternIndex] that it has in the original [query].
+ *
+ * Creating a copy compiles the whole query again, which can cost more than
+ * executing it. A copy is therefore only created when at least [skipThreshold]
+ * of the enabled patterns are skipped. Otherwise, a cached copy that skips a
+ * subset of the patterns is executed, or the original query if there is none.
+ *
+ * A planner must not be used by multiple threads concurrently.
+ *
+ * #### Example
+ *
+ * ```kotlin
+ * val planner = QueryPlanner(language, source)
+ * val matches = planner(tree.rootNode)?.matches() ?: emptySequence()
+ * ```
+ *
+ * @constructor Create a new planner for a query.
+ * @param language The language of the query.
+ * @param source The source code of the query.
+ * @param cacheSize The maximum number of copies of the query that are kept.
+ * @param skipThreshold The minimum fraction of the enabled patterns that must be
+ *  skipped in order to create a copy of the query.
+ * @throws [QueryError] If any error occurred while creating the query.
+ * @since 0.26.0
+ */
+@OptIn(ExperimentalUnsignedTypes::class)
+class QueryPlanner @Throws(QueryError::class) constructor(
+    val language: Language,
+    private val source: String,
+    private val cacheSize: Int = 8,
+    private val skipThreshold: Double = 0.5
+) {
+    /** The query with all of its patterns. */
+    val query = Query(language, source)
+
+    private val requirements: List<UShortArray>
+
+    private val disabledPatterns = BooleanArray(query.patternCount.toInt())
+
+    private val cache = LinkedHashMap<List<UInt>, Query>()
+
+    init {
+        require(cacheSize >= 0) { "The cache size must not be negative" }
+        require(skipThreshold in 0.0..1.0) { "The skip threshold must be between 0 and 1" }
+        val bytes = source.encodeToByteArray()
+        requirements = List(query.patternCount.toInt()) { index ->
+            val start = query.startByteForPattern(index.toUInt()).toInt()
+            val end = query.endByteForPattern(index.toUInt()).toInt()
+            PatternScanner(bytes, start, end).scan().mapNotNull { name ->
+                language.symbolForName(name.value, name.isNamed).takeIf {
+                    it != 0.toUShort() && !language.isSupertype(it)
+                }
+            }.distinct().toUShortArray()
+        }
+    }
+
+    /**
+     * Get the node types that the given pattern requires.
+     *
+     * @throws [IndexOutOfBoundsException]
+     *  If the index exceeds the [pattern count][Query.patternCount].
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun requiredSymbols(index: UInt): UShortArray {
+        if (index >= query.patternCount)
+            throw IndexOutOfBoundsException("Pattern index $index is out of bounds")
+        return requirements[index.toInt()].copyOf()
+    }
+
+    /** Get the indices of the enabled patterns that can match the given node. */
+    fun possiblePatterns(node: Node): List<UInt> {
+        val possible = possiblePatterns(node.symbolHistogram())
+        return possible.indices.mapNotNull { if (possible[it]) it.toUInt() else null }
+    }
+
+    /**
+     * Execute the query on the given [Node], skipping the patterns that cannot match it.
+     *
+     * @return A query cursor, or `null` if none of the patterns can match the node.
+     */
+    operator fun invoke(
+        node: Node,
+        progressCallback: QueryProgressCallback? = null
+    ): QueryCursor? {
+        val possible = possiblePatterns(node.symbolHistogram())
+        var possibleCount = 0
+        val skipped = ArrayList<UInt>()
+        for (index in possible.indices) {
+            if (possible[index]) {
+                possibleCount += 1
+            } else if (!disabledPatterns[index]) {
+                skipped += index.toUInt()
+            }
+        }
+        if (possibleCount == 0) return null
+        if (skipped.isEmpty()) return query(node, progressCallback)
+        val derived = derivedQuery(skipped, possible, skipped.size + possibleCount)
+        return (derived ?: query)(node, progressCallback)
+    }
+
+    /**
+     * Disable a certain pattern within the query and all of its copies.
+     *
+     * @throws [IndexOutOfBoundsException]
+     *  If the index exceeds the [pattern count][Query.patternCount].
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun disablePattern(index: UInt) {
+        query.disablePattern(index)
+        disabledPatterns[index.toInt()] = true
+        cache.values.forEach { it.disablePattern(index) }
+    }
+
+    override fun toString() = "QueryPlanner(query=$query, cached=${cache.size})"
+
+    /** Check which of the enabled patterns can match a node with the given histogram. */
+    private fun possiblePatterns(histogram: UIntArray) = BooleanArray(requirements.size) { index ->
+        !disabledPatterns[index] && requirements[index].all {
+            it.toInt() < histogram.size && histogram[it.toInt()] > 0U
+        }
+    }
+
+    /**
+     * Get a copy of the query in which the given patterns are disabled, creating it
+     * if enough of the enabled patterns are skipped. Otherwise, get the cached copy
+     * that skips the most patterns that are not [possible], or `null` if there is none.
+     */
+    private fun derivedQuery(skipped: List<UInt>, possible: BooleanArray, enabled: Int): Query? {
+        cache.remove(skipped)?.let {
+            cache[skipped] = it
+            return it
+        }
+        if (skipped.size < enabled * skipThreshold) {
+            val subset = cache.keys.filter { key -> key.none { possible[it.toInt()] } }
+                .maxByOrNull(List<UInt>::size) ?: return null
+            return cache.remove(subset)!!.also { cache[subset] = it }
+        }
+        val derived = Query(language, source)
+        skipped.forEach(derived::disablePattern)
+        disabledPatterns.forEachIndexed { index, disabled ->
+            if (disabled) derived.disablePattern(index.toUInt())
+        }
+        if (cacheSize > 0) {
+            if (cache.size >= cacheSize) cache.remove(cache.keys.first())
+            cache[skipped] = derived
+        }
+        return derived
+    }
+
+    /**
+     * A scanner of the source code of a single pattern,
+     * which finds the node types that the pattern requires.
+     *
+     * Since the query has already been validated by tree-sitter, the scanner
+     * is lenient. If it cannot understand the pattern, nothing is required.
+     */
+    private class PatternScanner(
+        private val source: ByteArray,
+        private var offset: Int,
+        private val end: Int
+    ) {
+        data class Name(val value: String, val isNamed: Boolean)
+
+        fun scan(): Set<Name> = try {
+            items(null)
+        } catch (_: IllegalStateException) {
+            emptySet()
+        }
+
+        /** Scan a sequence of items, which are all required, until the terminator. */
+        private fun items(terminator: Char?): Set<Name> {
+            val names = mutableSetOf<Name>()
+            while (true) {
+                skipSpace()
+                if (offset >= end) {
+                    check(terminator == null)
+                    return names
+                }
+                if (peek() == terminator) {
+                    offset += 1
+                    return names
+                }
+                item()?.let { names += quantified(it) }
+            }
+        }
+
+        /** Scan the alternatives of an alternation, and keep the names required by all of them. */
+        private fun alternation(): Set<Name> {
+            var common: Set<Name>? = null
+            while (true) {
+                skipSpace()
+                check(offset < end)
+                if (peek() == ']') {
+                    offset += 1
+                    return common.orEmpty()
+                }
+                val names = item()?.let(::quantified) ?: continue
+                common = common?.intersect(names) ?: names
+            }
+        }
+
+        /** Scan a single item, or return `null` if it is a capture, a field or an anchor. */
+        private fun item(): Set<Name>? = when (val char = next()) {
+            '(' -> node()
+            '[' -> alternation()
+            '"' -> setOf(Name(string(), false))
+            '@', '!' -> {
+                identifier()
+                null
+            }
+            '.' -> null
+            else -> {
+                check(char.isIdentifier())
+                offset -= 1
+                val name = identifier()
+                skipSpace()
+                if (offset < end && peek() == ':') {
+                    offset += 1
+                    null
+                } else {
+                    check(name == "_")
+                    emptySet()
+                }
+            }
+        }
+
+        /** Scan a parenthesized node, group or predicate. */
+        private fun node(): Set<Name> {
+            skipSpace()
+            check(offset < end)
+            return when (peek()) {
+                '(', '[', '"', ')' -> items(')')
+                '#' -> {
+                    skipBalanced()
+                    emptySet()
+                }
+                else -> {
+                    var name = Name(identifier(), true)
+                    skipSpace()
+                    if (offset < end && peek() == '/') {
+                        // The supertype is ignored, so only the subtype is required
+                        offset += 1
+                        name = if (next() == '"') {
+                            Name(string(), false)
+                        } else {
+                            offset -= 1
+                            Name(identifier(), true)
+                        }
+                    }
+                    when (name.value) {
+                        "MISSING" -> {
+                            skipBalanced()
+                            emptySet()
+                        }
+                        "_", "ERROR" -> items(')')
+                        else -> items(')') + name
+                    }
+                }
+            }
+        }
+
+        /** Drop the names of an item that is followed by an optional quantifier. */
+        private fun quantified(names: Set<Name>): Set<Name> {
+            skipSpace()
+            if (offset >= end) return names
+            return when (peek()) {
+                '?', '*' -> {
+                    offset += 1
+                    emptySet()
+                }
+                '+' -> {
+                    offset += 1
+                    names
+                }
+                else -> names
+            }
+        }
+
+        /** Skip the rest of a parenthesized expression, including nested ones and strings. */
+        private fun skipBalanced() {
+            var depth = 1
+            while (depth > 0) {
+                when (next()) {
+                    '(' -> depth += 1
+                    ')' -> depth -= 1
+                    '"' -> string()
+                    ';' -> skipComment()
+                }
+            }
+        }
+
+        private fun identifier(): String {
+            val start = offset
+            while (offset < end && peek().let { it.isIdentifier() || it in ".?!" }) offset += 1
+            check(offset > start)
+            return source.decodeToString(start, offset)
+        }
+
+        /** Scan the rest of a string literal and return its unescaped value. */
+        private fun string(): String {
+            val bytes = ArrayList<Byte>()
+            while (true) {
+                check(offset < end)
+                val byte = source[offset++]
+                when (byte.toInt().toChar()) {
+                    '"' -> return bytes.toByteArray().decodeToString()
+                    '\\' -> {
+                        val escaped = when (val char = next()) {
+                            'n' -> '\n'
+                            'r' -> '\r'
+                            't' -> '\t'
+                            '0' -> '\u0000'
+                            else -> char
+                        }
+                        bytes += escaped.code.toByte()
+                    }
+                    else -> bytes += byte
+                }
+            }
+        }
+
+        private fun skipSpace() {
+            while (offset < end) {
+                when (peek()) {
+                    ' ', '\t', '\n', '\r' -> offset += 1
+                    ';' -> skipComment()
+                    else -> return
+                }
+            }
+        }
+
+        private fun skipComment() {
+            while (offset < end && peek() != '\n') offset += 1
+        }
+
+        private fun peek() = (source[offset].toInt() and 0xFF).toChar()
+
+        private fun next(): Char {
+            check(offset < end)
+            return (source[offset++].toInt() and 0xFF).toChar()
+        }
+
+        private fun Char.isIdentifier() = isLetterOrDigit() || this == '_' || this == '-'
+    }
+}
@@ -0,0 +1,128 @@
+package io.github.treesitter.ktreesitter
+
+import kotlin.jvm.JvmName
+import kotlin.time.Duration
+import kotlin.time.TimeSource
+
+/**
+ * A profile of the executions of a query, broken down by pattern.
+ *
+ * A profile is attached to one or more [query cursors][QueryCursor.profile]
+ * and accumulates the statistics of every match that they find. This makes
+ * it possible to find the patterns that dominate the cost of a large query,
+ * so that they can be rewritten or [disabled][Query.disablePattern].
+ *
+ * Tree-sitter does not report the in-progress states of a cursor, so the
+ * profile only counts the matches that it completes. The states that are
+ * dropped because of the [match limit][QueryCursor.matchLimit] are counted
+ * per execution in [matchLimitExceeded].
+ *
+ * A profile must not be shared by cursors that are iterated concurrently.
+ *
+ * #### Example
+ *
+ * ```kotlin
+ * val profile = QueryProfile(query)
+ * query(tree.rootNode).apply { this.profile = profile }.matches().count()
+ * profile.byStartByte.values.sortedByDescending { it.predicateTime }.take(10)
+ * ```
+ *
+ * @since 0.26.0
+ */
+class QueryProfile(val query: Query) {
+    /** The statistics of every pattern, indexed by the pattern index. */
+    val patterns: List<PatternStats> = List(query.patternCount.toInt()) {
+        PatternStats(it.toUInt(), query.startByteForPattern(it.toUInt()))
+    }
+
+    /** The statistics of every pattern, keyed and ordered by its start byte in the query. */
+    val byStartByte: Map<UInt, PatternStats>
+        get() = patterns.associateBy(PatternStats::startByte)
+
+    /** The number of executions that [exceeded][QueryCursor.didExceedMatchLimit] their limit. */
+    @get:JvmName("getMatchLimitExceeded")
+    var matchLimitExceeded: ULong = 0UL
+        private set
+
+    /** The number of executions that have been profiled. */
+    @get:JvmName("getExecutions")
+    var executions: ULong = 0UL
+        private set
+
+    /** Reset all the statistics. */
+    fun reset() {
+        patterns.forEach(PatternStats::reset)
+        matchLimitExceeded = 0UL
+        executions = 0UL
+    }
+
+    /** Record a completed match and evaluate its predicates with the given function. */
+    internal inline fun record(match: QueryMatch, evaluate: () -> Boolean): Boolean {
+        val stats = patterns[match.patternIndex.toInt()]
+        stats.matches += 1UL
+        stats.captures += match.captures.size.toULong()
+        val mark = TimeSource.Monotonic.markNow()
+        val result = evaluate()
+        stats.predicateTime += mark.elapsedNow()
+        if (!result) stats.rejected += 1UL
+        return result
+    }
+
+    /** Record the end of an execution. */
+    internal fun finish(didExceedMatchLimit: Boolean) {
+        executions += 1UL
+        if (didExceedMatchLimit) matchLimitExceeded += 1UL
+    }
+
+    override fun toString() = patterns.filter { it.matches > 0UL }.joinToString(
+        prefix = "QueryProfile(executions=$executions, matchLimitExceeded=$matchLimitExceeded, ",
+        postfix = ")"
+    )
+
+    /**
+     * The statistics of a single pattern.
+     *
+     * @property patternIndex The index of the pattern in the query.
+     * @property startByte The [start byte][Query.startByteForPattern] of the pattern.
+     */
+    class PatternStats internal constructor(
+        @get:JvmName("patternIndex") val patternIndex: UInt,
+        @get:JvmName("startByte") val startByte: UInt
+    ) {
+        /** The number of matches that were completed, before their predicates were checked. */
+        @get:JvmName("getMatches")
+        var matches: ULong = 0UL
+            internal set
+
+        /** The number of matches that were rejected by a predicate. */
+        @get:JvmName("getRejected")
+        var rejected: ULong = 0UL
+            internal set
+
+        /** The number of matches that were accepted by all the predicates. */
+        @get:JvmName("getAccepted")
+        val accepted: ULong
+            get() = matches - rejected
+
+        /** The total number of nodes that were captured by the completed matches. */
+        @get:JvmName("getCaptures")
+        var captures: ULong = 0UL
+            internal set
+
+        /** The total time that was spent evaluating the predicates of the pattern. */
+        @get:JvmName("getPredicateTime")
+        var predicateTime: Duration = Duration.ZERO
+            internal set
+
+        internal fun reset() {
+            matches = 0UL
+            rejected = 0UL
+            captures = 0UL
+            predicateTime = Duration.ZERO
+        }
+
+        override fun toString() =
+            "PatternStats(patternIndex=$patternIndex, startByte=$startByte, matches=$matches, " +
+                "rejected=$rejected, captures=$captures, predicateTime=$predicateTime)"
+    }
+}
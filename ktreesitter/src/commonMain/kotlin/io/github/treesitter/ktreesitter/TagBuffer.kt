@@ -0,0 +1,309 @@
+package io.github.treesitter.ktreesitter
+
+/**
+ * A buffer of the code navigation tags that a [Tagger] has extracted from a syntax tree.
+ *
+ * The tags are stored in columns of primitive arrays, so that no object is allocated
+ * per tag, and a buffer can be [cleared][clear] and filled again without allocating.
+ * A tag is accessed by its index, and the tags are ordered by the start of their names.
+ *
+ * #### Example
+ *
+ * ```kotlin
+ * val tags = tagger.tag(tree)
+ * for (i in 0..<tags.size) {
+ *     if (tags.isDefinition(i)) println("${tags.syntaxType(i)} at line ${tags.row(i)}")
+ * }
+ * ```
+ *
+ * @constructor Create an empty buffer with room for the given number of tags.
+ * @since 0.26.0
+ */
+class TagBuffer(initialCapacity: Int = 64) {
+    private var syntaxTypeIds = IntArray(initialCapacity)
+
+    private var definitions = BooleanArray(initialCapacity)
+
+    private var nameStarts = IntArray(initialCapacity)
+
+    private var nameEnds = IntArray(initialCapacity)
+
+    private var starts = IntArray(initialCapacity)
+
+    private var ends = IntArray(initialCapacity)
+
+    private var rows = IntArray(initialCapacity)
+
+    /** The start of the node, the name and the documentation of every tag. */
+    private var extentStarts = IntArray(initialCapacity)
+
+    /** The end of the node, the name and the documentation of every tag. */
+    private var extentEnds = IntArray(initialCapacity)
+
+    /** The index of the pattern that created every tag, which takes precedence if lower. */
+    private var patterns = IntArray(initialCapacity)
+
+    private var docList = arrayOfNulls<String>(initialCapacity)
+
+    /** The number of tags in the buffer. */
+    var size: Int = 0
+        private set
+
+    /** The [syntax types][Tagger.syntaxTypes] of the tagger that filled the buffer. */
+    var syntaxTypes: List<String> = emptyList()
+        internal set
+
+    /**
+     * Get the ID of the syntax type of the given tag.
+     *
+     * @throws [IndexOutOfBoundsException] If the index exceeds the [size].
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun syntaxTypeId(index: Int): Int = syntaxTypeIds[checkIndex(index)]
+
+    /**
+     * Get the syntax type of the given tag, such as `function` or `call`.
+     *
+     * @throws [IndexOutOfBoundsException] If the index exceeds the [size].
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun syntaxType(index: Int): String = syntaxTypes[syntaxTypeId(index)]
+
+    /**
+     * Check if the given tag is a definition, rather than a reference.
+     *
+     * @throws [IndexOutOfBoundsException] If the index exceeds the [size].
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun isDefinition(index: Int): Boolean = definitions[checkIndex(index)]
+
+    /**
+     * Get the start byte of the name of the given tag.
+     *
+     * @throws [IndexOutOfBoundsException] If the index exceeds the [size].
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun nameStartByte(index: Int): UInt = nameStarts[checkIndex(index)].toUInt()
+
+    /**
+     * Get the end byte of the name of the given tag.
+     *
+     * @throws [IndexOutOfBoundsException] If the index exceeds the [size].
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun nameEndByte(index: Int): UInt = nameEnds[checkIndex(index)].toUInt()
+
+    /**
+     * Get the start byte of the node of the given tag, including its name.
+     *
+     * @throws [IndexOutOfBoundsException] If the index exceeds the [size].
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun startByte(index: Int): UInt = starts[checkIndex(index)].toUInt()
+
+    /**
+     * Get the end byte of the node of the given tag, including its name.
+     *
+     * @throws [IndexOutOfBoundsException] If the index exceeds the [size].
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun endByte(index: Int): UInt = ends[checkIndex(index)].toUInt()
+
+    /**
+     * Get the row on which the name of the given tag starts.
+     *
+     * @throws [IndexOutOfBoundsException] If the index exceeds the [size].
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun row(index: Int): UInt = rows[checkIndex(index)].toUInt()
+
+    /**
+     * Get the documentation of the given tag, if it has any.
+     *
+     * @throws [IndexOutOfBoundsException] If the index exceeds the [size].
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun docs(index: Int): String? = docList[checkIndex(index)]
+
+    /** Remove all the tags from the buffer, keeping its capacity. */
+    fun clear() {
+        docList.fill(null, 0, size)
+        size = 0
+    }
+
+    override fun toString() = "TagBuffer(size=$size)"
+
+    /** Add a tag to the end of the buffer and return its index. */
+    internal fun add(
+        syntaxTypeId: Int,
+        isDefinition: Boolean,
+        nameStart: UInt,
+        nameEnd: UInt,
+        start: UInt,
+        end: UInt,
+        extent: UIntRange,
+        row: UInt,
+        docs: String?,
+        pattern: Int
+    ): Int {
+        if (size == nameStarts.size) grow()
+        set(
+            size,
+            syntaxTypeId,
+            isDefinition,
+            nameStart,
+            nameEnd,
+            start,
+            end,
+            extent,
+            row,
+            docs,
+            pattern
+        )
+        return size++
+    }
+
+    /** Replace the tag at the given index. */
+    internal fun set(
+        index: Int,
+        syntaxTypeId: Int,
+        isDefinition: Boolean,
+        nameStart: UInt,
+        nameEnd: UInt,
+        start: UInt,
+        end: UInt,
+        extent: UIntRange,
+        row: UInt,
+        docs: String?,
+        pattern: Int
+    ) {
+        syntaxTypeIds[index] = syntaxTypeId
+        definitions[index] = isDefinition
+        nameStarts[index] = nameStart.toInt()
+        nameEnds[index] = nameEnd.toInt()
+        starts[index] = start.toInt()
+        ends[index] = end.toInt()
+        extentStarts[index] = extent.first.toInt()
+        extentEnds[index] = extent.last.toInt()
+        rows[index] = row.toInt()
+        docList[index] = docs
+        patterns[index] = pattern
+    }
+
+    internal fun patternIndex(index: Int) = patterns[index]
+
+    /**
+     * Find the tag with the given name range among the first tags,
+     * which must be sorted, or return `-1` if there is none.
+     */
+    internal fun find(nameStart: UInt, nameEnd: UInt, until: Int): Int {
+        var low = 0
+        var high = until - 1
+        while (low <= high) {
+            val mid = (low + high) ushr 1
+            val order = if (nameStarts[mid] != nameStart.toInt()) {
+                nameStarts[mid].compareTo(nameStart.toInt())
+            } else {
+                nameEnds[mid].compareTo(nameEnd.toInt())
+            }
+            when {
+                order < 0 -> low = mid + 1
+                order > 0 -> high = mid - 1
+                else -> return mid
+            }
+        }
+        return -1
+    }
+
+    /**
+     * Check if the node, the name or the documentation of the
+     * given tag intersects the given range, including its ends.
+     */
+    internal fun intersects(index: Int, range: UIntRange) =
+        extentStarts[index].toUInt() <= range.last && range.first <= extentEnds[index].toUInt()
+
+    /** Move the tags after the edit, in the same way as the nodes of an edited tree. */
+    internal fun edit(edit: InputEdit) {
+        val rowDelta = edit.newEndPoint.row.toInt() - edit.oldEndPoint.row.toInt()
+        for (i in 0..<size) {
+            if (nameStarts[i].toUInt() >= edit.oldEndByte) rows[i] += rowDelta
+            nameStarts[i] = edit.shift(nameStarts[i].toUInt()).toInt()
+            nameEnds[i] = edit.shift(nameEnds[i].toUInt()).toInt()
+            starts[i] = edit.shift(starts[i].toUInt()).toInt()
+            ends[i] = edit.shift(ends[i].toUInt()).toInt()
+            extentStarts[i] = edit.shift(extentStarts[i].toUInt()).toInt()
+            extentEnds[i] = edit.shift(extentEnds[i].toUInt()).toInt()
+        }
+    }
+
+    /** Remove the tags that match the predicate, keeping the order of the others. */
+    internal fun removeIf(predicate: (Int) -> Boolean) {
+        var kept = 0
+        for (i in 0..<size) {
+            if (predicate(i)) continue
+            if (kept != i) move(i, kept)
+            kept += 1
+        }
+        docList.fill(null, kept, size)
+        size = kept
+    }
+
+    /** Sort the tags by the start and then by the end of their names. */
+    internal fun sort() {
+        val sorted = (1..<size).all {
+            nameStarts[it - 1] < nameStarts[it] ||
+                (nameStarts[it - 1] == nameStarts[it] && nameEnds[it - 1] <= nameEnds[it])
+        }
+        if (sorted) return
+        val order = (0..<size).sortedWith(compareBy({ nameStarts[it] }, { nameEnds[it] }))
+        syntaxTypeIds = syntaxTypeIds.permute(order)
+        definitions = BooleanArray(definitions.size) { it < size && definitions[order[it]] }
+        nameStarts = nameStarts.permute(order)
+        nameEnds = nameEnds.permute(order)
+        starts = starts.permute(order)
+        ends = ends.permute(order)
+        extentStarts = extentStarts.permute(order)
+        extentEnds = extentEnds.permute(order)
+        rows = rows.permute(order)
+        patterns = patterns.permute(order)
+        docList = Array(docList.size) { if (it < size) docList[order[it]] else null }
+    }
+
+    private fun move(from: Int, to: Int) {
+        syntaxTypeIds[to] = syntaxTypeIds[from]
+        definitions[to] = definitions[from]
+        nameStarts[to] = nameStarts[from]
+        nameEnds[to] = nameEnds[from]
+        starts[to] = starts[from]
+        ends[to] = ends[from]
+        extentStarts[to] = extentStarts[from]
+        extentEnds[to] = extentEnds[from]
+        rows[to] = rows[from]
+        patterns[to] = patterns[from]
+        docList[to] = docList[from]
+    }
+
+    private fun grow() {
+        val capacity = maxOf(nameStarts.size * 2, 16)
+        syntaxTypeIds = syntaxTypeIds.copyOf(capacity)
+        definitions = definitions.copyOf(capacity)
+        nameStarts = nameStarts.copyOf(capacity)
+        nameEnds = nameEnds.copyOf(capacity)
+        starts = starts.copyOf(capacity)
+        ends = ends.copyOf(capacity)
+        extentStarts = extentStarts.copyOf(capacity)
+        extentEnds = extentEnds.copyOf(capacity)
+        rows = rows.copyOf(capacity)
+        patterns = patterns.copyOf(capacity)
+        docList = docList.copyOf(capacity)
+    }
+
+    private fun IntArray.permute(order: List<Int>) =
+        IntArray(size) { if (it < order.size) this[order[it]] else 0 }
+
+    private fun checkIndex(index: Int): Int {
+        if (index < 0 || index >= size)
+            throw IndexOutOfBoundsException("Tag index $index is out of bounds")
+        return index
+    }
+}
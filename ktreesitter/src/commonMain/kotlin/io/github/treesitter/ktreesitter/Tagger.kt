@@ -0,0 +1,334 @@
+package io.github.treesitter.ktreesitter
+
+/**
+ * A tagger that extracts the definitions and references of a syntax tree for
+ * [code navigation](https://tree-sitter.github.io/tree-sitter/4-code-navigation.html),
+ * using a `tags.scm` query in the same way as `tree-sitter-tags`.
+ *
+ * The query may assign the following captures:
+ *
+ * - `@definition.<type>` and `@reference.<type>` to the node of a definition or a
+ *   reference with the given syntax type, such as `@definition.class` or `@reference.call`.
+ * - `@name` to the name of the definition or reference.
+ * - `@doc` to the comments that document a definition.
+ * - `@ignore` to names that must not be tagged by any pattern.
+ *
+ * and may use the following predicates:
+ *
+ * - `#strip! @doc "regex"` removes every match of the regex from the documentation.
+ * - `#select-adjacent! @doc @node` only keeps the last consecutive comments
+ *   which end on the row before the given node, or on the same row.
+ *
+ * Every name is tagged at most once, by the first pattern in the query that matches it.
+ * The tags are written to a [TagBuffer], and they can be updated incrementally with
+ * [retag] after the tree has been edited.
+ *
+ * #### Example
+ *
+ * ```kotlin
+ * val tagger = Tagger(language, tagsQuery)
+ * val tags = tagger.tag(tree)
+ * tree.edit(edit)
+ * val newTree = parser.parse(newSource, oldTree = tree)
+ * tagger.retag(tags, newTree, listOf(edit), tree.changedRanges(newTree))
+ * ```
+ *
+ * @constructor Create a new tagger from a tags query.
+ * @param language The language of the query.
+ * @param source The source code of the query.
+ * @throws [QueryError] If any error occurred while creating the query.
+ * @since 0.26.0
+ */
+class Tagger @Throws(QueryError::class) constructor(val language: Language, source: String) {
+    /** The tags query. */
+    val query = Query(language, source)
+
+    /** The syntax types of the tags, which are identified by their index. */
+    val syntaxTypes: List<String>
+
+    /** The syntax type ID and definition flag of every tag capture, packed into one integer. */
+    private val tagCaptures = mutableMapOf<String, Int>()
+
+    private val stripRegexes = arrayOfNulls<Regex>(query.patternCount.toInt())
+
+    private val adjacentCaptures = arrayOfNulls<String>(query.patternCount.toInt())
+
+    init {
+        val types = mutableListOf<String>()
+        for (name in query.captureNames) {
+            val isDefinition = name.startsWith(DEFINITION_PREFIX)
+            if (!isDefinition && !name.startsWith(REFERENCE_PREFIX)) continue
+            val type = name.substringAfter('.')
+            val id = types.indexOf(type).takeIf { it >= 0 } ?: types.size.also { types += type }
+            tagCaptures[name] = (id shl 1) or (if (isDefinition) 1 else 0)
+        }
+        syntaxTypes = types
+
+        query.predicates.forEachIndexed { index, predicates ->
+            for (predicate in predicates) {
+                if (predicate !is QueryPredicate.Generic) continue
+                val args = predicate.args
+                when (predicate.name) {
+                    "strip!" -> {
+                        if (args.size != 2 || args[0] !is QueryPredicateArg.Capture ||
+                            args[1] !is QueryPredicateArg.Literal
+                        ) {
+                            throw QueryError.Predicate(
+                                rowOf(source, index),
+                                "#strip! expects a capture and a string literal"
+                            )
+                        }
+                        stripRegexes[index] = try {
+                            Regex(args[1].value)
+                        } catch (cause: IllegalArgumentException) {
+                            throw QueryError.Predicate(rowOf(source, index), "pattern error", cause)
+                        }
+                    }
+
+                    "select-adjacent!" -> {
+                        if (args.size != 2 || args.any { it !is QueryPredicateArg.Capture }) {
+                            throw QueryError.Predicate(
+                                rowOf(source, index),
+                                "#select-adjacent! expects 2 captures"
+                            )
+                        }
+                        adjacentCaptures[index] = args[1].value
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Extract the tags of the given tree.
+     *
+     * The tree must have been parsed from a text, so that
+     * the documentation of the tags can be extracted.
+     *
+     * @param tags The buffer to fill, which is cleared first.
+     * @return The buffer that contains the tags.
+     */
+    fun tag(tree: Tree, tags: TagBuffer = TagBuffer()): TagBuffer {
+        tags.clear()
+        tags.syntaxTypes = syntaxTypes
+        collect(query(tree.rootNode), tags, null, 0, mutableMapOf())
+        tags.removeIf { tags.syntaxTypeId(it) == IGNORED }
+        tags.sort()
+        return tags
+    }
+
+    /**
+     * Update the tags of an edited tree, by only extracting
+     * the tags that intersect the edits or the changed ranges.
+     *
+     * If the buffer was not filled by this tagger, all the tags are extracted again.
+     *
+     * @param tags The buffer that contains the tags of the old tree.
+     * @param tree The new tree, which was parsed after the edits.
+     * @param edits The edits that were applied to the old tree.
+     * @param changedRanges The [changed ranges][Tree.changedRanges] between the two trees.
+     * @return The buffer that contains the tags.
+     */
+    fun retag(
+        tags: TagBuffer,
+        tree: Tree,
+        edits: List<InputEdit>,
+        changedRanges: List<Range>
+    ): TagBuffer {
+        if (tags.syntaxTypes !== syntaxTypes) return tag(tree, tags)
+        edits.forEach(tags::edit)
+        val dirtyRanges = dirtyRanges(edits, changedRanges)
+        if (dirtyRanges.isEmpty()) return tags
+
+        tags.removeIf { index -> dirtyRanges.any { tags.intersects(index, it) } }
+        val retained = tags.size
+        val added = mutableMapOf<Long, Int>()
+        for (range in dirtyRanges) {
+            // A node that ends at the start of the range does not intersect it
+            val cursor = query(tree.rootNode)
+            cursor.byteRange = (if (range.first > 0U) range.first - 1U else 0U)..range.last + 1U
+            collect(cursor, tags, dirtyRanges, retained, added)
+        }
+        tags.removeIf { tags.syntaxTypeId(it) == IGNORED }
+        tags.sort()
+        return tags
+    }
+
+    override fun toString() = "Tagger(language=$language, syntaxTypes=$syntaxTypes)"
+
+    /**
+     * Add the tags of every match of the cursor to the buffer.
+     *
+     * @param dirtyRanges If not `null`, only the tags that intersect these ranges are added.
+     * @param retained The number of sorted tags at the start of the buffer that were kept.
+     * @param added The indices of the added tags, keyed by their name range.
+     */
+    private fun collect(
+        cursor: QueryCursor,
+        tags: TagBuffer,
+        dirtyRanges: List<UIntRange>?,
+        retained: Int,
+        added: MutableMap<Long, Int>
+    ) {
+        val docNodes = mutableListOf<Node>()
+        for (match in cursor.matches()) {
+            val pattern = match.patternIndex.toInt()
+            val adjacentCapture = adjacentCaptures[pattern]
+            var nameNode: Node? = null
+            var tagNode: Node? = null
+            var adjacentNode: Node? = null
+            var tagCapture = 0
+            var isIgnored = false
+            docNodes.clear()
+            for ((captured, captureName) in match.captures) {
+                if (captureName == adjacentCapture) adjacentNode = captured
+                when (captureName) {
+                    NAME_CAPTURE -> nameNode = captured
+                    DOC_CAPTURE -> docNodes += captured
+                    IGNORE_CAPTURE -> {
+                        isIgnored = true
+                        if (nameNode == null) nameNode = captured
+                    }
+                    else -> tagCaptures[captureName]?.let {
+                        tagNode = captured
+                        tagCapture = it
+                    }
+                }
+            }
+
+            val name = nameNode ?: continue
+            val node = tagNode
+            if (node == null && !isIgnored) continue
+            if (node != null && name.hasError) continue
+            val start = minOf(node?.startByte ?: name.startByte, name.startByte)
+            val end = maxOf(node?.endByte ?: name.endByte, name.endByte)
+            // The documentation is retagged whenever any of the captured comments changes
+            val extentStart = minOf(start, docNodes.minOfOrNull { it.startByte } ?: start)
+            val extent = extentStart..maxOf(end, docNodes.maxOfOrNull { it.endByte } ?: end)
+            if (dirtyRanges != null &&
+                dirtyRanges.none { extent.first <= it.last && it.first <= extent.last }
+            ) {
+                continue
+            }
+
+            val key = (name.startByte.toLong() shl 32) or name.endByte.toLong()
+            val existing = added[key] ?: tags.find(name.startByte, name.endByte, retained)
+            if (existing >= 0 && tags.patternIndex(existing) < pattern) continue
+
+            // A pattern may match the same name with and without its documentation
+            val docs = if (isIgnored) null else docs(docNodes, adjacentNode, pattern)
+            if (existing >= 0 && tags.patternIndex(existing) == pattern &&
+                (docs == null || tags.docs(existing) != null)
+            ) {
+                continue
+            }
+
+            val syntaxTypeId = if (isIgnored) IGNORED else tagCapture shr 1
+            val isDefinition = !isIgnored && (tagCapture and 1) == 1
+            val row = name.startPoint.row
+            if (existing >= 0) {
+                tags.set(
+                    existing,
+                    syntaxTypeId,
+                    isDefinition,
+                    name.startByte,
+                    name.endByte,
+                    start,
+                    end,
+                    extent,
+                    row,
+                    docs,
+                    pattern
+                )
+            } else {
+                added[key] = tags.add(
+                    syntaxTypeId,
+                    isDefinition,
+                    name.startByte,
+                    name.endByte,
+                    start,
+                    end,
+                    extent,
+                    row,
+                    docs,
+                    pattern
+                )
+            }
+        }
+    }
+
+    /** Get the row of the given pattern in the source of the query. */
+    private fun rowOf(source: String, index: Int): UInt {
+        val offset = query.startByteForPattern(index.toUInt()).toInt()
+        return source.encodeToByteArray().asSequence().take(offset).count { it == NEWLINE }.toUInt()
+    }
+
+    /** Join the text of the documentation nodes, after selecting and stripping them. */
+    private fun docs(nodes: List<Node>, adjacentNode: Node?, pattern: Int): String? {
+        if (nodes.isEmpty()) return null
+        var first = 0
+        if (adjacentNode != null) {
+            first = nodes.size
+            var row = adjacentNode.startPoint.row
+            while (first > 0 && nodes[first - 1].endPoint.row + 1U >= row) {
+                first -= 1
+                row = nodes[first].startPoint.row
+            }
+            if (first == nodes.size) return null
+        }
+        val regex = stripRegexes[pattern]
+        return nodes.subList(first, nodes.size).joinToString("\n") {
+            val text = it.text() ?: ""
+            regex?.replace(text, "") ?: text.toString()
+        }
+    }
+
+    private companion object {
+        private const val DEFINITION_PREFIX = "definition."
+
+        private const val REFERENCE_PREFIX = "reference."
+
+        private const val NAME_CAPTURE = "name"
+
+        private const val DOC_CAPTURE = "doc"
+
+        private const val IGNORE_CAPTURE = "ignore"
+
+        private const val NEWLINE = '\n'.code.toByte()
+
+        /** The syntax type ID of the names that are ignored. */
+        private const val IGNORED = -1
+
+        /**
+         * Get the merged byte ranges of the edits, in the
+         * coordinates of the new tree, and of the changed ranges.
+         */
+        private fun dirtyRanges(
+            edits: List<InputEdit>,
+            changedRanges: List<Range>
+        ): List<UIntRange> {
+            val ranges = ArrayList<UIntRange>(edits.size + changedRanges.size)
+            edits.forEachIndexed { i, edit ->
+                var start = edit.startByte
+                var end = edit.newEndByte
+                for (j in i + 1..<edits.size) {
+                    start = edits[j].shift(start)
+                    end = edits[j].shift(end)
+                }
+                ranges += start..end
+            }
+            changedRanges.mapTo(ranges) { it.startByte..it.endByte }
+            ranges.sortBy(UIntRange::first)
+            val merged = ArrayList<UIntRange>(ranges.size)
+            for (range in ranges) {
+                val last = merged.lastOrNull()
+                if (last != null && range.first <= last.last + 1U) {
+                    merged[merged.lastIndex] = last.first..maxOf(last.last, range.last)
+                } else {
+                    merged += range
+                }
+            }
+            return merged
+        }
+    }
+}
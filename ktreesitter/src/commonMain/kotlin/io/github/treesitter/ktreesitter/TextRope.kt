@@ -0,0 +1,233 @@
+package io.github.treesitter.ktreesitter
+
+/**
+ * Get the number of bytes that the character takes up
+ * in the text that the parser receives from a [ParseReadCallback].
+ */
+internal expect fun Char.encodedSize(): Int
+
+/**
+ * A text that is stored as a list of chunks, which keep track of their sizes
+ * so that character indices can be mapped to byte offsets and points cheaply.
+ *
+ * Replacing a range of the text only rebuilds the chunks that it touches.
+ */
+internal class TextRope(text: CharSequence) {
+    private val chunks = ArrayList<Chunk>()
+
+    /** The start of the last chunk that was located, which speeds up sequential lookups. */
+    private var lastLocation = Location.START
+
+    /** The length of the text in characters. */
+    var length = 0
+        private set
+
+    /** The length of the text in bytes. */
+    var byteLength = 0
+        private set
+
+    init {
+        chunks.addAll(split(text))
+        chunks.forEach {
+            length += it.text.length
+            byteLength += it.bytes
+        }
+    }
+
+    /** Get the byte offset and the point of the given character index. */
+    fun position(index: Int): Position {
+        val location = locateChar(index)
+        if (location.index == chunks.size) return location.position()
+        return location.advance(chunks[location.index].text, index - location.char)
+    }
+
+    /**
+     * Get the character index of the given byte offset.
+     *
+     * @throws [IllegalArgumentException] If the offset is not at a character boundary.
+     */
+    fun index(byte: Int): Int {
+        val location = locateByte(byte)
+        if (location.index == chunks.size) return location.char
+        val text = chunks[location.index].text
+        var offset = location.byte
+        for (i in text.indices) {
+            if (offset == byte) return location.char + i
+            offset += text[i].encodedSize()
+            require(offset <= byte) { "Byte offset $byte is not at a character boundary" }
+        }
+        return location.char + text.length
+    }
+
+    /** Read the text from the given byte offset up to the end of its chunk. */
+    fun read(byte: Int): String? {
+        val location = locateByte(byte)
+        if (location.index == chunks.size) return null
+        val text = chunks[location.index].text
+        if (byte == location.byte) return text
+        var offset = location.byte
+        var i = 0
+        while (i < text.length && offset < byte) offset += text[i++].encodedSize()
+        return text.substring(i)
+    }
+
+    /** Replace the characters between [start] and [end] with the given [text]. */
+    fun replace(start: Int, end: Int, text: CharSequence) {
+        // Start from the chunk that ends at the start, so that appending
+        // to a chunk extends it instead of creating a new small chunk.
+        val first = locateChar(maxOf(start - 1, 0))
+        var last = first
+        while (last.index < chunks.size && last.char + chunks[last.index].text.length < end) {
+            last = last.next(chunks[last.index])
+        }
+
+        val builder = StringBuilder()
+        if (first.index < chunks.size) {
+            builder.append(chunks[first.index].text, 0, start - first.char)
+        }
+        builder.append(text)
+        var removeUntil = first.index
+        if (last.index < chunks.size) {
+            builder.append(chunks[last.index].text, end - last.char, chunks[last.index].text.length)
+            removeUntil = last.index + 1
+        }
+        // Merge small results with the next chunk to keep the number of chunks low.
+        if (builder.length < MIN_CHUNK_SIZE && removeUntil < chunks.size) {
+            builder.append(chunks[removeUntil++].text)
+        }
+
+        val replaced = chunks.subList(first.index, removeUntil)
+        replaced.forEach {
+            length -= it.text.length
+            byteLength -= it.bytes
+        }
+        replaced.clear()
+        val inserted = split(builder)
+        inserted.forEach {
+            length += it.text.length
+            byteLength += it.bytes
+        }
+        chunks.addAll(first.index, inserted)
+        if (lastLocation.index >= first.index) lastLocation = Location.START
+    }
+
+    override fun toString() = buildString(length) { chunks.forEach { append(it.text) } }
+
+    private fun locateChar(index: Int) = locate(index, { it.char }, { it.text.length })
+
+    private fun locateByte(byte: Int) = locate(byte, { it.byte }, { it.bytes })
+
+    /** Find the chunk that contains the given offset, or the end of the text. */
+    private inline fun locate(
+        offset: Int,
+        start: (Location) -> Int,
+        size: (Chunk) -> Int
+    ): Location {
+        var location = lastLocation
+        if (location.index >= chunks.size || start(location) > offset) {
+            location = Location.START
+        }
+        while (location.index < chunks.size &&
+            start(location) + size(chunks[location.index]) <= offset
+        ) {
+            location = location.next(chunks[location.index])
+        }
+        if (location.index < chunks.size) lastLocation = location
+        return location
+    }
+
+    /** The contents of a chunk and their sizes. */
+    private class Chunk(val text: String) {
+        /** The number of bytes in the chunk. */
+        val bytes: Int
+
+        /** The number of line breaks in the chunk. */
+        val lines: Int
+
+        /** The number of bytes after the last line break, or all the bytes if there is none. */
+        val lastLineBytes: Int
+
+        init {
+            var bytes = 0
+            var lines = 0
+            var lastLineBytes = 0
+            for (char in text) {
+                val size = char.encodedSize()
+                bytes += size
+                if (char == '\n') {
+                    lines += 1
+                    lastLineBytes = 0
+                } else {
+                    lastLineBytes += size
+                }
+            }
+            this.bytes = bytes
+            this.lines = lines
+            this.lastLineBytes = lastLineBytes
+        }
+    }
+
+    /** The start of a chunk in the text. */
+    private class Location(
+        val index: Int,
+        val char: Int,
+        val byte: Int,
+        val row: Int,
+        val column: Int
+    ) {
+        fun next(chunk: Chunk) = Location(
+            index + 1,
+            char + chunk.text.length,
+            byte + chunk.bytes,
+            row + chunk.lines,
+            if (chunk.lines > 0) chunk.lastLineBytes else column + chunk.bytes
+        )
+
+        fun position() = Position(byte.toUInt(), Point(row.toUInt(), column.toUInt()))
+
+        fun advance(text: String, count: Int): Position {
+            var byte = byte
+            var row = row
+            var column = column
+            for (i in 0 until count) {
+                val size = text[i].encodedSize()
+                byte += size
+                if (text[i] == '\n') {
+                    row += 1
+                    column = 0
+                } else {
+                    column += size
+                }
+            }
+            return Position(byte.toUInt(), Point(row.toUInt(), column.toUInt()))
+        }
+
+        companion object {
+            val START = Location(0, 0, 0, 0, 0)
+        }
+    }
+
+    /** A position in the text, in the coordinates used by the parser. */
+    class Position(val byte: UInt, val point: Point)
+
+    private companion object {
+        /** The maximum number of characters in a chunk. */
+        const val MAX_CHUNK_SIZE = 4096
+
+        /** The size below which an edited chunk is merged with the next one. */
+        const val MIN_CHUNK_SIZE = 1024
+
+        /** Split the text into chunks, without separating surrogate pairs. */
+        fun split(text: CharSequence): List<Chunk> {
+            val result = ArrayList<Chunk>(text.length / MAX_CHUNK_SIZE + 1)
+            var start = 0
+            while (start < text.length) {
+                var end = minOf(start + MAX_CHUNK_SIZE, text.length)
+                if (end < text.length && text[end - 1].isHighSurrogate()) end -= 1
+                result += Chunk(text.substring(start, end))
+                start = end
+            }
+            return result
+        }
+    }
+}
@@ -11,6 +11,19 @@ expect class Tree {
     /** The included ranges that were used to parse the syntax tree. */
     val includedRanges: List<Range>
 
+    /**
+     * The number of bytes of native memory that were allocated for the syntax tree.
+     *
+     * Subtrees that were reused from other trees, such as the trees that this
+     * tree was [copied][copy] from or incrementally parsed from, are not included.
+     * This is read without walking the tree, and it is always `0` when the
+     * [allocator][TreeSitter.allocator] is [NativeAllocator.SYSTEM].
+     * Use [TreeSitter.nativeSizeBytes] to measure the whole memory of several trees.
+     *
+     * @since 0.26.0
+     */
+    val nativeSizeBytes: ULong
+
     /**
      * Get the root node of the syntax tree, but with
      * its position shifted forward by the given offset.
@@ -23,6 +36,17 @@ expect class Tree {
      */
     fun edit(edit: InputEdit)
 
+    /**
+     * Edit the syntax tree with a batch of edits, which are applied in order.
+     *
+     * This is equivalent to calling [edit] for every edit, and [Node.edit]
+     * for every edit on each of the given [nodes], but it is much faster.
+     *
+     * @param nodes The nodes that should also be kept in sync with the edits.
+     * @since 0.26.0
+     */
+    fun edit(edits: List<InputEdit>, nodes: List<Node> = emptyList())
+
     /**
      * Create a shallow copy of the syntax tree.
      *
@@ -37,6 +61,15 @@ expect class Tree {
     /** Get the source code of the syntax tree, if available. */
     fun text(): CharSequence?
 
+    /**
+     * Get a [line index][LineIndex] of the source code of the syntax tree, if available.
+     *
+     * The index is created on the first call and reused afterwards.
+     *
+     * @since 0.26.0
+     */
+    fun lineIndex(): LineIndex?
+
     /**
      * Compare an old edited syntax tree to a new
      * syntax tree representing the same document.
@@ -47,4 +80,26 @@ expect class Tree {
      * @return A list of ranges whose syntactic structure has changed.
      */
     fun changedRanges(newTree: Tree): List<Range>
+
+    /**
+     * Compute the structural differences between the named nodes
+     * of an old edited syntax tree and a new syntax tree.
+     *
+     * For this to work correctly, this tree must have been edited
+     * such that its ranges match up to the new tree, and the new
+     * tree must have been parsed with this tree as the old tree.
+     *
+     * @throws [IllegalStateException] If the differences could not be allocated.
+     * @since 0.26.0
+     */
+    @Throws(IllegalStateException::class)
+    fun diff(newTree: Tree): TreeDiff
+
+    /**
+     * Free the native tree immediately, instead of when the object is collected.
+     *
+     * The tree must not be used afterwards, so this is only called on trees
+     * that are never exposed to users.
+     */
+    internal fun release()
 }
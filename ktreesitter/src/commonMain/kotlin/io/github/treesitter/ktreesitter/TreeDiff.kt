@@ -0,0 +1,134 @@
+package io.github.treesitter.ktreesitter
+
+/**
+ * The structural differences between the named nodes of an old syntax tree and a new one.
+ *
+ * The differences are computed in a single native walk of both trees, which skips
+ * the subtrees that the new tree reused from the old one. They are stored in a packed
+ * integer array, so that no object is allocated per edit, and an edit is accessed
+ * by its index. The positions of the old nodes are those of the edited old tree.
+ *
+ * An [inserted][Kind.INSERTED] or [deleted][Kind.DELETED] subtree is only reported by
+ * its root, apart from the subtrees inside it which were [moved][Kind.MOVED].
+ * Since the trees do not contain the text of their tokens, a node is
+ * [updated][Kind.UPDATED] when its own tokens were reparsed or have changed.
+ *
+ * #### Example
+ *
+ * ```kotlin
+ * tree.edit(edit)
+ * val newTree = parser.parse(newSource, oldTree = tree)
+ * val diff = tree.diff(newTree)
+ * for (i in 0..<diff.size) {
+ *     println("${diff.kind(i)} ${language.symbolName(diff.symbol(i))}")
+ * }
+ * ```
+ *
+ * @since 0.26.0
+ */
+class TreeDiff internal constructor(private val edits: IntArray) {
+    /** The number of edits. */
+    val size: Int = edits.size / EDIT_SIZE
+
+    /** Get the kind of the given edit. */
+    @Throws(IndexOutOfBoundsException::class)
+    fun kind(index: Int): Kind = Kind.entries[field(index, KIND)]
+
+    /** Get the symbol of the node of the given edit. */
+    @Throws(IndexOutOfBoundsException::class)
+    fun symbol(index: Int): UShort = field(index, SYMBOL).toUShort()
+
+    /**
+     * Get the start byte of the old node of the given edit,
+     * or [UInt.MAX_VALUE] if the node was inserted.
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun oldStartByte(index: Int): UInt = field(index, OLD_START_BYTE).toUInt()
+
+    /**
+     * Get the end byte of the old node of the given edit,
+     * or [UInt.MAX_VALUE] if the node was inserted.
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun oldEndByte(index: Int): UInt = field(index, OLD_END_BYTE).toUInt()
+
+    /**
+     * Get the start byte of the new node of the given edit,
+     * or [UInt.MAX_VALUE] if the node was deleted.
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun newStartByte(index: Int): UInt = field(index, NEW_START_BYTE).toUInt()
+
+    /**
+     * Get the end byte of the new node of the given edit,
+     * or [UInt.MAX_VALUE] if the node was deleted.
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun newEndByte(index: Int): UInt = field(index, NEW_END_BYTE).toUInt()
+
+    /**
+     * Get the start row of the old node of the given edit,
+     * or [UInt.MAX_VALUE] if the node was inserted.
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun oldStartRow(index: Int): UInt = field(index, OLD_START_ROW).toUInt()
+
+    /**
+     * Get the start row of the new node of the given edit,
+     * or [UInt.MAX_VALUE] if the node was deleted.
+     */
+    @Throws(IndexOutOfBoundsException::class)
+    fun newStartRow(index: Int): UInt = field(index, NEW_START_ROW).toUInt()
+
+    /**
+     * Get a copy of the packed edits.
+     *
+     * Every edit consists of eight integers: the kind, the symbol,
+     * the start and end bytes of the old node, the start and end
+     * bytes of the new node, and the start rows of both nodes.
+     */
+    fun toIntArray(): IntArray = edits.copyOf()
+
+    override fun toString() = "TreeDiff(size=$size)"
+
+    private fun field(index: Int, offset: Int): Int {
+        if (index < 0 || index >= size)
+            throw IndexOutOfBoundsException("Edit index $index is out of bounds")
+        return edits[index * EDIT_SIZE + offset]
+    }
+
+    /** The kind of an edit. */
+    enum class Kind {
+        /** A node of the new tree that has no counterpart in the old tree. */
+        INSERTED,
+
+        /** A node of the old tree that has no counterpart in the new tree. */
+        DELETED,
+
+        /** A node whose own tokens have changed, such as a renamed identifier. */
+        UPDATED,
+
+        /** A node that was reused under another parent, or in another order. */
+        MOVED
+    }
+
+    private companion object {
+        private const val EDIT_SIZE = 8
+
+        private const val KIND = 0
+
+        private const val SYMBOL = 1
+
+        private const val OLD_START_BYTE = 2
+
+        private const val OLD_END_BYTE = 3
+
+        private const val NEW_START_BYTE = 4
+
+        private const val NEW_END_BYTE = 5
+
+        private const val OLD_START_ROW = 6
+
+        private const val NEW_START_ROW = 7
+    }
+}
@@ -14,3 +14,54 @@ const val LANGUAGE_VERSION: UInt = 15U
 
 /** The earliest ABI version that is supported by the current version of the library. */
 const val MIN_COMPATIBLE_LANGUAGE_VERSION: UInt = 13U
+
+/**
+ * Global settings and statistics of the native library.
+ *
+ * @since 0.26.0
+ */
+expect object TreeSitter {
+    /** The allocator that is used by the native library. */
+    val allocator: NativeAllocator
+
+    /**
+     * The number of bytes that are currently allocated by the native library.
+     *
+     * This is always `0` when the [allocator] is [NativeAllocator.SYSTEM].
+     */
+    val allocatedBytes: ULong
+
+    /**
+     * The highest number of bytes that have been allocated at once.
+     *
+     * This is always `0` when the [allocator] is [NativeAllocator.SYSTEM].
+     */
+    val peakAllocatedBytes: ULong
+
+    /**
+     * The number of memory blocks that are currently allocated by the native library.
+     *
+     * This is always `0` when the [allocator] is [NativeAllocator.SYSTEM].
+     */
+    val allocationCount: ULong
+
+    /**
+     * Get the native memory that is held by the live parsers, trees and queries.
+     */
+    fun nativeMemoryStats(): NativeMemoryStats
+
+    /**
+     * Get the number of bytes of native memory that are held by the given trees.
+     *
+     * Unlike the sum of their [sizes][Tree.nativeSizeBytes],
+     * subtrees that are shared between the trees are only counted once.
+     */
+    fun nativeSizeBytes(trees: Collection<Tree>): ULong
+}
+
+@Throws(IllegalStateException::class)
+internal fun checkMemoryLimit(limit: ULong) {
+    check(limit == 0UL || TreeSitter.allocator != NativeAllocator.SYSTEM) {
+        "A memory limit requires a tracking allocator"
+    }
+}
@@ -0,0 +1,56 @@
+package io.github.treesitter.ktreesitter
+
+import kotlin.concurrent.atomics.AtomicArray
+import kotlin.concurrent.atomics.ExperimentalAtomicApi
+
+/**
+ * A cache of the [valid symbols][Language.validSymbols] of every parse state of a language.
+ *
+ * The symbols of a state never change, so they are only computed the first time
+ * that the state is requested. This is useful for completion engines, which
+ * query the same few states on every keystroke.
+ *
+ * The cache is thread safe. If two threads request the same state before
+ * it has been cached, both of them compute it, and the first result is kept.
+ *
+ * The returned arrays are shared between callers and must not be modified.
+ *
+ * #### Example
+ *
+ * ```kotlin
+ * val cache = ValidSymbolsCache(language)
+ * val expected = cache[language.nextState(node.parseState, node.grammarSymbol)]
+ * ```
+ *
+ * @since 0.26.0
+ */
+@OptIn(ExperimentalAtomicApi::class, ExperimentalUnsignedTypes::class)
+class ValidSymbolsCache(val language: Language) {
+    private val states = AtomicArray(arrayOfNulls<UShortArray>(language.stateCount.toInt()))
+
+    /**
+     * Get the symbols that are valid in the given parse state.
+     *
+     * @throws [IllegalArgumentException] If the state is invalid for this language.
+     */
+    @Throws(IllegalArgumentException::class)
+    operator fun get(state: UShort): UShortArray {
+        val index = state.toInt()
+        if (index >= states.size)
+            throw IllegalArgumentException("State $state is not valid for $language")
+        states.loadAt(index)?.let { return it }
+        val symbols = language.validSymbols(state)
+        return if (states.compareAndSetAt(index, null, symbols)) symbols else states.loadAt(index)!!
+    }
+
+    /** Check if the symbols of the given parse state have already been cached. */
+    fun isCached(state: UShort) =
+        state.toInt() < states.size && states.loadAt(state.toInt()) != null
+
+    /** Remove all the cached symbols. */
+    fun clear() {
+        for (index in 0 until states.size) states.storeAt(index, null)
+    }
+
+    override fun toString() = "ValidSymbolsCache(language=$language)"
+}
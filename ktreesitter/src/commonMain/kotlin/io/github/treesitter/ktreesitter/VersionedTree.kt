@@ -0,0 +1,187 @@
+package io.github.treesitter.ktreesitter
+
+import kotlin.concurrent.atomics.AtomicBoolean
+import kotlin.concurrent.atomics.AtomicInt
+import kotlin.concurrent.atomics.AtomicReference
+import kotlin.concurrent.atomics.ExperimentalAtomicApi
+
+/**
+ * A syntax tree that is updated by a single writer and read by any number
+ * of concurrent readers through immutable [snapshots][Snapshot].
+ *
+ * Every [update] parses a new version of the source code and publishes it
+ * without blocking readers. Readers call [snapshot] to get a private copy
+ * of the current version, which shares its subtrees with every other copy.
+ * The tree of an old version is freed as soon as it is replaced and no
+ * snapshot is being taken from it, rather than when the garbage collector
+ * gets to it. The copy of a snapshot is only freed by the garbage collector,
+ * so that the trees and nodes that readers keep remain valid.
+ *
+ * @constructor Parse the initial [source] code with the given [parser].
+ *  The parser must only be used by the writer afterwards.
+ * @throws [IllegalStateException]
+ *  If the parser does not have a [language][Parser.language] assigned.
+ * @since 0.26.0
+ */
+@OptIn(ExperimentalAtomicApi::class)
+class VersionedTree @Throws(IllegalStateException::class) constructor(
+    private val parser: Parser,
+    source: String
+) : AutoCloseable {
+    private val current = AtomicReference(Version(parser.parse(source), 0L))
+
+    private val isUpdating = AtomicBoolean(false)
+
+    private val isClosed = AtomicBoolean(false)
+
+    /** The number of the current version, which starts at `0`. */
+    val version: Long
+        get() = current.load().number
+
+    /**
+     * Take a snapshot of the current version.
+     *
+     * This never blocks, and it is safe to call from any thread.
+     *
+     * @throws [IllegalStateException] If the versioned tree has been closed.
+     */
+    @Throws(IllegalStateException::class)
+    fun snapshot(): Snapshot {
+        while (true) {
+            val version = current.load()
+            if (!version.acquire()) {
+                check(!isClosed.load()) { "The versioned tree has been closed" }
+                continue
+            }
+            try {
+                return Snapshot(version.tree.copy(), version.number)
+            } finally {
+                version.release()
+            }
+        }
+    }
+
+    /**
+     * Publish a new version of the source code, which is parsed
+     * with [Parser.reparse] against the current version.
+     *
+     * Updates must not be made from more than one thread at a time.
+     *
+     * @return The number of the new version.
+     * @throws [IllegalStateException]
+     *  If the versioned tree has been closed, if another update
+     *  is in progress, or if parsing failed.
+     * @throws [MemoryLimitExceededException]
+     *  If the [memory limit][Parser.memoryLimitBytes] of the parser is exceeded.
+     */
+    @Throws(IllegalStateException::class)
+    fun update(newSource: String): Long = write { parser.reparse(it, newSource) }
+
+    /**
+     * Publish a new version of the source code, which is parsed after
+     * applying the given [edits] to a copy of the current version.
+     *
+     * Updates must not be made from more than one thread at a time.
+     *
+     * @return The number of the new version.
+     * @throws [IllegalStateException]
+     *  If the versioned tree has been closed, if another update
+     *  is in progress, or if parsing failed.
+     * @throws [MemoryLimitExceededException]
+     *  If the [memory limit][Parser.memoryLimitBytes] of the parser is exceeded.
+     */
+    @Throws(IllegalStateException::class)
+    fun update(newSource: String, edits: List<InputEdit>): Long = write {
+        val editedTree = it.copy()
+        try {
+            editedTree.edit(edits)
+            parser.parse(newSource, oldTree = editedTree)
+        } finally {
+            editedTree.release()
+        }
+    }
+
+    /**
+     * Release the current version.
+     *
+     * Snapshots that were already taken remain valid until they are closed.
+     * This must be called by the writer, not concurrently with an [update].
+     */
+    override fun close() {
+        if (isClosed.compareAndSet(expectedValue = false, newValue = true)) {
+            current.load().release()
+        }
+    }
+
+    override fun toString() = "VersionedTree(version=$version)"
+
+    private inline fun write(parse: (Tree) -> Tree): Long {
+        check(isUpdating.compareAndSet(expectedValue = false, newValue = true)) {
+            "Another update is in progress"
+        }
+        try {
+            check(!isClosed.load()) { "The versioned tree has been closed" }
+            val previous = current.load()
+            val next = Version(parse(previous.tree), previous.number + 1)
+            current.store(next)
+            previous.release()
+            return next.number
+        } finally {
+            isUpdating.store(false)
+        }
+    }
+
+    /** A published version, which is released when it is no longer current. */
+    private class Version(val tree: Tree, val number: Long) {
+        /** The number of references, including one while the version is current. */
+        private val references = AtomicInt(1)
+
+        fun acquire(): Boolean {
+            while (true) {
+                val count = references.load()
+                if (count == 0) return false
+                if (references.compareAndSet(count, count + 1)) return true
+            }
+        }
+
+        fun release() {
+            if (references.decrementAndFetch() == 0) tree.release()
+        }
+    }
+
+    /**
+     * An immutable snapshot of a version, which must only be used by one thread at a time.
+     *
+     * Close the snapshot when you are done with it, so that it cannot be read anymore.
+     * The [tree] and the nodes that were taken from it before then remain valid.
+     *
+     * @since 0.26.0
+     */
+    class Snapshot internal constructor(
+        private val snapshotTree: Tree,
+        /** The number of the version of the snapshot. */
+        val version: Long
+    ) : AutoCloseable {
+        private val isClosed = AtomicBoolean(false)
+
+        /**
+         * The syntax tree of the snapshot.
+         *
+         * @throws [IllegalStateException] If the snapshot has been closed.
+         */
+        val tree: Tree
+            get() {
+                check(!isClosed.load()) { "The snapshot has been closed" }
+                return snapshotTree
+            }
+
+        /** The source code of the snapshot. */
+        fun text(): CharSequence? = tree.text()
+
+        override fun close() {
+            isClosed.store(true)
+        }
+
+        override fun toString() = "Snapshot(version=$version)"
+    }
+}
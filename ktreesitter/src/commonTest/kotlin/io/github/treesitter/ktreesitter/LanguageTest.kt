@@ -1,6 +1,7 @@
 package io.github.treesitter.ktreesitter
 
 import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import io.kotest.assertions.throwables.shouldThrow
 import io.kotest.core.spec.style.FunSpec
 import io.kotest.matchers.*
 import io.kotest.matchers.collections.shouldBeEmpty
@@ -87,6 +88,22 @@ class LanguageTest : FunSpec({
         lookahead.language shouldBe language
     }
 
+    test("validSymbols()") {
+        val program = language.symbolForName("program", true)
+        val state = language.nextState(1U, program)
+        val symbols = language.validSymbols(state)
+        symbols.toList() shouldBe language.lookaheadIterator(state).symbols().toList()
+        shouldThrow<IllegalArgumentException> {
+            language.validSymbols(UShort.MAX_VALUE)
+        }
+    }
+
+    test("load()") {
+        shouldThrow<IllegalArgumentException> {
+            Language.load("/nonexistent/libtree-sitter-java.so")
+        }.message shouldStartWith "Failed to load the library"
+    }
+
     test("equals()") {
         Language(TreeSitterJava.language()) shouldBe language.copy()
     }
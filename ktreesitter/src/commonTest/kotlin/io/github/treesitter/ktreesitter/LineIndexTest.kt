@@ -0,0 +1,66 @@
+package io.github.treesitter.ktreesitter
+
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import io.kotest.assertions.throwables.shouldThrow
+import io.kotest.core.spec.style.FunSpec
+import io.kotest.matchers.*
+import io.kotest.matchers.nulls.*
+import io.kotest.matchers.types.*
+
+class LineIndexTest : FunSpec({
+    val source = "class Foo {\n  String s = \"é\";\n}\n"
+    val index = LineIndex(source)
+
+    test("lineCount") {
+        index.lineCount shouldBe 4
+        LineIndex("").lineCount shouldBe 1
+    }
+
+    test("pointAt()") {
+        index.pointAt(0U) shouldBe Point(0U, 0U)
+        index.pointAt(14U) shouldBe Point(1U, 2U)
+        index.pointAt(LineIndex.Position(1U, 16U)) shouldBe Point(1U, 17U)
+    }
+
+    test("byteAt()") {
+        index.byteAt(Point(1U, 2U)) shouldBe 14U
+        index.byteAt(Point(0U, 100U)) shouldBe 11U
+        index.byteAt(13) shouldBe 13U
+        index.byteAt(29) shouldBe 30U
+        index.byteAt(LineIndex.Position(2U, 0U)) shouldBe 31U
+    }
+
+    test("indexAt()") {
+        index.indexAt(30U) shouldBe 29
+        index.indexAt(32U) shouldBe 31
+    }
+
+    test("positionAt()") {
+        index.positionAt(30U) shouldBe LineIndex.Position(1U, 17U)
+        index.positionAt(Point(1U, 17U)) shouldBe LineIndex.Position(1U, 16U)
+    }
+
+    test("edit()") {
+        val lines = LineIndex("a\nb\nc")
+        val edit = lines.edit("a\nxy\nz\nb\nc", 2, 2, 7)
+        edit.startByte shouldBe 2U
+        edit.oldEndByte shouldBe 2U
+        edit.newEndByte shouldBe 7U
+        edit.startPoint shouldBe Point(1U, 0U)
+        edit.newEndPoint shouldBe Point(3U, 0U)
+        lines.lineCount shouldBe 5
+        lines.byteAt(Point(4U, 0U)) shouldBe 9U
+        shouldThrow<IndexOutOfBoundsException> { lines.edit("", 0, 100, 0) }
+    }
+
+    test("startPosition()") {
+        val parser = Parser(Language(TreeSitterJava.language()))
+        val tree = parser.parse(source)
+        val lineIndex = tree.lineIndex().shouldNotBeNull()
+        tree.lineIndex() shouldBeSameInstanceAs lineIndex
+        val string = tree.rootNode.descendant(14U, 14U)!!
+        string.type shouldBe "type_identifier"
+        lineIndex.startPosition(string) shouldBe LineIndex.Position(1U, 2U)
+        lineIndex.endPosition(string) shouldBe LineIndex.Position(1U, 8U)
+    }
+})
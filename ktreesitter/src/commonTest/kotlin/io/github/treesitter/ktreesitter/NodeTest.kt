@@ -229,6 +229,15 @@ class NodeTest : FunSpec({
             "(class_declaration name: (identifier) body: (class_body))"
     }
 
+    @OptIn(ExperimentalUnsignedTypes::class)
+    test("symbolHistogram()") {
+        val histogram = rootNode.symbolHistogram()
+        histogram.size shouldBe language.symbolCount.toInt()
+        histogram.sum() shouldBe 7U
+        histogram[language.symbolForName("identifier", true).toInt()] shouldBe 1U
+        histogram[language.symbolForName("class", false).toInt()] shouldBe 1U
+    }
+
     test("equals()") {
         rootNode shouldNotBe rootNode.child(0U)
     }
@@ -0,0 +1,35 @@
+package io.github.treesitter.ktreesitter
+
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import io.github.treesitter.ktreesitter.java.nodes.*
+import io.kotest.core.spec.style.FunSpec
+import io.kotest.matchers.*
+import io.kotest.matchers.nulls.*
+
+class NodeTypesTest : FunSpec({
+    val language = Language(TreeSitterJava.language())
+    val tree = Parser(language).parse("class Foo { void bar() {} }")
+
+    test("Symbols") {
+        Symbols.CLASS_DECLARATION shouldBe language.symbolForName("class_declaration", true)
+        Symbols.PROGRAM shouldBe tree.rootNode.symbol
+    }
+
+    test("Fields") {
+        Fields.NAME shouldBe language.fieldIdForName("name")
+        Fields.BODY shouldBe language.fieldIdForName("body")
+    }
+
+    test("Supertypes") {
+        Supertypes.isDeclaration(Symbols.CLASS_DECLARATION) shouldBe true
+        Supertypes.isDeclaration(Symbols.PROGRAM) shouldBe false
+    }
+
+    test("Nodes") {
+        val classNode = tree.rootNode.child(0U)!!
+        val method = ClassDeclaration.of(classNode)?.body?.namedChild(0U)
+        method.shouldNotBeNull()
+        MethodDeclaration.of(method)?.name?.text() shouldBe "bar"
+        MethodDeclaration.of(classNode).shouldBeNull()
+    }
+})
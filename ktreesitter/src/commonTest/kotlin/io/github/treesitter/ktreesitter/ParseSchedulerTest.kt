@@ -0,0 +1,54 @@
+package io.github.treesitter.ktreesitter
+
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import io.kotest.assertions.throwables.shouldThrow
+import io.kotest.core.spec.style.FunSpec
+import io.kotest.matchers.*
+import io.kotest.matchers.collections.*
+import io.kotest.matchers.ints.*
+import kotlin.time.Duration.Companion.microseconds
+
+class ParseSchedulerTest : FunSpec({
+    val language = Language(TreeSitterJava.language())
+
+    test("submit()") {
+        val scheduler = ParseScheduler()
+        val parser = Parser(language)
+        var tree: Tree? = null
+        val task = scheduler.submit(parser, "class Foo {}") { tree = it.getOrThrow() }
+        shouldThrow<IllegalArgumentException> { scheduler.submit(parser, "") { } }
+        scheduler.pendingTasks shouldBe 1
+        scheduler.runUntilIdle()
+        task.isDone shouldBe true
+        tree?.rootNode?.type shouldBe "program"
+        scheduler.pendingTasks shouldBe 0
+    }
+
+    test("runSlice()") {
+        val scheduler = ParseScheduler(1.microseconds)
+        val members = (0 until 20000).joinToString("\n") { "  int field$it;" }
+        val completed = mutableListOf<String>()
+        val large = scheduler.submit(Parser(language), "class Large {\n$members\n}") {
+            it.getOrThrow().rootNode.hasError shouldBe false
+            completed += "large"
+        }
+        scheduler.runSlice() shouldBe true
+        scheduler.submit(Parser(language), "class Small {}") { completed += "small" }
+        scheduler.submit(Parser(language), "class Urgent {}", priority = 1) {
+            completed += "urgent"
+        }
+        scheduler.runUntilIdle()
+        completed shouldContainExactly listOf("urgent", "small", "large")
+        large.slices shouldBeGreaterThan 1
+    }
+
+    test("cancel()") {
+        val scheduler = ParseScheduler()
+        val task = scheduler.submit(Parser(language), "class Foo {}") {
+            error("Cancelled tasks must not complete")
+        }
+        task.cancel() shouldBe true
+        task.cancel() shouldBe false
+        scheduler.runSlice() shouldBe false
+    }
+})
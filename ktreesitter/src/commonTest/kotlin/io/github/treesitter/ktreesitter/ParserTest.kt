@@ -2,10 +2,12 @@ package io.github.treesitter.ktreesitter
 
 import io.github.treesitter.ktreesitter.java.TreeSitterJava
 import io.kotest.assertions.throwables.shouldNotThrowAnyUnit
+import io.kotest.assertions.throwables.shouldThrow
 import io.kotest.core.spec.style.FunSpec
 import io.kotest.inspectors.forSome
 import io.kotest.matchers.*
 import io.kotest.matchers.collections.*
+import io.kotest.matchers.ints.*
 import io.kotest.matchers.nulls.*
 import io.kotest.matchers.string.*
 import io.kotest.matchers.types.*
@@ -35,6 +37,39 @@ class ParserTest : FunSpec({
         }
     }
 
+    test("memoryLimitBytes") {
+        parser.memoryLimitBytes shouldBe 0UL
+        if (TreeSitter.allocator == NativeAllocator.SYSTEM) {
+            shouldThrow<IllegalStateException> { parser.memoryLimitBytes = 1UL }
+        } else {
+            parser.memoryLimitBytes = 1UL
+            shouldThrow<MemoryLimitExceededException> { parser.parse("class Foo {}") }
+            parser.memoryLimitBytes = 0UL
+            parser.parse("class Foo {}").rootNode.type shouldBe "program"
+        }
+    }
+
+    test("progressListener") {
+        val source = "class Foo {}\n".repeat(1000)
+        var calls = 0
+        parser.progressListener = ParseProgressListener { _, _ ->
+            calls += 1
+            false
+        }
+        parser.parse(source).rootNode.hasError shouldBe false
+        val everyCheck = calls
+        everyCheck shouldBeGreaterThan 1
+
+        calls = 0
+        parser.progressIntervalBytes = 4096U
+        parser.parse(source)
+        calls shouldBeInRange 1..<everyCheck
+
+        parser.progressListener = ParseProgressListener { offset, _ -> offset >= 0 }
+        shouldThrow<IllegalStateException> { parser.parse(source) }
+        parser.reset()
+    }
+
     test("parse(source)") {
         // UTF-8
         var source = "class Foo {}"
@@ -67,10 +102,29 @@ class ParserTest : FunSpec({
         tree.rootNode.type shouldBe "program"
     }
 
+    test("reparse()") {
+        val oldTree = parser.parse("class Foo {}")
+        val tree = parser.reparse(oldTree, "class Foo {\n  int bar;\n}")
+        tree.text() shouldBe "class Foo {\n  int bar;\n}"
+        tree.rootNode.hasError shouldBe false
+        tree.rootNode.child(0U)?.child(2U)?.child(1U)?.type shouldBe "field_declaration"
+        oldTree.rootNode.endByte shouldBe 12U
+        shouldThrow<IllegalArgumentException> {
+            parser.reparse(parser.parse { _, _ -> null }, "")
+        }
+        shouldThrow<IllegalArgumentException> {
+            parser.reparse(parser.parse("class Foo {}", InputEncoding.UTF_16LE), "")
+        }
+    }
+
     afterTest { (test, _) ->
         when (test.name.name) {
             "includedRanges" -> parser.includedRanges = emptyList()
             "logger" -> parser.logger = null
+            "progressListener" -> {
+                parser.progressListener = null
+                parser.progressIntervalBytes = 0U
+            }
         }
     }
 })
@@ -1,11 +1,13 @@
 package io.github.treesitter.ktreesitter
 
 import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import io.kotest.assertions.throwables.shouldThrow
 import io.kotest.core.spec.style.FunSpec
 import io.kotest.inspectors.forAll
 import io.kotest.inspectors.forSingle
 import io.kotest.matchers.*
 import io.kotest.matchers.collections.*
+import io.kotest.matchers.ints.*
 
 class QueryCursorTest :
     FunSpec({
@@ -42,6 +44,31 @@ class QueryCursorTest :
             cursor.maxStartDepth shouldBe 10U
         }
 
+        test("memoryLimitBytes") {
+            val cursor = query(parser.parse("class Foo {}\n".repeat(100)).rootNode)
+            cursor.memoryLimitBytes shouldBe 0UL
+            if (TreeSitter.allocator == NativeAllocator.SYSTEM) {
+                shouldThrow<IllegalStateException> { cursor.memoryLimitBytes = 1UL }
+            } else {
+                cursor.memoryLimitBytes = 1UL
+                shouldThrow<MemoryLimitExceededException> { cursor.captures().toList() }
+            }
+        }
+
+        test("progressListener") {
+            val node = parser.parse("class Foo {}\n".repeat(100)).rootNode
+            val count = query(node).captures().count()
+            val cursor = query(node)
+            cursor.progressListener shouldBe null
+            var calls = 0
+            cursor.progressListener = QueryProgressListener {
+                calls += 1
+                true
+            }
+            cursor.captures().count() shouldBeLessThan count
+            calls shouldBe 1
+        }
+
         test("byteRange") {
             val cursor = query(tree.rootNode)
             cursor.byteRange = 0U..10U
@@ -59,6 +86,50 @@ class QueryCursorTest :
             cursor.didExceedMatchLimit shouldBe false
         }
 
+        test("profile") {
+            val cursor = query(tree.rootNode)
+            cursor.profile shouldBe null
+            shouldThrow<IllegalArgumentException> {
+                cursor.profile = QueryProfile(Query(language, "(identifier) @id"))
+            }
+
+            val profiled = Query(
+                language,
+                """
+            (class_declaration) @class
+
+            ((identifier) @foo
+             (#eq? @foo "Foo"))
+                """.trimIndent()
+            )
+            val profile = QueryProfile(profiled)
+            val tree = parser.parse("class Foo {}\nclass Bar {}")
+            profiled(tree.rootNode).apply { this.profile = profile }.matches().count() shouldBe 3
+            profile.executions shouldBe 1UL
+            profile.matchLimitExceeded shouldBe 0UL
+            profile.byStartByte.keys.shouldContainExactly(0U, profiled.startByteForPattern(1U))
+            profile.patterns[0].matches shouldBe 2UL
+            profile.patterns[0].rejected shouldBe 0UL
+            profile.patterns[1].matches shouldBe 2UL
+            profile.patterns[1].accepted shouldBe 1UL
+            profile.patterns[1].captures shouldBe 2UL
+
+            profile.reset()
+            profile.executions shouldBe 0UL
+            profile.patterns.forAll { it.matches shouldBe 0UL }
+
+            val captured = Query(
+                language,
+                "(class_declaration name: (identifier) @name body: (class_body) @body) @class"
+            )
+            val captureProfile = QueryProfile(captured)
+            captured(tree.rootNode).apply { this.profile = captureProfile }
+                .captures().count() shouldBe 6
+            captureProfile.executions shouldBe 1UL
+            captureProfile.patterns[0].matches shouldBe 2UL
+            captureProfile.patterns[0].captures shouldBe 6UL
+        }
+
         test("matches()") {
             var cursor = query(tree.rootNode)
             var matches = cursor.matches().toList()
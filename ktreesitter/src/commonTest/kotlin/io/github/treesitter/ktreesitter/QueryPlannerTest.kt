@@ -0,0 +1,62 @@
+package io.github.treesitter.ktreesitter
+
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import io.kotest.assertions.throwables.shouldThrow
+import io.kotest.core.spec.style.FunSpec
+import io.kotest.matchers.*
+import io.kotest.matchers.collections.*
+import io.kotest.matchers.nulls.*
+
+class QueryPlannerTest : FunSpec({
+    val language = Language(TreeSitterJava.language())
+    val parser = Parser(language)
+    val source = """
+    (method_declaration name: (identifier) @method)
+
+    (class_declaration
+        name: (identifier) @class
+        (class_body (field_declaration)? @field))
+
+    [(while_statement) (for_statement)] @loop
+
+    ((string_literal) @string (#eq? @string "\"foo\""))
+    """.trimIndent()
+
+    fun symbol(name: String) = language.symbolForName(name, true)
+
+    @OptIn(ExperimentalUnsignedTypes::class)
+    test("requiredSymbols()") {
+        val planner = QueryPlanner(language, source)
+        planner.requiredSymbols(0U).toList() shouldContainExactlyInAnyOrder
+            listOf(symbol("method_declaration"), symbol("identifier"))
+        planner.requiredSymbols(1U).toList() shouldContainExactlyInAnyOrder
+            listOf(symbol("class_declaration"), symbol("identifier"), symbol("class_body"))
+        planner.requiredSymbols(2U).toList().shouldBeEmpty()
+        planner.requiredSymbols(3U).toList() shouldContainExactly listOf(symbol("string_literal"))
+        shouldThrow<IndexOutOfBoundsException> { planner.requiredSymbols(4U) }
+    }
+
+    test("possiblePatterns()") {
+        val planner = QueryPlanner(language, source)
+        val tree = parser.parse("class Foo { int x; }")
+        planner.possiblePatterns(tree.rootNode) shouldBe listOf(1U, 2U)
+        planner.disablePattern(2U)
+        planner.possiblePatterns(tree.rootNode) shouldBe listOf(1U)
+    }
+
+    test("invoke()") {
+        val planner = QueryPlanner(language, source)
+        val tree = parser.parse("class Foo { String s = \"foo\"; }")
+        val planned = planner(tree.rootNode).shouldNotBeNull().matches().toList()
+        val unplanned = planner.query(tree.rootNode).matches().toList()
+        planned.map { it.patternIndex } shouldBe unplanned.map { it.patternIndex }
+        planned.map { it.captures.map(QueryCapture::node) } shouldBe
+            unplanned.map { it.captures.map(QueryCapture::node) }
+
+        planner(parser.parse("").rootNode).shouldNotBeNull()
+        planner.disablePattern(2U)
+        planner(parser.parse("").rootNode).shouldBeNull()
+        planner(tree.rootNode).shouldNotBeNull().matches().map { it.patternIndex }.toList() shouldBe
+            listOf(1U, 3U)
+    }
+})
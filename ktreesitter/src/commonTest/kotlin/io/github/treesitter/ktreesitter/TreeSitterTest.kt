@@ -0,0 +1,48 @@
+package io.github.treesitter.ktreesitter
+
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import io.kotest.core.spec.style.FunSpec
+import io.kotest.matchers.*
+import io.kotest.matchers.comparables.*
+
+class TreeSitterTest : FunSpec({
+    val language = Language(TreeSitterJava.language())
+
+    test("allocatedBytes") {
+        if (TreeSitter.allocator == NativeAllocator.SYSTEM) {
+            TreeSitter.allocatedBytes shouldBe 0UL
+        } else {
+            val before = TreeSitter.allocatedBytes
+            val parser = Parser(language)
+            val tree = parser.parse("class Foo {}")
+            TreeSitter.allocatedBytes shouldBeGreaterThan before
+            TreeSitter.allocationCount shouldBeGreaterThan 0UL
+            tree.rootNode.childCount shouldBe 1U
+        }
+    }
+
+    test("peakAllocatedBytes") {
+        TreeSitter.peakAllocatedBytes shouldBeGreaterThanOrEqualTo TreeSitter.allocatedBytes
+    }
+
+    test("nativeMemoryStats()") {
+        val parser = Parser(language)
+        val tree = parser.parse("class Foo {}")
+        val stats = TreeSitter.nativeMemoryStats()
+        stats.parsers.liveObjects shouldBeGreaterThan 0UL
+        stats.trees.liveObjects shouldBeGreaterThan 0UL
+        if (TreeSitter.allocator != NativeAllocator.SYSTEM) {
+            stats.trees.bytes shouldBeGreaterThan 0UL
+            parser.nativeSizeBytes shouldBeGreaterThan 0UL
+        }
+        tree.rootNode.childCount shouldBe 1U
+    }
+
+    test("nativeSizeBytes()") {
+        val tree = Parser(language).parse("class Foo {}")
+        val size = TreeSitter.nativeSizeBytes(listOf(tree))
+        size shouldBeGreaterThan 0UL
+        TreeSitter.nativeSizeBytes(listOf(tree, tree.copy())) shouldBeLessThan size * 2UL
+        TreeSitter.nativeSizeBytes(emptyList()) shouldBe 0UL
+    }
+})
@@ -0,0 +1,30 @@
+package io.github.treesitter.ktreesitter
+
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import io.kotest.assertions.throwables.shouldThrow
+import io.kotest.core.spec.style.FunSpec
+import io.kotest.matchers.*
+import io.kotest.matchers.booleans.*
+import io.kotest.matchers.types.*
+
+class ValidSymbolsCacheTest : FunSpec({
+    val language = Language(TreeSitterJava.language())
+    val state = language.nextState(1U, language.symbolForName("program", true))
+
+    test("get()") {
+        val cache = ValidSymbolsCache(language)
+        cache.isCached(state).shouldBeFalse()
+        val symbols = cache[state]
+        symbols.toList() shouldBe language.validSymbols(state).toList()
+        cache.isCached(state).shouldBeTrue()
+        cache[state] shouldBeSameInstanceAs symbols
+        shouldThrow<IllegalArgumentException> { cache[UShort.MAX_VALUE] }
+    }
+
+    test("clear()") {
+        val cache = ValidSymbolsCache(language)
+        cache[state]
+        cache.clear()
+        cache.isCached(state).shouldBeFalse()
+    }
+})
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/** The calls from the JVM into the cursor and query functions. */
+#define COUNTER_JNI_CALLS 0
+/** The nodes that were marshaled into JVM objects. */
+#define COUNTER_NODES 1
+/** The other objects that were marshaled, such as points, ranges, captures and matches. */
+#define COUNTER_OBJECTS 2
+
+#define COUNTER_KIND_COUNT 3
+
+extern bool counters_enabled;
+
+extern uint64_t counters[COUNTER_KIND_COUNT];
+
+/** Check if the counters are enabled. */
+static inline bool counters_get_enabled(void) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return *(volatile bool *)&counters_enabled;
+#else
+    return __atomic_load_n(&counters_enabled, __ATOMIC_RELAXED);
+#endif
+}
+
+/** Enable or disable the counters, without resetting them. */
+static inline void counters_set_enabled(bool enabled) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    *(volatile bool *)&counters_enabled = enabled;
+#else
+    __atomic_store_n(&counters_enabled, enabled, __ATOMIC_RELAXED);
+#endif
+}
+
+/** Get the value of the counter of the given kind. */
+static inline uint64_t counter_get(uint32_t kind) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (uint64_t)_InterlockedOr64((volatile int64_t *)&counters[kind], 0);
+#else
+    return __atomic_load_n(&counters[kind], __ATOMIC_RELAXED);
+#endif
+}
+
+/** Set the counter of the given kind back to `0`. */
+static inline void counter_reset(uint32_t kind) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    _InterlockedExchange64((volatile int64_t *)&counters[kind], 0);
+#else
+    __atomic_store_n(&counters[kind], 0, __ATOMIC_RELAXED);
+#endif
+}
+
+/**
+ * Add the value to the counter of the given kind.
+ *
+ * When the counters are disabled, this is a single well-predicted branch.
+ */
+static inline void count(uint32_t kind, uint64_t value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    if (counters_get_enabled())
+        _InterlockedExchangeAdd64((volatile int64_t *)&counters[kind], (int64_t)value);
+#else
+    if (__builtin_expect(counters_get_enabled(), 0))
+        __atomic_add_fetch(&counters[kind], value, __ATOMIC_RELAXED);
+#endif
+}
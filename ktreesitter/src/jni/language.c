@@ -1,9 +1,22 @@
+#include "loader.h"
 #include "utils.h"
 
 jlong JNICALL language_copy CRITICAL_ARGS(jlong self) {
     return (jlong)ts_language_copy((TSLanguage *)self);
 }
 
+jlong JNICALL language_load(JNIEnv *env, jclass _class, jstring path, jstring symbol) {
+    char error[KTS_LOADER_ERROR_SIZE] = {0};
+    const char *path_chars = (*env)->GetStringUTFChars(env, path, NULL);
+    const char *symbol_chars = (*env)->GetStringUTFChars(env, symbol, NULL);
+    const TSLanguage *language = kts_language_load(path_chars, symbol_chars, error);
+    (*env)->ReleaseStringUTFChars(env, symbol, symbol_chars);
+    (*env)->ReleaseStringUTFChars(env, path, path_chars);
+    if (language == NULL)
+        THROW(IllegalArgumentException, (const char *)error);
+    return (jlong)language;
+}
+
 jint JNICALL language_get_abi_version(JNIEnv *env, jobject this) {
     TSLanguage *self = GET_POINTER(TSLanguage, this, Language_self);
     return (jint)ts_language_abi_version(self);
@@ -130,6 +143,33 @@ jshort JNICALL language_next_state(JNIEnv *env, jobject this, jshort state, jsho
     return (jshort)ts_language_next_state(self, (uint16_t)state, (uint16_t)symbol);
 }
 
+jshortArray JNICALL language_valid_symbols(JNIEnv *env, jobject this, jshort state) {
+    TSLanguage *self = GET_POINTER(TSLanguage, this, Language_self);
+    TSLookaheadIterator *lookahead = ts_lookahead_iterator_new(self, (uint16_t)state);
+    if (lookahead == NULL) {
+        const char *fmt = "State %u is not valid for this language";
+        char buffer[46] = {0}; // length(fmt) + digits(UINT16_MAX)
+        sprintf_s(buffer, 46, fmt, (uint16_t)state);
+        THROW(IllegalArgumentException, (const char *)buffer);
+        return NULL;
+    }
+
+    // Count the symbols first, so that they can be written straight into the array
+    jsize length = 0;
+    while (ts_lookahead_iterator_next(lookahead))
+        length += 1;
+    jshortArray result = (*env)->NewShortArray(env, length);
+    if (result != NULL && length > 0) {
+        ts_lookahead_iterator_reset_state(lookahead, (uint16_t)state);
+        jshort *symbols = (*env)->GetPrimitiveArrayCritical(env, result, NULL);
+        for (jsize i = 0; i < length && ts_lookahead_iterator_next(lookahead); ++i)
+            symbols[i] = (jshort)ts_lookahead_iterator_current_symbol(lookahead);
+        (*env)->ReleasePrimitiveArrayCritical(env, result, symbols, 0);
+    }
+    ts_lookahead_iterator_delete(lookahead);
+    return result;
+}
+
 void JNICALL language_check_version(JNIEnv *env, jobject this) {
     TSLanguage *self = GET_POINTER(TSLanguage, this, Language_self);
     uint32_t version = ts_language_version(self);
@@ -145,6 +185,7 @@ void JNICALL language_check_version(JNIEnv *env, jobject this) {
 
 const JNINativeMethod Language_methods[] = {
     {"copy", "(J)J", (void *)&language_copy},
+    {"loadSymbol", "(Ljava/lang/String;Ljava/lang/String;)J", (void *)&language_load},
     {"getAbiVersion", "()I", (void *)&language_get_abi_version},
     {"getVersion", "()I", (void *)&language_get_version},
     {"getSymbolCount", "()I", (void *)&language_get_symbol_count},
@@ -162,6 +203,7 @@ const JNINativeMethod Language_methods[] = {
     {"fieldNameForId", "(S)Ljava/lang/String;", (void *)&language_field_name_for_id},
     {"fieldIdForName", "(Ljava/lang/String;)S", (void *)&language_field_id_for_name},
     {"nextState", "(SS)S", (void *)&language_next_state},
+    {"validSymbols", "(S)[S", (void *)&language_valid_symbols},
     {"checkVersion", "()V", (void *)&language_check_version},
 };
 
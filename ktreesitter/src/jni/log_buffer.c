@@ -0,0 +1,68 @@
+#include <stdlib.h>
+
+#include "log_buffer.h"
+#include "utils.h"
+
+jlong JNICALL log_buffer_init CRITICAL_ARGS(jint capacity, jboolean lex, jboolean parse) {
+    return (jlong)kts_log_buffer_new((uint32_t)capacity, (bool)lex, (bool)parse);
+}
+
+void JNICALL log_buffer_delete CRITICAL_ARGS(jlong self) {
+    kts_log_buffer_delete((KtsLogBuffer *)self);
+}
+
+jint JNICALL log_buffer_get_size(JNIEnv *env, jobject this) {
+    KtsLogBuffer *self = GET_POINTER(KtsLogBuffer, this, LogBuffer_self);
+    return (jint)kts_log_buffer_count(self);
+}
+
+jlong JNICALL log_buffer_get_dropped_count(JNIEnv *env, jobject this) {
+    KtsLogBuffer *self = GET_POINTER(KtsLogBuffer, this, LogBuffer_self);
+    return (jlong)kts_log_buffer_dropped(self);
+}
+
+jint JNICALL log_buffer_drain(JNIEnv *env, jobject this, jobject function) {
+    KtsLogBuffer *self = GET_POINTER(KtsLogBuffer, this, LogBuffer_self);
+    jint capacity = GET_FIELD(Int, this, LogBuffer_capacity);
+    char *message = (char *)malloc((size_t)capacity + 1);
+    if (message == NULL) {
+        THROW(IllegalStateException, "Failed to allocate the log message");
+        return 0;
+    }
+
+    jobject lex = GET_STATIC_FIELD(Object, Parser$LogType, Parser$LogType_LEX);
+    jobject parse = GET_STATIC_FIELD(Object, Parser$LogType, Parser$LogType_PARSE);
+    TSLogType type;
+    uint32_t length;
+    jint count = 0;
+    while (kts_log_buffer_shift(self, &type, message, &length)) {
+        message[length] = '\0';
+        jstring string = (*env)->NewStringUTF(env, message);
+        jobject type_value = type == TSLogTypeLex ? lex : parse;
+        jobject result = CALL_METHOD(Object, function, Function2_invoke, type_value, string);
+        (*env)->DeleteLocalRef(env, string);
+        if (result != NULL)
+            (*env)->DeleteLocalRef(env, result);
+        count += 1;
+        if ((*env)->ExceptionCheck(env))
+            break;
+    }
+    free(message);
+    return count;
+}
+
+void JNICALL log_buffer_clear(JNIEnv *env, jobject this) {
+    KtsLogBuffer *self = GET_POINTER(KtsLogBuffer, this, LogBuffer_self);
+    kts_log_buffer_clear(self);
+}
+
+const JNINativeMethod LogBuffer_methods[] = {
+    {"init", "(IZZ)J", (void *)&log_buffer_init},
+    {"delete", "(J)V", (void *)&log_buffer_delete},
+    {"getSize", "()I", (void *)&log_buffer_get_size},
+    {"getDroppedCount", "()J", (void *)&log_buffer_get_dropped_count},
+    {"drain", "(Lkotlin/jvm/functions/Function2;)I", (void *)&log_buffer_drain},
+    {"clear", "()V", (void *)&log_buffer_clear},
+};
+
+const size_t LogBuffer_methods_size = sizeof LogBuffer_methods / sizeof(JNINativeMethod);
@@ -1,8 +1,14 @@
+#include <string.h>
+
+#include "allocator.h"
 #include "utils.h"
 
 extern const JNINativeMethod Language_methods[];
 extern const size_t Language_methods_size;
 
+extern const JNINativeMethod LogBuffer_methods[];
+extern const size_t LogBuffer_methods_size;
+
 extern const JNINativeMethod LookaheadIterator_methods[];
 extern const size_t LookaheadIterator_methods_size;
 
@@ -24,6 +30,9 @@ extern const size_t Query_methods_size;
 extern const JNINativeMethod QueryCursor_methods[];
 extern const size_t QueryCursor_methods_size;
 
+extern const JNINativeMethod TreeSitter_methods[];
+extern const size_t TreeSitter_methods_size;
+
 FieldCache global_field_cache = {0};
 MethodCache global_method_cache = {0};
 ClassCache global_class_cache = {0};
@@ -68,6 +77,35 @@ JavaVM *java_vm = NULL;
     global_method_cache._cat2(class, method) =                                                     \
         (*env)->GetStaticMethodID(env, global_class_cache.class, name, type)
 
+static uint32_t configured_allocator(JNIEnv *env) {
+    uint32_t kind = KTS_ALLOCATOR_SYSTEM;
+    const char *name = getenv("KTREESITTER_ALLOCATOR");
+    jstring property = NULL;
+
+    jclass system_class = (*env)->FindClass(env, "java/lang/System");
+    jmethodID get_property = (*env)->GetStaticMethodID(env, system_class, "getProperty",
+                                                       "(Ljava/lang/String;)Ljava/lang/String;");
+    jstring key = (*env)->NewStringUTF(env, "ktreesitter.allocator");
+    property = (jstring)(*env)->CallStaticObjectMethod(env, system_class, get_property, key);
+    if ((*env)->ExceptionCheck(env)) {
+        (*env)->ExceptionClear(env);
+        property = NULL;
+    }
+    if (property != NULL)
+        name = (*env)->GetStringUTFChars(env, property, NULL);
+
+    if (name != NULL && strcmp(name, "tracking") == 0)
+        kind = KTS_ALLOCATOR_TRACKING;
+    else if (name != NULL && strcmp(name, "pooled") == 0)
+        kind = KTS_ALLOCATOR_POOLED;
+
+    if (property != NULL)
+        (*env)->ReleaseStringUTFChars(env, property, name);
+    (*env)->DeleteLocalRef(env, key);
+    (*env)->DeleteLocalRef(env, system_class);
+    return kind;
+}
+
 JNIEXPORT jint JNI_OnLoad(JavaVM *vm, void *_reserved) {
     java_vm = vm;
 
@@ -77,10 +115,23 @@ JNIEXPORT jint JNI_OnLoad(JavaVM *vm, void *_reserved) {
 
     int rc;
 
+    // the allocator must be installed before anything else is allocated
+    uint32_t allocator = configured_allocator(env);
+#ifndef __ANDROID__
+    if (allocator != KTS_ALLOCATOR_SYSTEM)
+        kts_allocator_install(allocator);
+#else
+    kts_allocator_install(allocator);
+#endif
+
     REGISTER_CLASS(Language);
     CACHE_FIELD(Language, self, "J");
     CACHE_METHOD(Language, init, "<init>", "(Ljava/lang/Object;)V");
 
+    REGISTER_CLASS(LogBuffer);
+    CACHE_FIELD(LogBuffer, self, "J");
+    CACHE_FIELD(LogBuffer, capacity, "I");
+
     REGISTER_CLASS(LookaheadIterator);
     CACHE_FIELD(LookaheadIterator, self, "J");
 
@@ -110,14 +161,26 @@ JNIEXPORT jint JNI_OnLoad(JavaVM *vm, void *_reserved) {
     CACHE_FIELD(QueryCursor, self, "J");
     CACHE_FIELD(QueryCursor, matchLimit, "I");
     CACHE_FIELD(QueryCursor, maxStartDepth, "I");
+    CACHE_FIELD(QueryCursor, memoryLimitBytes, "J");
+    CACHE_FIELD(QueryCursor, progressCallback, "Lkotlin/jvm/functions/Function1;");
+    CACHE_FIELD(QueryCursor, progressListener, "L" PACKAGE "QueryProgressListener;");
+    CACHE_FIELD(QueryCursor, progressIntervalBytes, "I");
+    CACHE_FIELD(QueryCursor, progressIntervalMicros, "J");
     CACHE_FIELD(QueryCursor, timeoutMicros, "J");
 
+    REGISTER_CLASS(TreeSitter);
+
     REGISTER_CLASS(Parser);
     CACHE_FIELD(Parser, self, "J");
     CACHE_FIELD(Parser, timeoutMicros, "J");
     CACHE_FIELD(Parser, language, "L" PACKAGE "Language;");
     CACHE_FIELD(Parser, includedRanges, "Ljava/util/List;");
     CACHE_FIELD(Parser, logger, "Lkotlin/jvm/functions/Function2;");
+    CACHE_FIELD(Parser, logBuffer, "L" PACKAGE "LogBuffer;");
+    CACHE_FIELD(Parser, memoryLimitBytes, "J");
+    CACHE_FIELD(Parser, progressListener, "L" PACKAGE "ParseProgressListener;");
+    CACHE_FIELD(Parser, progressIntervalBytes, "I");
+    CACHE_FIELD(Parser, progressIntervalMicros, "J");
 
     CACHE_CLASS(PACKAGE, Point);
     CACHE_FIELD(Point, row, "I");
@@ -142,12 +205,20 @@ JNIEXPORT jint JNI_OnLoad(JavaVM *vm, void *_reserved) {
     CACHE_CLASS(PACKAGE, Language$Metadata);
     CACHE_METHOD(Language$Metadata, init, "<init>", "(Lkotlin/Triple;)V");
 
+    CACHE_CLASS(PACKAGE, MemoryLimitExceededException);
+
     CACHE_CLASS(PACKAGE, QueryCapture);
     CACHE_METHOD(QueryCapture, init, "<init>", "(L" PACKAGE "Node;Ljava/lang/String;)V");
 
     CACHE_CLASS(PACKAGE, QueryMatch);
     CACHE_METHOD(QueryMatch, init, "<init>", "(ILjava/util/List;)V");
 
+    CACHE_CLASS(PACKAGE, ParseProgressListener);
+    CACHE_METHOD(ParseProgressListener, onProgress, "onProgress", "(IZ)Z");
+
+    CACHE_CLASS(PACKAGE, QueryProgressListener);
+    CACHE_METHOD(QueryProgressListener, onProgress, "onProgress", "(I)Z");
+
     CACHE_CLASS(PACKAGE, Parser$LogType);
     CACHE_STATIC_FIELD(Parser$LogType, LEX, "L" PACKAGE "Parser$LogType;");
     CACHE_STATIC_FIELD(Parser$LogType, PARSE, "L" PACKAGE "Parser$LogType;");
@@ -212,10 +283,6 @@ JNIEXPORT jint JNI_OnLoad(JavaVM *vm, void *_reserved) {
     CACHE_CLASS("java/lang/", IllegalStateException);
     CACHE_CLASS("java/lang/", IndexOutOfBoundsException);
 
-#ifdef __ANDROID__
-    ts_set_allocator(malloc, calloc, realloc, free);
-#endif
-
     return JNI_VERSION_1_6;
 }
 
@@ -237,9 +304,12 @@ JNIEXPORT void JNI_OnUnload(JavaVM *vm, void *_reserved) {
     (*env)->DeleteGlobalRef(env, global_class_cache.Language);
     (*env)->DeleteGlobalRef(env, global_class_cache.Language$Metadata);
     (*env)->DeleteGlobalRef(env, global_class_cache.List);
+    (*env)->DeleteGlobalRef(env, global_class_cache.LogBuffer);
     (*env)->DeleteGlobalRef(env, global_class_cache.LookaheadIterator);
+    (*env)->DeleteGlobalRef(env, global_class_cache.MemoryLimitExceededException);
     (*env)->DeleteGlobalRef(env, global_class_cache.Node);
     (*env)->DeleteGlobalRef(env, global_class_cache.Pair);
+    (*env)->DeleteGlobalRef(env, global_class_cache.ParseProgressListener);
     (*env)->DeleteGlobalRef(env, global_class_cache.Parser);
     (*env)->DeleteGlobalRef(env, global_class_cache.Point);
     (*env)->DeleteGlobalRef(env, global_class_cache.Query);
@@ -251,9 +321,11 @@ JNIEXPORT void JNI_OnUnload(JavaVM *vm, void *_reserved) {
     (*env)->DeleteGlobalRef(env, global_class_cache.QueryError$Syntax);
     (*env)->DeleteGlobalRef(env, global_class_cache.QueryCapture);
     (*env)->DeleteGlobalRef(env, global_class_cache.QueryMatch);
+    (*env)->DeleteGlobalRef(env, global_class_cache.QueryProgressListener);
     (*env)->DeleteGlobalRef(env, global_class_cache.Range);
     (*env)->DeleteGlobalRef(env, global_class_cache.Tree);
     (*env)->DeleteGlobalRef(env, global_class_cache.TreeCursor);
+    (*env)->DeleteGlobalRef(env, global_class_cache.TreeSitter);
     (*env)->DeleteGlobalRef(env, global_class_cache.Triple);
     (*env)->DeleteGlobalRef(env, global_class_cache.UInt);
     (*env)->DeleteGlobalRef(env, global_class_cache.UShort);
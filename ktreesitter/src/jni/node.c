@@ -1,12 +1,15 @@
+#include <stdlib.h>
+
+#include "symbols.h"
 #include "utils.h"
 
-jshort JNICALL node_symbol(JNIEnv *env, jobject this) {
-    TSNode self = unmarshal_node(env, this);
+jshort JNICALL node_symbol CRITICAL_ARGS(NODE_ARGS) {
+    TSNode self = UNPACK_NODE();
     return (jshort)ts_node_symbol(self);
 }
 
-jshort JNICALL node_grammar_symbol(JNIEnv *env, jobject this) {
-    TSNode self = unmarshal_node(env, this);
+jshort JNICALL node_grammar_symbol CRITICAL_ARGS(NODE_ARGS) {
+    TSNode self = UNPACK_NODE();
     return (jshort)ts_node_grammar_symbol(self);
 }
 
@@ -22,53 +25,53 @@ jstring JNICALL node_grammar_type(JNIEnv *env, jobject this) {
     return (*env)->NewStringUTF(env, type);
 }
 
-jboolean JNICALL node_is_named(JNIEnv *env, jobject this) {
-    TSNode self = unmarshal_node(env, this);
+jboolean JNICALL node_is_named CRITICAL_ARGS(NODE_ARGS) {
+    TSNode self = UNPACK_NODE();
     return (jboolean)ts_node_is_named(self);
 }
 
-jboolean JNICALL node_is_extra(JNIEnv *env, jobject this) {
-    TSNode self = unmarshal_node(env, this);
+jboolean JNICALL node_is_extra CRITICAL_ARGS(NODE_ARGS) {
+    TSNode self = UNPACK_NODE();
     return (jboolean)ts_node_is_extra(self);
 }
 
-jboolean JNICALL node_is_error(JNIEnv *env, jobject this) {
-    TSNode self = unmarshal_node(env, this);
+jboolean JNICALL node_is_error CRITICAL_ARGS(NODE_ARGS) {
+    TSNode self = UNPACK_NODE();
     return (jboolean)ts_node_is_error(self);
 }
 
-jboolean JNICALL node_is_missing(JNIEnv *env, jobject this) {
-    TSNode self = unmarshal_node(env, this);
+jboolean JNICALL node_is_missing CRITICAL_ARGS(NODE_ARGS) {
+    TSNode self = UNPACK_NODE();
     return (jboolean)ts_node_is_missing(self);
 }
 
-jboolean JNICALL node_has_error(JNIEnv *env, jobject this) {
-    TSNode self = unmarshal_node(env, this);
+jboolean JNICALL node_has_error CRITICAL_ARGS(NODE_ARGS) {
+    TSNode self = UNPACK_NODE();
     return (jboolean)ts_node_has_error(self);
 }
 
-jboolean JNICALL node_has_changes(JNIEnv *env, jobject this) {
-    TSNode self = unmarshal_node(env, this);
+jboolean JNICALL node_has_changes CRITICAL_ARGS(NODE_ARGS) {
+    TSNode self = UNPACK_NODE();
     return (jboolean)ts_node_has_changes(self);
 }
 
-jshort JNICALL node_get_parse_state(JNIEnv *env, jobject this) {
-    TSNode self = unmarshal_node(env, this);
+jshort JNICALL node_get_parse_state CRITICAL_ARGS(NODE_ARGS) {
+    TSNode self = UNPACK_NODE();
     return (jshort)ts_node_parse_state(self);
 }
 
-jshort JNICALL node_get_next_parse_state(JNIEnv *env, jobject this) {
-    TSNode self = unmarshal_node(env, this);
+jshort JNICALL node_get_next_parse_state CRITICAL_ARGS(NODE_ARGS) {
+    TSNode self = UNPACK_NODE();
     return (jshort)ts_node_next_parse_state(self);
 }
 
-jint JNICALL node_get_start_byte(JNIEnv *env, jobject this) {
-    TSNode self = unmarshal_node(env, this);
+jint JNICALL node_get_start_byte CRITICAL_ARGS(NODE_ARGS) {
+    TSNode self = UNPACK_NODE();
     return (jint)ts_node_start_byte(self);
 }
 
-jint JNICALL node_get_end_byte(JNIEnv *env, jobject this) {
-    TSNode self = unmarshal_node(env, this);
+jint JNICALL node_get_end_byte CRITICAL_ARGS(NODE_ARGS) {
+    TSNode self = UNPACK_NODE();
     return (jint)ts_node_end_byte(self);
 }
 
@@ -82,18 +85,18 @@ jobject JNICALL node_get_end_point(JNIEnv *env, jobject this) {
     return marshal_point(env, ts_node_end_point(self));
 }
 
-jint JNICALL node_get_child_count(JNIEnv *env, jobject this) {
-    TSNode self = unmarshal_node(env, this);
+jint JNICALL node_get_child_count CRITICAL_ARGS(NODE_ARGS) {
+    TSNode self = UNPACK_NODE();
     return (jint)ts_node_child_count(self);
 }
 
-jint JNICALL node_get_named_child_count(JNIEnv *env, jobject this) {
-    TSNode self = unmarshal_node(env, this);
+jint JNICALL node_get_named_child_count CRITICAL_ARGS(NODE_ARGS) {
+    TSNode self = UNPACK_NODE();
     return (jint)ts_node_named_child_count(self);
 }
 
-jint JNICALL node_get_descendant_count(JNIEnv *env, jobject this) {
-    TSNode self = unmarshal_node(env, this);
+jint JNICALL node_get_descendant_count CRITICAL_ARGS(NODE_ARGS) {
+    TSNode self = UNPACK_NODE();
     return (jint)ts_node_descendant_count(self);
 }
 
@@ -356,7 +359,25 @@ jstring JNICALL node_sexp(JNIEnv *env, jobject this) {
     TSNode self = unmarshal_node(env, this);
     char *sexp = ts_node_string(self);
     jobject result = (*env)->NewStringUTF(env, sexp);
-    free(sexp);
+    ts_free(sexp);
+    return result;
+}
+
+jintArray JNICALL node_symbol_histogram(JNIEnv *env, jobject this) {
+    TSNode self = unmarshal_node(env, this);
+    uint32_t count = ts_language_symbol_count(ts_tree_language(self.tree));
+    jintArray result = (*env)->NewIntArray(env, (jsize)count);
+    if (result == NULL)
+        return NULL;
+    // The walk can be long, so it must not hold a critical section that blocks the GC
+    uint32_t *counts = (uint32_t *)calloc(count, sizeof(uint32_t));
+    if (counts == NULL) {
+        THROW(IllegalStateException, "Failed to allocate the symbol histogram");
+        return NULL;
+    }
+    kts_symbol_histogram(self, counts, count);
+    (*env)->SetIntArrayRegion(env, result, 0, (jsize)count, (jint *)counts);
+    free(counts);
     return result;
 }
 
@@ -374,25 +395,25 @@ jboolean JNICALL node_native_equals(JNIEnv *env, jobject this, jobject that) {
 }
 
 const JNINativeMethod Node_methods[] = {
-    {"getSymbol", "()S", (void *)&node_symbol},
-    {"getGrammarSymbol", "()S", (void *)&node_grammar_symbol},
+    {"nativeSymbol", "(JIIIIJ)S", (void *)&node_symbol},
+    {"nativeGrammarSymbol", "(JIIIIJ)S", (void *)&node_grammar_symbol},
     {"getType", "()Ljava/lang/String;", (void *)&node_type},
     {"getGrammarType", "()Ljava/lang/String;", (void *)&node_grammar_type},
-    {"isNamed", "()Z", (void *)&node_is_named},
-    {"isExtra", "()Z", (void *)&node_is_extra},
-    {"isError", "()Z", (void *)&node_is_error},
-    {"isMissing", "()Z", (void *)&node_is_missing},
-    {"hasError", "()Z", (void *)&node_has_error},
-    {"hasChanges", "()Z", (void *)&node_has_changes},
-    {"getParseState", "()S", (void *)&node_get_parse_state},
-    {"getNextParseState", "()S", (void *)&node_get_next_parse_state},
-    {"getStartByte", "()I", (void *)&node_get_start_byte},
-    {"getEndByte", "()I", (void *)&node_get_end_byte},
+    {"nativeIsNamed", "(JIIIIJ)Z", (void *)&node_is_named},
+    {"nativeIsExtra", "(JIIIIJ)Z", (void *)&node_is_extra},
+    {"nativeIsError", "(JIIIIJ)Z", (void *)&node_is_error},
+    {"nativeIsMissing", "(JIIIIJ)Z", (void *)&node_is_missing},
+    {"nativeHasError", "(JIIIIJ)Z", (void *)&node_has_error},
+    {"nativeHasChanges", "(JIIIIJ)Z", (void *)&node_has_changes},
+    {"nativeParseState", "(JIIIIJ)S", (void *)&node_get_parse_state},
+    {"nativeNextParseState", "(JIIIIJ)S", (void *)&node_get_next_parse_state},
+    {"nativeStartByte", "(JIIIIJ)I", (void *)&node_get_start_byte},
+    {"nativeEndByte", "(JIIIIJ)I", (void *)&node_get_end_byte},
     {"getStartPoint", "()L" PACKAGE "Point;", (void *)&node_get_start_point},
     {"getEndPoint", "()L" PACKAGE "Point;", (void *)&node_get_end_point},
-    {"getChildCount", "()I", (void *)&node_get_child_count},
-    {"getNamedChildCount", "()I", (void *)&node_get_named_child_count},
-    {"getDescendantCount", "()I", (void *)&node_get_descendant_count},
+    {"nativeChildCount", "(JIIIIJ)I", (void *)&node_get_child_count},
+    {"nativeNamedChildCount", "(JIIIIJ)I", (void *)&node_get_named_child_count},
+    {"nativeDescendantCount", "(JIIIIJ)I", (void *)&node_get_descendant_count},
     {"getParent", "()L" PACKAGE "Node;", (void *)&node_get_parent},
     {"getNextSibling", "()L" PACKAGE "Node;", (void *)&node_get_next_sibling},
     {"getNextNamedSibling", "()L" PACKAGE "Node;", (void *)&node_get_next_named_sibling},
@@ -419,6 +440,7 @@ const JNINativeMethod Node_methods[] = {
      (void *)&node_named_descendant__points},
     {"edit", "(L" PACKAGE "InputEdit;)V", (void *)&node_edit},
     {"sexp", "()Ljava/lang/String;", (void *)&node_sexp},
+    {"symbolHistogram", "()[I", (void *)&node_symbol_histogram},
     {"hashCode", "()I", (void *)&node_hash_code},
     {"nativeEquals", "(L" PACKAGE "Node;)Z", (void *)&node_native_equals},
 };
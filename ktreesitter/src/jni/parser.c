@@ -1,5 +1,8 @@
 #include <string.h>
 
+#include "accounting.h"
+#include "diff.h"
+#include "log_buffer.h"
 #include "utils.h"
 
 typedef struct {
@@ -11,6 +14,11 @@ typedef struct {
     } last_result;
 } ReadPayload;
 
+typedef struct {
+    const char *string;
+    uint32_t length;
+} StringPayload;
+
 static inline TSInputEncoding get_encoding(JNIEnv *env, jobject encoding) {
     jobject UTF_8 = GET_STATIC_FIELD(Object, InputEncoding, InputEncoding_UTF_8);
     if (encoding == NULL || (*env)->IsSameObject(env, encoding, UTF_8)) {
@@ -54,6 +62,13 @@ static void log_function(void *payload, TSLogType log_type, const char *buffer)
     CALL_METHOD(Object, (jobject)payload, Function2_invoke, log_type_value, message);
 }
 
+/** Release the logger of the parser, unless it is a log buffer, which is owned by Kotlin. */
+static inline void release_logger(JNIEnv *env, TSParser *self) {
+    TSLogger logger = ts_parser_logger(self);
+    if (logger.payload != NULL && !kts_log_buffer_is_logger(logger))
+        (*env)->DeleteGlobalRef(env, (jobject)logger.payload);
+}
+
 static const char *parse_read_callback(void *payload, uint32_t byte_index, TSPoint position,
                                        uint32_t *bytes_read) {
     ReadPayload *read_payload = (ReadPayload *)payload;
@@ -88,9 +103,33 @@ static const char *parse_read_callback(void *payload, uint32_t byte_index, TSPoi
     return result;
 }
 
+static const char *string_read_callback(void *payload, uint32_t byte_index, TSPoint position,
+                                        uint32_t *bytes_read) {
+    StringPayload *string_payload = (StringPayload *)payload;
+    if (byte_index >= string_payload->length) {
+        *bytes_read = 0;
+        return "";
+    }
+    *bytes_read = string_payload->length - byte_index;
+    return string_payload->string + byte_index;
+}
+
 static bool parse_progress_callback(TSParseState *state) {
+    if (kts_allocator_budget_exceeded())
+        return true;
+
     ProgressPayload *progress_payload = (ProgressPayload *)state->payload;
     JNIEnv *env = progress_payload->env;
+    if (progress_listener_due(progress_payload, state->current_byte_offset)) {
+        jboolean halt = CALL_METHOD(Boolean, progress_payload->listener,
+                                    ParseProgressListener_onProgress,
+                                    (jint)state->current_byte_offset, (jboolean)state->has_error);
+        if (halt || (*env)->ExceptionCheck(env))
+            return true;
+    }
+    if (progress_payload->callback == NULL)
+        return false;
+
     jobject offset = (*env)->AllocObject(env, global_class_cache.UInt);
     (*env)->SetIntField(env, offset, global_field_cache.UInt_data,
                         (jint)state->current_byte_offset);
@@ -99,15 +138,65 @@ static bool parse_progress_callback(TSParseState *state) {
         CALL_METHOD(Object, progress_payload->callback, Function2_invoke, offset, error);
     (*env)->DeleteLocalRef(env, offset);
     (*env)->DeleteLocalRef(env, error);
+    if ((*env)->ExceptionCheck(env))
+        return true;
     return (bool)(*env)->GetBooleanField(env, result, global_field_cache.Boolean_value);
 }
 
-jlong JNICALL parser_init CRITICAL_NO_ARGS() { return (jlong)ts_parser_new(); }
+static TSTree *parse_input(JNIEnv *env, jobject this, TSParser *self, const TSTree *old_tree,
+                           TSInput input, jobject progress_callback) {
+    uint64_t memory_limit = (uint64_t)GET_FIELD(Long, this, Parser_memoryLimitBytes);
+    jobject progress_listener = GET_FIELD(Object, this, Parser_progressListener);
+    KtsMemoryScope scope;
+    kts_memory_scope_enter(&scope, memory_limit);
+    TSTree *ts_tree;
+    if (progress_callback == NULL && progress_listener == NULL && memory_limit == 0) {
+        ts_tree = ts_parser_parse(self, old_tree, input);
+    } else {
+        uint64_t interval_micros = (uint64_t)GET_FIELD(Long, this, Parser_progressIntervalMicros);
+        ProgressPayload progress_payload = {
+            .env = env,
+            .callback = progress_callback,
+            .listener = progress_listener,
+            .interval_bytes = (uint32_t)GET_FIELD(Int, this, Parser_progressIntervalBytes),
+            .interval = duration_from_micros(interval_micros),
+        };
+        progress_listener_start(&progress_payload, 0);
+        TSParseOptions options = {
+            .payload = (void *)&progress_payload,
+            .progress_callback = parse_progress_callback,
+        };
+        ts_tree = ts_parser_parse_with_options(self, old_tree, input, options);
+    }
+    bool exceeded = scope.budget.exceeded;
+    if (exceeded) {
+        if (ts_tree != NULL)
+            ts_tree_delete(ts_tree);
+        ts_parser_reset(self);
+        ts_tree = NULL;
+    }
+    kts_memory_track_parse(self, ts_tree, kts_memory_scope_leave(&scope));
+
+    if (exceeded)
+        throw_memory_limit_exceeded(env, memory_limit);
+    return ts_tree;
+}
+
+static inline void charge_parser(TSParser *self, KtsMemoryScope *scope) {
+    kts_memory_charge(self, kts_memory_scope_leave(scope));
+}
+
+jlong JNICALL parser_init CRITICAL_NO_ARGS() {
+    KtsMemoryScope scope;
+    kts_memory_scope_enter(&scope, 0);
+    TSParser *self = ts_parser_new();
+    kts_memory_track(KTS_OBJECT_PARSER, self, kts_memory_scope_leave(&scope));
+    return (jlong)self;
+}
 
 void JNICALL parser_delete(JNIEnv *env, jclass _class, jlong self) {
-    TSLogger logger = ts_parser_logger((TSParser *)self);
-    if (logger.payload != NULL)
-        (*env)->DeleteGlobalRef(env, (jobject)logger.payload);
+    release_logger(env, (TSParser *)self);
+    kts_memory_untrack((TSParser *)self);
     ts_parser_delete((TSParser *)self);
 }
 
@@ -119,7 +208,10 @@ jlong JNICALL parser_get_timeout_micros(JNIEnv *env, jobject this) {
 void JNICALL parser_set_language(JNIEnv *env, jobject this, jobject value) {
     TSParser *self = GET_POINTER(TSParser, this, Parser_self);
     TSLanguage *language = GET_POINTER(TSLanguage, value, Language_self);
+    KtsMemoryScope scope;
+    kts_memory_scope_enter(&scope, 0);
     ts_parser_set_language(self, language);
+    charge_parser(self, &scope);
     (*env)->SetObjectField(env, this, global_field_cache.Parser_language, value);
 }
 
@@ -137,7 +229,11 @@ void JNICALL parser_set_included_ranges(JNIEnv *env, jobject this, jobject value
         *(ts_ranges + i) = unmarshal_range(env, range);
         (*env)->DeleteLocalRef(env, range);
     }
-    if (ts_parser_set_included_ranges(self, ts_ranges, size)) {
+    KtsMemoryScope scope;
+    kts_memory_scope_enter(&scope, 0);
+    bool success = ts_parser_set_included_ranges(self, ts_ranges, size);
+    charge_parser(self, &scope);
+    if (success) {
         (*env)->SetObjectField(env, this, global_field_cache.Parser_includedRanges, value);
     } else {
         const char *error = "Included ranges must be in ascending order and must not overlap";
@@ -154,10 +250,8 @@ void JNICALL parser_set_timeout_micros(JNIEnv *env, jobject this, jlong value) {
 
 void JNICALL parser_set_logger(JNIEnv *env, jobject this, jobject value) {
     TSParser *self = GET_POINTER(TSParser, this, Parser_self);
-    TSLogger logger = ts_parser_logger(self);
-    if (logger.payload != NULL) {
-        (*env)->DeleteGlobalRef(env, (jobject)logger.payload);
-    }
+    release_logger(env, self);
+    TSLogger logger;
     if (value != NULL) {
         jobject payload = (*env)->NewGlobalRef(env, value);
         logger.payload = (void *)payload;
@@ -168,6 +262,18 @@ void JNICALL parser_set_logger(JNIEnv *env, jobject this, jobject value) {
     }
     ts_parser_set_logger(self, logger);
     (*env)->SetObjectField(env, this, global_field_cache.Parser_logger, value);
+    (*env)->SetObjectField(env, this, global_field_cache.Parser_logBuffer, NULL);
+}
+
+void JNICALL parser_set_log_buffer(JNIEnv *env, jobject this, jobject value) {
+    TSParser *self = GET_POINTER(TSParser, this, Parser_self);
+    release_logger(env, self);
+    TSLogger logger = {.payload = NULL, .log = NULL};
+    if (value != NULL)
+        logger = kts_log_buffer_logger(GET_POINTER(KtsLogBuffer, value, LogBuffer_self));
+    ts_parser_set_logger(self, logger);
+    (*env)->SetObjectField(env, this, global_field_cache.Parser_logBuffer, value);
+    (*env)->SetObjectField(env, this, global_field_cache.Parser_logger, NULL);
 }
 
 jobject JNICALL parser_parse__string(JNIEnv *env, jobject this, jstring source, jobject encoding,
@@ -185,10 +291,17 @@ jobject JNICALL parser_parse__string(JNIEnv *env, jobject this, jstring source,
     const char *string = (*env)->GetStringUTFChars(env, source, NULL);
     length = (uint32_t)(*env)->GetStringUTFLength(env, source);
     TSInputEncoding input_encoding = get_encoding(env, encoding);
-    TSTree *ts_tree =
-        ts_parser_parse_string_encoding(self, old_ts_tree, string, length, input_encoding);
+    StringPayload string_payload = {.string = string, .length = length};
+    TSInput input = {
+        .payload = (void *)&string_payload,
+        .read = string_read_callback,
+        .encoding = input_encoding,
+    };
+    TSTree *ts_tree = parse_input(env, this, self, old_ts_tree, input, NULL);
     (*env)->ReleaseStringUTFChars(env, source, string);
 
+    if ((*env)->ExceptionCheck(env))
+        return NULL;
     if (ts_tree == NULL) {
         const char *error = "Parsing failed";
         (*env)->ThrowNew(env, global_class_cache.IllegalStateException, error);
@@ -216,17 +329,7 @@ jobject JNICALL parser_parse__function(JNIEnv *env, jobject this, jobject encodi
         .read = parse_read_callback,
         .encoding = input_encoding,
     };
-    TSTree *ts_tree;
-    if (progress_callback == NULL) {
-        ts_tree = ts_parser_parse(self, old_ts_tree, input);
-    } else {
-        ProgressPayload progress_payload = {.env = env, .callback = progress_callback};
-        TSParseOptions options = {
-            .payload = (void *)&progress_payload,
-            .progress_callback = parse_progress_callback,
-        };
-        ts_tree = ts_parser_parse_with_options(self, old_ts_tree, input, options);
-    }
+    TSTree *ts_tree = parse_input(env, this, self, old_ts_tree, input, progress_callback);
 
     if ((*env)->ExceptionCheck(env)) {
         (*env)->Throw(env, (*env)->ExceptionOccurred(env));
@@ -240,9 +343,69 @@ jobject JNICALL parser_parse__function(JNIEnv *env, jobject this, jobject encodi
     return NEW_OBJECT(Tree, (jlong)ts_tree, NULL, language);
 }
 
+/** Reparse a tree that was parsed as UTF-8, which is checked by the caller. */
+jobject JNICALL parser_native_reparse(JNIEnv *env, jobject this, jobject old_tree,
+                                      jstring source) {
+    TSParser *self = GET_POINTER(TSParser, this, Parser_self);
+    jobject language = GET_FIELD(Object, this, Parser_language);
+    if (language == NULL) {
+        const char *error = "The parser has no language assigned";
+        (*env)->ThrowNew(env, global_class_cache.IllegalStateException, error);
+        return NULL;
+    }
+
+    TSTree *old_ts_tree = GET_POINTER(TSTree, old_tree, Tree_self);
+    jstring old_source = (jstring)GET_FIELD(Object, old_tree, Tree_source);
+    const char *old_string = (*env)->GetStringUTFChars(env, old_source, NULL);
+    uint32_t old_length = (uint32_t)(*env)->GetStringUTFLength(env, old_source);
+    const char *string = (*env)->GetStringUTFChars(env, source, NULL);
+    uint32_t length = (uint32_t)(*env)->GetStringUTFLength(env, source);
+    TSInputEdit edits[KTS_DIFF_MAX_EDITS];
+    uint32_t edit_count = kts_diff(old_string, old_length, string, length, edits);
+    (*env)->ReleaseStringUTFChars(env, old_source, old_string);
+
+    // Edit a copy of the old tree, so that it stays in sync with its own source.
+    KtsMemoryScope scope;
+    kts_memory_scope_enter(&scope, 0);
+    TSTree *edited_tree = ts_tree_copy(old_ts_tree);
+    for (uint32_t i = 0; i < edit_count; ++i)
+        ts_tree_edit(edited_tree, &edits[i]);
+    charge_parser(self, &scope);
+
+    StringPayload string_payload = {.string = string, .length = length};
+    TSInput input = {
+        .payload = (void *)&string_payload,
+        .read = string_read_callback,
+        .encoding = TSInputEncodingUTF8,
+    };
+    TSTree *ts_tree = parse_input(env, this, self, edited_tree, input, NULL);
+    (*env)->ReleaseStringUTFChars(env, source, string);
+
+    kts_memory_scope_enter(&scope, 0);
+    ts_tree_delete(edited_tree);
+    charge_parser(self, &scope);
+
+    if ((*env)->ExceptionCheck(env))
+        return NULL;
+    if (ts_tree == NULL) {
+        const char *error = "Parsing failed";
+        (*env)->ThrowNew(env, global_class_cache.IllegalStateException, error);
+        return NULL;
+    }
+    return NEW_OBJECT(Tree, (jlong)ts_tree, source, language);
+}
+
 void JNICALL parser_reset(JNIEnv *env, jobject this) {
     TSParser *self = GET_POINTER(TSParser, this, Parser_self);
+    KtsMemoryScope scope;
+    kts_memory_scope_enter(&scope, 0);
     ts_parser_reset(self);
+    charge_parser(self, &scope);
+}
+
+jlong JNICALL parser_get_native_size_bytes(JNIEnv *env, jobject this) {
+    TSParser *self = GET_POINTER(TSParser, this, Parser_self);
+    return (jlong)kts_memory_size(self);
 }
 
 const JNINativeMethod Parser_methods[] = {
@@ -253,13 +416,18 @@ const JNINativeMethod Parser_methods[] = {
     {"getTimeoutMicros", "()J", (void *)&parser_get_timeout_micros},
     {"setTimeoutMicros", "(J)V", (void *)&parser_set_timeout_micros},
     {"setLogger", "(Lkotlin/jvm/functions/Function2;)V", (void *)&parser_set_logger},
-    {"parse", "(Ljava/lang/String;L" PACKAGE "InputEncoding;L" PACKAGE "Tree;)L" PACKAGE "Tree;",
+    {"setLogBuffer", "(L" PACKAGE "LogBuffer;)V", (void *)&parser_set_log_buffer},
+    {"nativeParse",
+     "(Ljava/lang/String;L" PACKAGE "InputEncoding;L" PACKAGE "Tree;)L" PACKAGE "Tree;",
      (void *)&parser_parse__string},
-    {"parse",
+    {"nativeParse",
      "(L" PACKAGE "InputEncoding;L" PACKAGE "Tree;Lkotlin/jvm/functions/Function2;"
      "Lkotlin/jvm/functions/Function2;)L" PACKAGE "Tree;",
      (void *)&parser_parse__function},
+    {"nativeReparse", "(L" PACKAGE "Tree;Ljava/lang/String;)L" PACKAGE "Tree;",
+     (void *)&parser_native_reparse},
     {"reset", "()V", (void *)&parser_reset},
+    {"getNativeSizeBytes", "()J", (void *)&parser_get_native_size_bytes},
 };
 
 const size_t Parser_methods_size = sizeof Parser_methods / sizeof(JNINativeMethod);
@@ -1,6 +1,7 @@
 #include <ctype.h>
 #include <string.h>
 
+#include "accounting.h"
 #include "utils.h"
 
 static inline bool is_valid_identifier_char(char ch) { return isalnum(ch) || ch == '_'; }
@@ -13,8 +14,11 @@ jlong query_init(JNIEnv *env, jclass _class, jlong language, jstring source) {
     TSQueryError error_type;
     const char *source_chars = (*env)->GetStringUTFChars(env, source, NULL);
     uint32_t error_offset, source_len = (*env)->GetStringUTFLength(env, source);
+    KtsMemoryScope scope;
+    kts_memory_scope_enter(&scope, 0);
     TSQuery *self =
         ts_query_new((TSLanguage *)language, source_chars, source_len, &error_offset, &error_type);
+    kts_memory_track(KTS_OBJECT_QUERY, self, kts_memory_scope_leave(&scope));
     if (self != NULL) {
         (*env)->ReleaseStringUTFChars(env, source, source_chars);
         return (jlong)self;
@@ -105,6 +109,7 @@ jlong query_init(JNIEnv *env, jclass _class, jlong language, jstring source) {
 }
 
 void query_delete CRITICAL_ARGS(jlong query) {
+    kts_memory_untrack((TSQuery *)query);
     ts_query_delete((TSQuery *)query);
 }
 
@@ -233,6 +238,11 @@ jobject query_predicates_for_pattern(JNIEnv *env, jobject this, jint index) {
     return predicates;
 }
 
+jlong query_get_native_size_bytes(JNIEnv *env, jobject this) {
+    TSQuery *self = GET_POINTER(TSQuery, this, Query_self);
+    return (jlong)kts_memory_size(self);
+}
+
 const JNINativeMethod Query_methods[] = {
     {"init", "(JLjava/lang/String;)J", (void *)&query_init},
     {"delete", "(J)V", (void *)&query_delete},
@@ -250,6 +260,7 @@ const JNINativeMethod Query_methods[] = {
     {"nativeIsPatternGuaranteedAtStep", "(I)Z",
      (void *)&query_native_is_pattern_guaranteed_at_step},
     {"predicatesForPattern", "(I)Ljava/util/List;", (void *)&query_predicates_for_pattern},
+    {"getNativeSizeBytes", "()J", (void *)&query_get_native_size_bytes},
 };
 
 const size_t Query_methods_size = sizeof Query_methods / sizeof(JNINativeMethod);
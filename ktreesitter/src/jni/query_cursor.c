@@ -1,89 +1,152 @@
+#include "allocator.h"
 #include "utils.h"
 
+// The cursor keeps a pointer to its options until the next exec,
+// so they must outlive the call that executes the query.
+typedef struct {
+    TSQueryCursor *cursor;
+    TSQueryCursorOptions options;
+    ProgressPayload progress_payload;
+    KtsMemoryBudget budget;
+} QueryCursorHandle;
+
+#define GET_CURSOR(object) (GET_POINTER(QueryCursorHandle, object, QueryCursor_self))->cursor
+
 static bool query_progress_callback(TSQueryCursorState *state) {
+    if (kts_allocator_budget_exceeded())
+        return true;
+
     ProgressPayload *progress_payload = (ProgressPayload *)state->payload;
     JNIEnv *env = progress_payload->env;
+    if (progress_listener_due(progress_payload, state->current_byte_offset)) {
+        jboolean halt = CALL_METHOD(Boolean, progress_payload->listener,
+                                    QueryProgressListener_onProgress,
+                                    (jint)state->current_byte_offset);
+        if (halt || (*env)->ExceptionCheck(env))
+            return true;
+    }
+    if (progress_payload->callback == NULL)
+        return false;
+
     jobject offset = (*env)->AllocObject(env, global_class_cache.UInt);
     (*env)->SetIntField(env, offset, global_field_cache.UInt_data,
                         (jint)state->current_byte_offset);
     jobject result = CALL_METHOD(Object, progress_payload->callback, Function1_invoke, offset);
     (*env)->DeleteLocalRef(env, offset);
+    if ((*env)->ExceptionCheck(env))
+        return true;
     return (bool)(*env)->GetBooleanField(env, result, global_field_cache.Boolean_value);
 }
 
-jlong query_cursor_init CRITICAL_NO_ARGS() { return (jlong)ts_query_cursor_new(); }
+static inline KtsMemoryBudget *query_cursor_enter(JNIEnv *env, jobject this,
+                                                  QueryCursorHandle *handle) {
+    handle->progress_payload.env = env;
+    handle->progress_payload.callback = GET_FIELD(Object, this, QueryCursor_progressCallback);
+    handle->progress_payload.listener = GET_FIELD(Object, this, QueryCursor_progressListener);
+    if (handle->progress_payload.listener != NULL) {
+        uint64_t interval_micros =
+            (uint64_t)GET_FIELD(Long, this, QueryCursor_progressIntervalMicros);
+        handle->progress_payload.interval_bytes =
+            (uint32_t)GET_FIELD(Int, this, QueryCursor_progressIntervalBytes);
+        handle->progress_payload.interval = duration_from_micros(interval_micros);
+        progress_listener_start(&handle->progress_payload, 0);
+    }
+    handle->budget.limit = (uint64_t)GET_FIELD(Long, this, QueryCursor_memoryLimitBytes);
+    return kts_allocator_swap_budget(handle->budget.limit != 0 ? &handle->budget : NULL);
+}
 
-void query_cursor_delete CRITICAL_ARGS(jlong cursor) {
-    ts_query_cursor_delete((TSQueryCursor *)cursor);
+static inline bool query_cursor_leave(JNIEnv *env, QueryCursorHandle *handle,
+                                      KtsMemoryBudget *previous_budget) {
+    kts_allocator_swap_budget(previous_budget);
+    handle->progress_payload.env = NULL;
+    handle->progress_payload.callback = NULL;
+    handle->progress_payload.listener = NULL;
+    if ((*env)->ExceptionCheck(env))
+        return false;
+    if (handle->budget.exceeded) {
+        throw_memory_limit_exceeded(env, handle->budget.limit);
+        return false;
+    }
+    return true;
+}
+
+jlong query_cursor_init CRITICAL_NO_ARGS() {
+    QueryCursorHandle *handle = (QueryCursorHandle *)ts_calloc(1, sizeof(QueryCursorHandle));
+    handle->cursor = ts_query_cursor_new();
+    handle->options.payload = (void *)&handle->progress_payload;
+    handle->options.progress_callback = query_progress_callback;
+    return (jlong)handle;
+}
+
+void query_cursor_delete CRITICAL_ARGS(jlong self) {
+    QueryCursorHandle *handle = (QueryCursorHandle *)self;
+    ts_query_cursor_delete(handle->cursor);
+    ts_free(handle);
 }
 
 jlong query_cursor_get_timeout_micros(JNIEnv *env, jobject this) {
-    TSQueryCursor *cursor = GET_POINTER(TSQueryCursor, this, QueryCursor_self);
+    TSQueryCursor *cursor = GET_CURSOR(this);
     return (jlong)ts_query_cursor_timeout_micros(cursor);
 }
 
 void query_cursor_set_timeout_micros(JNIEnv *env, jobject this, jlong value) {
-    TSQueryCursor *cursor = GET_POINTER(TSQueryCursor, this, QueryCursor_self);
+    TSQueryCursor *cursor = GET_CURSOR(this);
     ts_query_cursor_set_timeout_micros(cursor, (uint64_t)value);
     (*env)->SetLongField(env, this, global_field_cache.QueryCursor_timeoutMicros, value);
 }
 
 jint query_cursor_get_match_limit(JNIEnv *env, jobject this) {
-    TSQueryCursor *cursor = GET_POINTER(TSQueryCursor, this, QueryCursor_self);
+    TSQueryCursor *cursor = GET_CURSOR(this);
     return (jint)ts_query_cursor_match_limit(cursor);
 }
 
 void query_cursor_set_match_limit(JNIEnv *env, jobject this, jint value) {
-    TSQueryCursor *cursor = GET_POINTER(TSQueryCursor, this, QueryCursor_self);
+    TSQueryCursor *cursor = GET_CURSOR(this);
     ts_query_cursor_set_match_limit(cursor, (uint32_t)value);
     (*env)->SetIntField(env, this, global_field_cache.QueryCursor_matchLimit, value);
 }
 
 void query_cursor_set_max_start_depth(JNIEnv *env, jobject this, jint value) {
-    TSQueryCursor *cursor = GET_POINTER(TSQueryCursor, this, QueryCursor_self);
+    TSQueryCursor *cursor = GET_CURSOR(this);
     ts_query_cursor_set_max_start_depth(cursor, (uint32_t)value);
     (*env)->SetIntField(env, this, global_field_cache.QueryCursor_maxStartDepth, value);
 }
 
 jboolean query_cursor_did_exceed_match_limit(JNIEnv *env, jobject this) {
-    TSQueryCursor *cursor = GET_POINTER(TSQueryCursor, this, QueryCursor_self);
+    TSQueryCursor *cursor = GET_CURSOR(this);
     return (jboolean)ts_query_cursor_did_exceed_match_limit(cursor);
 }
 
 jboolean query_cursor_native_set_byte_range(JNIEnv *env, jobject this, jint start, jint end) {
-    TSQueryCursor *cursor = GET_POINTER(TSQueryCursor, this, QueryCursor_self);
+    TSQueryCursor *cursor = GET_CURSOR(this);
     return (jboolean)ts_query_cursor_set_byte_range(cursor, (uint32_t)start, (uint32_t)end);
 }
 
 jboolean query_cursor_native_set_point_range(JNIEnv *env, jobject this, jobject start,
                                              jobject end) {
-    TSQueryCursor *cursor = GET_POINTER(TSQueryCursor, this, QueryCursor_self);
+    TSQueryCursor *cursor = GET_CURSOR(this);
     TSPoint start_point = unmarshal_point(env, start), end_point = unmarshal_point(env, end);
     return (jboolean)ts_query_cursor_set_point_range(cursor, start_point, end_point);
 }
 
-void query_cursor_exec(JNIEnv *env, jobject this, jlong query, jobject node,
-                       jobject progress_callback) {
-    TSQueryCursor *cursor = GET_POINTER(TSQueryCursor, this, QueryCursor_self);
+void query_cursor_exec(JNIEnv *env, jobject this, jlong query, jobject node) {
+    count(COUNTER_JNI_CALLS, 1);
+    QueryCursorHandle *handle = GET_POINTER(QueryCursorHandle, this, QueryCursor_self);
     TSNode ts_node = unmarshal_node(env, node);
-    if (progress_callback == NULL) {
-        ts_query_cursor_exec(cursor, (TSQuery *)query, ts_node);
-    } else {
-        ProgressPayload progress_payload = {.env = env, .callback = progress_callback};
-        TSQueryCursorOptions options = {
-            .payload = (void *)&progress_payload,
-            .progress_callback = query_progress_callback,
-        };
-        ts_query_cursor_exec_with_options(cursor, (TSQuery *)query, ts_node, &options);
-    }
+    handle->budget = (KtsMemoryBudget){0};
+    ts_query_cursor_exec_with_options(handle->cursor, (TSQuery *)query, ts_node, &handle->options);
 }
 
 jobject query_cursor_next_capture(JNIEnv *env, jobject this, jobject capture_names, jobject tree) {
-    TSQueryCursor *cursor = GET_POINTER(TSQueryCursor, this, QueryCursor_self);
+    count(COUNTER_JNI_CALLS, 1);
+    QueryCursorHandle *handle = GET_POINTER(QueryCursorHandle, this, QueryCursor_self);
     uint32_t capture_index;
     TSQueryMatch match;
-    if (!ts_query_cursor_next_capture(cursor, &match, &capture_index))
+    KtsMemoryBudget *previous_budget = query_cursor_enter(env, this, handle);
+    bool found = ts_query_cursor_next_capture(handle->cursor, &match, &capture_index);
+    if (!query_cursor_leave(env, handle, previous_budget) || !found)
         return NULL;
+    count(COUNTER_OBJECTS, (uint64_t)match.capture_count + 1);
 
     jobject captures = NEW_OBJECT(ArrayList, (jint)match.capture_count);
     for (uint16_t i = 0; i < match.capture_count; ++i) {
@@ -108,10 +171,14 @@ jobject query_cursor_next_capture(JNIEnv *env, jobject this, jobject capture_nam
 }
 
 jobject query_cursor_next_match(JNIEnv *env, jobject this, jobject capture_names, jobject tree) {
-    TSQueryCursor *cursor = GET_POINTER(TSQueryCursor, this, QueryCursor_self);
+    count(COUNTER_JNI_CALLS, 1);
+    QueryCursorHandle *handle = GET_POINTER(QueryCursorHandle, this, QueryCursor_self);
     TSQueryMatch match;
-    if (!ts_query_cursor_next_match(cursor, &match))
+    KtsMemoryBudget *previous_budget = query_cursor_enter(env, this, handle);
+    bool found = ts_query_cursor_next_match(handle->cursor, &match);
+    if (!query_cursor_leave(env, handle, previous_budget) || !found)
         return NULL;
+    count(COUNTER_OBJECTS, (uint64_t)match.capture_count + 1);
 
     jobject captures = NEW_OBJECT(ArrayList, (jint)match.capture_count);
     for (uint16_t i = 0; i < match.capture_count; ++i) {
@@ -148,7 +215,7 @@ const JNINativeMethod QueryCursor_methods[] = {
      (void *)&query_cursor_next_match},
     {"nextCapture", "(Ljava/util/List;L" PACKAGE "Tree;)Lkotlin/Pair;",
      (void *)&query_cursor_next_capture},
-    {"exec", "(JL" PACKAGE "Node;Lkotlin/jvm/functions/Function1;)V", (void *)&query_cursor_exec},
+    {"exec", "(JL" PACKAGE "Node;)V", (void *)&query_cursor_exec},
 };
 
 const size_t QueryCursor_methods_size = sizeof QueryCursor_methods / sizeof(JNINativeMethod);
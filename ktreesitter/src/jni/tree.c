@@ -1,8 +1,19 @@
+#include "accounting.h"
+#include "tree_diff.h"
 #include "utils.h"
 
-jlong JNICALL tree_copy CRITICAL_ARGS(jlong self) { return (jlong)ts_tree_copy((TSTree *)self); }
+jlong JNICALL tree_copy CRITICAL_ARGS(jlong self) {
+    KtsMemoryScope scope;
+    kts_memory_scope_enter(&scope, 0);
+    TSTree *copy = ts_tree_copy((TSTree *)self);
+    kts_memory_track(KTS_OBJECT_TREE, copy, kts_memory_scope_leave(&scope));
+    return (jlong)copy;
+}
 
-void JNICALL tree_delete CRITICAL_ARGS(jlong self) { ts_tree_delete((TSTree *)self); }
+void JNICALL tree_delete CRITICAL_ARGS(jlong self) {
+    kts_memory_untrack((TSTree *)self);
+    ts_tree_delete((TSTree *)self);
+}
 
 jobject JNICALL tree_get_root_node(JNIEnv *env, jobject this) {
     TSTree *self = GET_POINTER(TSTree, this, Tree_self);
@@ -19,7 +30,44 @@ jobject JNICALL tree_root_node_with_offset(JNIEnv *env, jobject this, jint bytes
 void JNICALL tree_edit(JNIEnv *env, jobject this, jobject edit) {
     TSTree *self = GET_POINTER(TSTree, this, Tree_self);
     TSInputEdit input_edit = unmarshal_input_edit(env, edit);
+    KtsMemoryScope scope;
+    kts_memory_scope_enter(&scope, 0);
     ts_tree_edit(self, &input_edit);
+    kts_memory_charge(self, kts_memory_scope_leave(&scope));
+    (*env)->SetObjectField(env, this, global_field_cache.Tree_source, NULL);
+}
+
+void JNICALL tree_native_edit(JNIEnv *env, jobject this, jintArray edits, jobjectArray nodes) {
+    TSTree *self = GET_POINTER(TSTree, this, Tree_self);
+    jsize edit_count = (*env)->GetArrayLength(env, edits) / INPUT_EDIT_SIZE;
+    jsize node_count = (*env)->GetArrayLength(env, nodes);
+    TSNode *ts_nodes = node_count ? (TSNode *)malloc((size_t)node_count * sizeof(TSNode)) : NULL;
+    for (jsize i = 0; i < node_count; ++i) {
+        jobject node = (*env)->GetObjectArrayElement(env, nodes, i);
+        ts_nodes[i] = unmarshal_node(env, node);
+        (*env)->DeleteLocalRef(env, node);
+    }
+
+    jint *elements = (*env)->GetIntArrayElements(env, edits, NULL);
+    KtsMemoryScope scope;
+    kts_memory_scope_enter(&scope, 0);
+    for (jsize i = 0; i < edit_count; ++i) {
+        TSInputEdit input_edit = unpack_input_edit(elements + i * INPUT_EDIT_SIZE);
+        ts_tree_edit(self, &input_edit);
+        for (jsize j = 0; j < node_count; ++j)
+            ts_node_edit(&ts_nodes[j], &input_edit);
+    }
+    kts_memory_charge(self, kts_memory_scope_leave(&scope));
+    (*env)->ReleaseIntArrayElements(env, edits, elements, JNI_ABORT);
+
+    for (jsize i = 0; i < node_count; ++i) {
+        jobject node = (*env)->GetObjectArrayElement(env, nodes, i);
+        jobject context = (jintArray)GET_FIELD(Object, node, Node_context);
+        (*env)->SetIntArrayRegion(env, context, 0, 4, (jint *)ts_nodes[i].context);
+        (*env)->DeleteLocalRef(env, context);
+        (*env)->DeleteLocalRef(env, node);
+    }
+    free(ts_nodes);
     (*env)->SetObjectField(env, this, global_field_cache.Tree_source, NULL);
 }
 
@@ -38,10 +86,28 @@ jobject JNICALL tree_changed_ranges(JNIEnv *env, jobject this, jobject new_tree)
         CALL_METHOD(Boolean, ranges, ArrayList_add, range_obj);
         (*env)->DeleteLocalRef(env, range_obj);
     }
-    free(ts_ranges);
+    ts_free(ts_ranges);
     return ranges;
 }
 
+jintArray JNICALL tree_native_diff(JNIEnv *env, jobject this, jobject new_tree) {
+    TSTree *self = GET_POINTER(TSTree, this, Tree_self);
+    TSTree *other = GET_POINTER(TSTree, new_tree, Tree_self);
+    int32_t *edits;
+    uint32_t count;
+    if (!kts_tree_diff(self, other, &edits, &count)) {
+        THROW(IllegalStateException, "Failed to allocate the tree diff");
+        return NULL;
+    }
+
+    jsize length = (jsize)(count * KTS_TREE_DIFF_EDIT_SIZE);
+    jintArray result = (*env)->NewIntArray(env, length);
+    if (result != NULL)
+        (*env)->SetIntArrayRegion(env, result, 0, length, (jint *)edits);
+    kts_tree_diff_free(edits);
+    return result;
+}
+
 jobject JNICALL tree_native_included_ranges(JNIEnv *env, jobject this) {
     TSTree *self = GET_POINTER(TSTree, this, Tree_self);
     uint32_t length;
@@ -55,10 +121,15 @@ jobject JNICALL tree_native_included_ranges(JNIEnv *env, jobject this) {
         CALL_METHOD(Boolean, ranges, ArrayList_add, range_obj);
         (*env)->DeleteLocalRef(env, range_obj);
     }
-    free(ts_ranges);
+    ts_free(ts_ranges);
     return ranges;
 }
 
+jlong JNICALL tree_get_native_size_bytes(JNIEnv *env, jobject this) {
+    const TSTree *self = GET_POINTER(TSTree, this, Tree_self);
+    return (jlong)kts_memory_size(self);
+}
+
 const JNINativeMethod Tree_methods[] = {
     {"copy", "(J)J", (void *)&tree_copy},
     {"delete", "(J)V", (void *)&tree_delete},
@@ -66,8 +137,11 @@ const JNINativeMethod Tree_methods[] = {
     {"rootNodeWithOffset", "(IL" PACKAGE "Point;)L" PACKAGE "Node;",
      (void *)&tree_root_node_with_offset},
     {"edit", "(L" PACKAGE "InputEdit;)V", (void *)&tree_edit},
+    {"nativeEdit", "([I[L" PACKAGE "Node;)V", (void *)&tree_native_edit},
     {"changedRanges", "(L" PACKAGE "Tree;)Ljava/util/List;", (void *)&tree_changed_ranges},
+    {"nativeDiff", "(L" PACKAGE "Tree;)[I", (void *)&tree_native_diff},
     {"nativeIncludedRanges", "()Ljava/util/List;", (void *)&tree_native_included_ranges},
+    {"getNativeSizeBytes", "()J", (void *)&tree_get_native_size_bytes},
 };
 
 const size_t Tree_methods_size = sizeof Tree_methods / sizeof(JNINativeMethod);
@@ -4,7 +4,7 @@
     (*env)->SetObjectField(env, this, global_field_cache.TreeCursor_internalNode, value);
 
 static inline TSTreeCursor *tree_cursor_alloc(TSTreeCursor cursor) {
-    TSTreeCursor *cursor_ptr = (TSTreeCursor *)malloc(sizeof(TSTreeCursor));
+    TSTreeCursor *cursor_ptr = (TSTreeCursor *)ts_malloc(sizeof(TSTreeCursor));
     cursor_ptr->id = cursor.id;
     cursor_ptr->tree = cursor.tree;
     cursor_ptr->context[0] = cursor.context[0];
@@ -14,22 +14,26 @@ static inline TSTreeCursor *tree_cursor_alloc(TSTreeCursor cursor) {
 }
 
 jlong JNICALL tree_cursor_init(JNIEnv *env, jclass _class, jobject node) {
+    count(COUNTER_JNI_CALLS, 1);
     TSNode ts_node = unmarshal_node(env, node);
     TSTreeCursor cursor = ts_tree_cursor_new(ts_node);
     return (jlong)tree_cursor_alloc(cursor);
 }
 
 jlong JNICALL tree_cursor_copy CRITICAL_ARGS(jlong self) {
+    count(COUNTER_JNI_CALLS, 1);
     TSTreeCursor copy = ts_tree_cursor_copy((TSTreeCursor *)self);
     return (jlong)tree_cursor_alloc(copy);
 }
 
 void JNICALL tree_cursor_delete CRITICAL_ARGS(jlong self) {
+    count(COUNTER_JNI_CALLS, 1);
     ts_tree_cursor_delete((TSTreeCursor *)self);
-    free((TSTreeCursor *)self);
+    ts_free((TSTreeCursor *)self);
 }
 
 jobject JNICALL tree_cursor_get_current_node(JNIEnv *env, jobject this) {
+    count(COUNTER_JNI_CALLS, 1);
     jobject node = GET_FIELD(Object, this, TreeCursor_internalNode);
     if (node != NULL)
         return node;
@@ -42,28 +46,30 @@ jobject JNICALL tree_cursor_get_current_node(JNIEnv *env, jobject this) {
     return node;
 }
 
-jint JNICALL tree_cursor_get_current_depth(JNIEnv *env, jobject this) {
-    TSTreeCursor *self = GET_POINTER(TSTreeCursor, this, TreeCursor_self);
-    return (jint)ts_tree_cursor_current_depth(self);
+jint JNICALL tree_cursor_get_current_depth CRITICAL_ARGS(jlong self) {
+    count(COUNTER_JNI_CALLS, 1);
+    return (jint)ts_tree_cursor_current_depth((TSTreeCursor *)self);
 }
 
-jshort JNICALL tree_cursor_get_current_field_id(JNIEnv *env, jobject this) {
-    TSTreeCursor *self = GET_POINTER(TSTreeCursor, this, TreeCursor_self);
-    return (short)ts_tree_cursor_current_field_id(self);
+jshort JNICALL tree_cursor_get_current_field_id CRITICAL_ARGS(jlong self) {
+    count(COUNTER_JNI_CALLS, 1);
+    return (short)ts_tree_cursor_current_field_id((TSTreeCursor *)self);
 }
 
 jstring JNICALL tree_cursor_get_current_field_name(JNIEnv *env, jobject this) {
+    count(COUNTER_JNI_CALLS, 1);
     TSTreeCursor *self = GET_POINTER(TSTreeCursor, this, TreeCursor_self);
     const char *name = ts_tree_cursor_current_field_name(self);
     return name ? (*env)->NewStringUTF(env, name) : NULL;
 }
 
-jint JNICALL tree_cursor_get_current_descendant_index(JNIEnv *env, jobject this) {
-    TSTreeCursor *self = GET_POINTER(TSTreeCursor, this, TreeCursor_self);
-    return (jint)ts_tree_cursor_current_descendant_index(self);
+jint JNICALL tree_cursor_get_current_descendant_index CRITICAL_ARGS(jlong self) {
+    count(COUNTER_JNI_CALLS, 1);
+    return (jint)ts_tree_cursor_current_descendant_index((TSTreeCursor *)self);
 }
 
 void JNICALL tree_cursor_reset__node(JNIEnv *env, jobject this, jobject node) {
+    count(COUNTER_JNI_CALLS, 1);
     TSTreeCursor *self = GET_POINTER(TSTreeCursor, this, TreeCursor_self);
     TSNode ts_node = unmarshal_node(env, node);
     ts_tree_cursor_reset(self, ts_node);
@@ -71,65 +77,51 @@ void JNICALL tree_cursor_reset__node(JNIEnv *env, jobject this, jobject node) {
 }
 
 void JNICALL tree_cursor_reset__cursor(JNIEnv *env, jobject this, jobject cursor) {
+    count(COUNTER_JNI_CALLS, 1);
     TSTreeCursor *self = GET_POINTER(TSTreeCursor, this, TreeCursor_self);
     TSTreeCursor *other = GET_POINTER(TSTreeCursor, cursor, TreeCursor_self);
     ts_tree_cursor_reset_to(self, other);
     SET_INTERNAL_NODE(NULL);
 }
 
-jboolean JNICALL tree_cursor_goto_first_child(JNIEnv *env, jobject this) {
-    TSTreeCursor *self = GET_POINTER(TSTreeCursor, this, TreeCursor_self);
-    bool result = ts_tree_cursor_goto_first_child(self);
-    if (result)
-        SET_INTERNAL_NODE(NULL);
-    return (jboolean)result;
+jboolean JNICALL tree_cursor_goto_first_child CRITICAL_ARGS(jlong self) {
+    count(COUNTER_JNI_CALLS, 1);
+    return (jboolean)ts_tree_cursor_goto_first_child((TSTreeCursor *)self);
 }
 
-jboolean JNICALL tree_cursor_goto_last_child(JNIEnv *env, jobject this) {
-    TSTreeCursor *self = GET_POINTER(TSTreeCursor, this, TreeCursor_self);
-    bool result = ts_tree_cursor_goto_last_child(self);
-    if (result)
-        SET_INTERNAL_NODE(NULL);
-    return (jboolean)result;
+jboolean JNICALL tree_cursor_goto_last_child CRITICAL_ARGS(jlong self) {
+    count(COUNTER_JNI_CALLS, 1);
+    return (jboolean)ts_tree_cursor_goto_last_child((TSTreeCursor *)self);
 }
 
-jboolean JNICALL tree_cursor_goto_parent(JNIEnv *env, jobject this) {
-    TSTreeCursor *self = GET_POINTER(TSTreeCursor, this, TreeCursor_self);
-    bool result = ts_tree_cursor_goto_parent(self);
-    if (result)
-        SET_INTERNAL_NODE(NULL);
-    return (jboolean)result;
+jboolean JNICALL tree_cursor_goto_parent CRITICAL_ARGS(jlong self) {
+    count(COUNTER_JNI_CALLS, 1);
+    return (jboolean)ts_tree_cursor_goto_parent((TSTreeCursor *)self);
 }
 
-jboolean JNICALL tree_cursor_goto_next_sibling(JNIEnv *env, jobject this) {
-    TSTreeCursor *self = GET_POINTER(TSTreeCursor, this, TreeCursor_self);
-    bool result = ts_tree_cursor_goto_next_sibling(self);
-    if (result)
-        SET_INTERNAL_NODE(NULL);
-    return (jboolean)result;
+jboolean JNICALL tree_cursor_goto_next_sibling CRITICAL_ARGS(jlong self) {
+    count(COUNTER_JNI_CALLS, 1);
+    return (jboolean)ts_tree_cursor_goto_next_sibling((TSTreeCursor *)self);
 }
 
-jboolean JNICALL tree_cursor_goto_previous_sibling(JNIEnv *env, jobject this) {
-    TSTreeCursor *self = GET_POINTER(TSTreeCursor, this, TreeCursor_self);
-    bool result = ts_tree_cursor_goto_previous_sibling(self);
-    if (result)
-        SET_INTERNAL_NODE(NULL);
-    return (jboolean)result;
+jboolean JNICALL tree_cursor_goto_previous_sibling CRITICAL_ARGS(jlong self) {
+    count(COUNTER_JNI_CALLS, 1);
+    return (jboolean)ts_tree_cursor_goto_previous_sibling((TSTreeCursor *)self);
 }
 
-void JNICALL tree_cursor_goto_descendant(JNIEnv *env, jobject this, jint index) {
-    TSTreeCursor *self = GET_POINTER(TSTreeCursor, this, TreeCursor_self);
-    ts_tree_cursor_goto_descendant(self, (uint32_t)index);
-    SET_INTERNAL_NODE(NULL);
+void JNICALL tree_cursor_goto_descendant CRITICAL_ARGS(jlong self, jint index) {
+    count(COUNTER_JNI_CALLS, 1);
+    ts_tree_cursor_goto_descendant((TSTreeCursor *)self, (uint32_t)index);
 }
 
-jlong JNICALL tree_cursor_native_goto_first_child_for_byte(JNIEnv *env, jobject this, jint byte) {
-    TSTreeCursor *self = GET_POINTER(TSTreeCursor, this, TreeCursor_self);
-    return (jlong)ts_tree_cursor_goto_first_child_for_byte(self, (uint32_t)byte);
+jlong JNICALL tree_cursor_native_goto_first_child_for_byte CRITICAL_ARGS(jlong self, jint byte) {
+    count(COUNTER_JNI_CALLS, 1);
+    return (jlong)ts_tree_cursor_goto_first_child_for_byte((TSTreeCursor *)self, (uint32_t)byte);
 }
 
 jlong JNICALL tree_cursor_native_goto_first_child_for_point(JNIEnv *env, jobject this,
                                                             jobject point) {
+    count(COUNTER_JNI_CALLS, 1);
     TSTreeCursor *self = GET_POINTER(TSTreeCursor, this, TreeCursor_self);
     TSPoint ts_point = unmarshal_point(env, point);
     return (jlong)ts_tree_cursor_goto_first_child_for_point(self, ts_point);
@@ -140,19 +132,19 @@ const JNINativeMethod TreeCursor_methods[] = {
     {"copy", "(J)J", (void *)&tree_cursor_copy},
     {"delete", "(J)V", (void *)&tree_cursor_delete},
     {"getCurrentNode", "()L" PACKAGE "Node;", (void *)&tree_cursor_get_current_node},
-    {"getCurrentDepth", "()I", (void *)&tree_cursor_get_current_depth},
-    {"getCurrentFieldId", "()S", (void *)&tree_cursor_get_current_field_id},
+    {"nativeCurrentDepth", "(J)I", (void *)&tree_cursor_get_current_depth},
+    {"nativeCurrentFieldId", "(J)S", (void *)&tree_cursor_get_current_field_id},
     {"getCurrentFieldName", "()Ljava/lang/String;", (void *)&tree_cursor_get_current_field_name},
-    {"getCurrentDescendantIndex", "()I", (void *)&tree_cursor_get_current_descendant_index},
+    {"nativeCurrentDescendantIndex", "(J)I", (void *)&tree_cursor_get_current_descendant_index},
     {"reset", "(L" PACKAGE "Node;)V", (void *)&tree_cursor_reset__node},
     {"reset", "(L" PACKAGE "TreeCursor;)V", (void *)&tree_cursor_reset__cursor},
-    {"gotoFirstChild", "()Z", (void *)&tree_cursor_goto_first_child},
-    {"gotoLastChild", "()Z", (void *)&tree_cursor_goto_last_child},
-    {"gotoParent", "()Z", (void *)&tree_cursor_goto_parent},
-    {"gotoNextSibling", "()Z", (void *)&tree_cursor_goto_next_sibling},
-    {"gotoPreviousSibling", "()Z", (void *)&tree_cursor_goto_previous_sibling},
-    {"gotoDescendant", "(I)V", (void *)&tree_cursor_goto_descendant},
-    {"nativeGotoFirstChildForByte", "(I)J", (void *)&tree_cursor_native_goto_first_child_for_byte},
+    {"nativeGotoFirstChild", "(J)Z", (void *)&tree_cursor_goto_first_child},
+    {"nativeGotoLastChild", "(J)Z", (void *)&tree_cursor_goto_last_child},
+    {"nativeGotoParent", "(J)Z", (void *)&tree_cursor_goto_parent},
+    {"nativeGotoNextSibling", "(J)Z", (void *)&tree_cursor_goto_next_sibling},
+    {"nativeGotoPreviousSibling", "(J)Z", (void *)&tree_cursor_goto_previous_sibling},
+    {"nativeGotoDescendant", "(JI)V", (void *)&tree_cursor_goto_descendant},
+    {"nativeGotoFirstChildForByte", "(JI)J", (void *)&tree_cursor_native_goto_first_child_for_byte},
     {"nativeGotoFirstChildForPoint", "(L" PACKAGE "Point;)J",
      (void *)&tree_cursor_native_goto_first_child_for_point},
 };
@@ -0,0 +1,151 @@
+#include "accounting.h"
+#include "utils.h"
+
+bool counters_enabled = false;
+
+uint64_t counters[COUNTER_KIND_COUNT] = {0};
+
+jint JNICALL tree_sitter_allocator_kind CRITICAL_NO_ARGS() { return (jint)kts_allocator_kind(); }
+
+jlong JNICALL tree_sitter_allocated_bytes CRITICAL_NO_ARGS() {
+    KtsAllocatorStats stats;
+    kts_allocator_stats(&stats);
+    return (jlong)stats.allocated_bytes;
+}
+
+jlong JNICALL tree_sitter_peak_allocated_bytes CRITICAL_NO_ARGS() {
+    KtsAllocatorStats stats;
+    kts_allocator_stats(&stats);
+    return (jlong)stats.peak_allocated_bytes;
+}
+
+jlong JNICALL tree_sitter_allocation_count CRITICAL_NO_ARGS() {
+    KtsAllocatorStats stats;
+    kts_allocator_stats(&stats);
+    return (jlong)stats.allocation_count;
+}
+
+jlong JNICALL tree_sitter_live_objects CRITICAL_ARGS(jint kind) {
+    KtsObjectStats stats;
+    kts_memory_stats((uint32_t)kind, &stats);
+    return (jlong)stats.live_objects;
+}
+
+jlong JNICALL tree_sitter_object_bytes CRITICAL_ARGS(jint kind) {
+    KtsObjectStats stats;
+    kts_memory_stats((uint32_t)kind, &stats);
+    return (jlong)stats.bytes;
+}
+
+jlong JNICALL tree_sitter_tree_size(JNIEnv *env, jclass _class, jlongArray trees) {
+    jsize length = (*env)->GetArrayLength(env, trees);
+    jlong *elements = (*env)->GetLongArrayElements(env, trees, NULL);
+    if (elements == NULL)
+        return 0;
+    const TSTree **ts_trees = (const TSTree **)malloc((size_t)length * sizeof(TSTree *));
+    for (jsize i = 0; i < length; ++i)
+        ts_trees[i] = (const TSTree *)elements[i];
+    (*env)->ReleaseLongArrayElements(env, trees, elements, JNI_ABORT);
+    uint64_t size = kts_tree_size(ts_trees, (uint32_t)length);
+    free(ts_trees);
+    return (jlong)size;
+}
+
+jboolean JNICALL tree_sitter_get_counters_enabled CRITICAL_NO_ARGS() {
+    return (jboolean)counters_get_enabled();
+}
+
+void JNICALL tree_sitter_set_counters_enabled CRITICAL_ARGS(jboolean value) {
+    counters_set_enabled((bool)value);
+}
+
+jlong JNICALL tree_sitter_counter CRITICAL_ARGS(jint kind) {
+    return (jlong)counter_get((uint32_t)kind);
+}
+
+void JNICALL tree_sitter_reset_counters CRITICAL_NO_ARGS() {
+    for (uint32_t i = 0; i < COUNTER_KIND_COUNT; ++i)
+        counter_reset(i);
+}
+
+#ifndef __ANDROID__
+// The node functions receive the fields of the node like the getters in node.c,
+// so that the foreign function backend can pass them without allocating a struct.
+#define FOREIGN_NODE_FUNCTION(type, name)                                                          \
+    static type foreign_node_##name(NODE_ARGS) { return ts_node_##name(UNPACK_NODE()); }
+
+FOREIGN_NODE_FUNCTION(TSSymbol, symbol)
+FOREIGN_NODE_FUNCTION(TSSymbol, grammar_symbol)
+FOREIGN_NODE_FUNCTION(bool, is_named)
+FOREIGN_NODE_FUNCTION(bool, is_extra)
+FOREIGN_NODE_FUNCTION(bool, is_error)
+FOREIGN_NODE_FUNCTION(bool, is_missing)
+FOREIGN_NODE_FUNCTION(bool, has_error)
+FOREIGN_NODE_FUNCTION(bool, has_changes)
+FOREIGN_NODE_FUNCTION(TSStateId, parse_state)
+FOREIGN_NODE_FUNCTION(TSStateId, next_parse_state)
+FOREIGN_NODE_FUNCTION(uint32_t, start_byte)
+FOREIGN_NODE_FUNCTION(uint32_t, end_byte)
+FOREIGN_NODE_FUNCTION(uint32_t, child_count)
+FOREIGN_NODE_FUNCTION(uint32_t, named_child_count)
+FOREIGN_NODE_FUNCTION(uint32_t, descendant_count)
+
+// The functions that the foreign function backend calls directly,
+// in the order of the indices in ForeignBackend.kt.
+static const void *const foreign_functions[] = {
+    (const void *)&foreign_node_symbol,
+    (const void *)&foreign_node_grammar_symbol,
+    (const void *)&foreign_node_is_named,
+    (const void *)&foreign_node_is_extra,
+    (const void *)&foreign_node_is_error,
+    (const void *)&foreign_node_is_missing,
+    (const void *)&foreign_node_has_error,
+    (const void *)&foreign_node_has_changes,
+    (const void *)&foreign_node_parse_state,
+    (const void *)&foreign_node_next_parse_state,
+    (const void *)&foreign_node_start_byte,
+    (const void *)&foreign_node_end_byte,
+    (const void *)&foreign_node_child_count,
+    (const void *)&foreign_node_named_child_count,
+    (const void *)&foreign_node_descendant_count,
+    (const void *)&ts_tree_cursor_current_depth,
+    (const void *)&ts_tree_cursor_current_field_id,
+    (const void *)&ts_tree_cursor_current_descendant_index,
+    (const void *)&ts_tree_cursor_goto_first_child,
+    (const void *)&ts_tree_cursor_goto_last_child,
+    (const void *)&ts_tree_cursor_goto_parent,
+    (const void *)&ts_tree_cursor_goto_next_sibling,
+    (const void *)&ts_tree_cursor_goto_previous_sibling,
+};
+
+jlongArray JNICALL tree_sitter_foreign_functions(JNIEnv *env, jclass _class) {
+    jsize length = (jsize)(sizeof foreign_functions / sizeof(void *));
+    jlongArray result = (*env)->NewLongArray(env, length);
+    if (result == NULL)
+        return NULL;
+    jlong *addresses = (*env)->GetLongArrayElements(env, result, NULL);
+    for (jsize i = 0; i < length; ++i)
+        addresses[i] = (jlong)(intptr_t)foreign_functions[i];
+    (*env)->ReleaseLongArrayElements(env, result, addresses, 0);
+    return result;
+}
+#endif
+
+const JNINativeMethod TreeSitter_methods[] = {
+    {"allocatorKind", "()I", (void *)&tree_sitter_allocator_kind},
+    {"nativeAllocatedBytes", "()J", (void *)&tree_sitter_allocated_bytes},
+    {"nativePeakAllocatedBytes", "()J", (void *)&tree_sitter_peak_allocated_bytes},
+    {"nativeAllocationCount", "()J", (void *)&tree_sitter_allocation_count},
+    {"nativeLiveObjects", "(I)J", (void *)&tree_sitter_live_objects},
+    {"nativeObjectBytes", "(I)J", (void *)&tree_sitter_object_bytes},
+    {"nativeTreeSize", "([J)J", (void *)&tree_sitter_tree_size},
+    {"nativeCountersEnabled", "()Z", (void *)&tree_sitter_get_counters_enabled},
+    {"nativeSetCountersEnabled", "(Z)V", (void *)&tree_sitter_set_counters_enabled},
+    {"nativeCounter", "(I)J", (void *)&tree_sitter_counter},
+    {"resetCounters", "()V", (void *)&tree_sitter_reset_counters},
+#ifndef __ANDROID__
+    {"foreignFunctions", "()[J", (void *)&tree_sitter_foreign_functions},
+#endif
+};
+
+const size_t TreeSitter_methods_size = sizeof TreeSitter_methods / sizeof(JNINativeMethod);
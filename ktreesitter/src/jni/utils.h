@@ -1,8 +1,13 @@
 #pragma once
 
+#include <inttypes.h>
 #include <jni.h>
 #include <tree_sitter/api.h>
 
+#include "alloc.h"
+#include "clock.h"
+#include "counters.h"
+
 #define _xcat(a, b, c) a##b##c
 #define _cat3(a, b, c) _xcat(a, b, c)
 #define _cat2(a, b) _xcat(a, _, b)
@@ -41,6 +46,13 @@
 #define CRITICAL_NO_ARGS() ()
 #endif
 
+// The arguments of the getters that receive the fields of a node instead of the node itself,
+// so that they can be called without looking up the fields of the object through JNI.
+#define NODE_ARGS jlong id, jint context0, jint context1, jint context2, jint context3, jlong tree
+#define UNPACK_NODE()                                                                              \
+    ((TSNode){{(uint32_t)context0, (uint32_t)context1, (uint32_t)context2, (uint32_t)context3},    \
+              (const void *)id, (const TSTree *)tree})
+
 #if defined(__GNUC__) || defined(__clang__)
 #define UNREACHABLE() __builtin_unreachable()
 #elif defined(_MSC_VER)
@@ -56,6 +68,11 @@
 typedef struct {
     JNIEnv *env;
     jobject callback;
+    jobject listener;
+    uint32_t interval_bytes;
+    TSDuration interval;
+    uint32_t next_offset;
+    TSClock deadline;
 } ProgressPayload;
 
 typedef struct {
@@ -70,6 +87,8 @@ typedef struct {
     jfieldID InputEncoding_UTF_16LE;
     jfieldID InputEncoding_UTF_16BE;
     jfieldID Language_self;
+    jfieldID LogBuffer_capacity;
+    jfieldID LogBuffer_self;
     jfieldID LookaheadIterator_self;
     jfieldID Node_context;
     jfieldID Node_id;
@@ -79,13 +98,23 @@ typedef struct {
     jfieldID Parser$LogType_PARSE;
     jfieldID Parser_includedRanges;
     jfieldID Parser_language;
+    jfieldID Parser_logBuffer;
     jfieldID Parser_logger;
+    jfieldID Parser_memoryLimitBytes;
+    jfieldID Parser_progressIntervalBytes;
+    jfieldID Parser_progressIntervalMicros;
+    jfieldID Parser_progressListener;
     jfieldID Parser_self;
     jfieldID Parser_timeoutMicros;
     jfieldID Point_column;
     jfieldID Point_row;
     jfieldID QueryCursor_matchLimit;
     jfieldID QueryCursor_maxStartDepth;
+    jfieldID QueryCursor_memoryLimitBytes;
+    jfieldID QueryCursor_progressCallback;
+    jfieldID QueryCursor_progressIntervalBytes;
+    jfieldID QueryCursor_progressIntervalMicros;
+    jfieldID QueryCursor_progressListener;
     jfieldID QueryCursor_self;
     jfieldID QueryCursor_timeoutMicros;
     jfieldID Query_language;
@@ -116,6 +145,7 @@ typedef struct {
     jmethodID List_get;
     jmethodID List_size;
     jmethodID Node_init;
+    jmethodID ParseProgressListener_onProgress;
     jmethodID Pair_init;
     jmethodID Point_init;
     jmethodID QueryCapture_init;
@@ -126,6 +156,7 @@ typedef struct {
     jmethodID QueryError$Structure_init;
     jmethodID QueryError$Syntax_init;
     jmethodID QueryMatch_init;
+    jmethodID QueryProgressListener_onProgress;
     jmethodID Range_init;
     jmethodID Tree_init;
     jmethodID Triple_init;
@@ -144,10 +175,13 @@ typedef struct {
     jclass InputEncoding;
     jclass Language;
     jclass Language$Metadata;
+    jclass LogBuffer;
     jclass List;
     jclass LookaheadIterator;
+    jclass MemoryLimitExceededException;
     jclass Node;
     jclass Pair;
+    jclass ParseProgressListener;
     jclass Parser$LogType;
     jclass Parser;
     jclass Point;
@@ -160,9 +194,11 @@ typedef struct {
     jclass QueryError$Structure;
     jclass QueryError$Syntax;
     jclass QueryMatch;
+    jclass QueryProgressListener;
     jclass Range;
     jclass Tree;
     jclass TreeCursor;
+    jclass TreeSitter;
     jclass Triple;
     jclass UInt;
     jclass UShort;
@@ -174,6 +210,7 @@ extern ClassCache global_class_cache;
 extern JavaVM *java_vm;
 
 static inline jobject marshal_node(JNIEnv *env, TSNode ts_node, const jobject tree) {
+    count(COUNTER_NODES, 1);
     jintArray context = (*env)->NewIntArray(env, 4);
     (*env)->SetIntArrayRegion(env, context, 0, 4, (jint *)ts_node.context);
     return NEW_OBJECT(Node, (jlong)ts_node.id, context, tree);
@@ -195,6 +232,7 @@ static inline TSNode unmarshal_node(JNIEnv *env, const jobject node) {
 }
 
 static inline jobject marshal_point(JNIEnv *env, TSPoint ts_point) {
+    count(COUNTER_OBJECTS, 1);
     return NEW_OBJECT(Point, (jint)ts_point.row, (jint)ts_point.column);
 }
 
@@ -214,6 +252,7 @@ static inline TSRange unmarshal_range(JNIEnv *env, const jobject range) {
 }
 
 static inline jobject marshal_range(JNIEnv *env, const TSRange *ts_range) {
+    count(COUNTER_OBJECTS, 1);
     jint start_byte = (jint)ts_range->start_byte, end_byte = (jint)ts_range->end_byte;
     jobject start_point = marshal_point(env, ts_range->start_point),
             end_point = marshal_point(env, ts_range->end_point);
@@ -233,3 +272,45 @@ static inline TSInputEdit unmarshal_input_edit(JNIEnv *env, const jobject edit)
     ts_edit.new_end_point = unmarshal_point(env, newEndPoint);
     return ts_edit;
 }
+
+/** The number of integers in a packed InputEdit. */
+#define INPUT_EDIT_SIZE 9
+
+static inline TSInputEdit unpack_input_edit(const jint *edit) {
+    return (TSInputEdit){
+        .start_byte = (uint32_t)edit[0],
+        .old_end_byte = (uint32_t)edit[1],
+        .new_end_byte = (uint32_t)edit[2],
+        .start_point = {(uint32_t)edit[3], (uint32_t)edit[4]},
+        .old_end_point = {(uint32_t)edit[5], (uint32_t)edit[6]},
+        .new_end_point = {(uint32_t)edit[7], (uint32_t)edit[8]},
+    };
+}
+
+static inline void throw_memory_limit_exceeded(JNIEnv *env, uint64_t limit) {
+    char message[64];
+    sprintf_s(message, 64, "Memory limit of %" PRIu64 " bytes exceeded", limit);
+    THROW(MemoryLimitExceededException, message);
+}
+
+/** Start the intervals of the progress listener at the given byte offset. */
+static inline void progress_listener_start(ProgressPayload *payload, uint32_t offset) {
+    uint32_t next_offset = offset + payload->interval_bytes;
+    payload->next_offset = next_offset < offset ? UINT32_MAX : next_offset;
+    payload->deadline =
+        payload->interval != 0 ? clock_after(clock_now(), payload->interval) : clock_null();
+}
+
+/** Check if the progress listener is due at the given byte offset, without calling into Java. */
+static inline bool progress_listener_due(ProgressPayload *payload, uint32_t offset) {
+    if (payload->listener == NULL)
+        return false;
+    if (payload->interval_bytes == 0 && payload->interval == 0)
+        return true;
+    if ((payload->interval_bytes != 0 && offset >= payload->next_offset) ||
+        (payload->interval != 0 && clock_is_gt(clock_now(), payload->deadline))) {
+        progress_listener_start(payload, offset);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,126 @@
+package io.github.treesitter.ktreesitter
+
+import jdk.jfr.*
+
+/**
+ * The [JDK Flight Recorder](https://docs.oracle.com/en/java/javase/17/jfapi/) events
+ * of the library, which are all in the `Tree-sitter` category.
+ *
+ * The events are disabled unless a recording enables them, in which case
+ * creating and committing them is optimized away by the JIT compiler.
+ * If the runtime does not include the `jdk.jfr` module, no events are created.
+ */
+internal object FlightEvents {
+    /** Whether the runtime supports flight recorder events. */
+    @JvmField
+    val available = try {
+        Class.forName("jdk.jfr.Event")
+        true
+    } catch (_: ClassNotFoundException) {
+        false
+    } catch (_: LinkageError) {
+        false
+    }
+
+    /** Register the periodic native memory event. */
+    @JvmStatic
+    fun register() {
+        if (available) FlightRecorder.addPeriodicEvent(NativeMemoryEvent::class.java, ::emitMemory)
+    }
+
+    private var lastAllocatedBytes = 0L
+
+    private fun emitMemory() {
+        val event = NativeMemoryEvent()
+        if (!event.shouldCommit() || TreeSitter.allocator == NativeAllocator.SYSTEM) return
+        event.allocatedBytes = TreeSitter.allocatedBytes.toLong()
+        event.peakAllocatedBytes = TreeSitter.peakAllocatedBytes.toLong()
+        event.allocationCount = TreeSitter.allocationCount.toLong()
+        event.growthBytes = event.allocatedBytes - lastAllocatedBytes
+        lastAllocatedBytes = event.allocatedBytes
+        event.commit()
+    }
+}
+
+@Name("io.github.treesitter.ktreesitter.Parse")
+@Label("Parse")
+@Category("Tree-sitter")
+@Description("The parsing of a source code document")
+@StackTrace(false)
+internal class ParseEvent : Event() {
+    @Label("Language")
+    @JvmField
+    var language: String? = null
+
+    @Label("Bytes")
+    @DataAmount
+    @JvmField
+    var bytes = 0L
+
+    @Label("Incremental")
+    @Description("Whether an old tree was reused")
+    @JvmField
+    var incremental = false
+
+    @Label("Halted")
+    @Description("Whether parsing was halted by a callback, a timeout or a memory limit")
+    @JvmField
+    var halted = false
+}
+
+@Name("io.github.treesitter.ktreesitter.Query")
+@Label("Query Execution")
+@Category("Tree-sitter")
+@Description("The iteration over the matches or captures of a query cursor")
+@StackTrace(false)
+internal class QueryEvent : Event() {
+    @Label("Language")
+    @JvmField
+    var language: String? = null
+
+    @Label("Patterns")
+    @JvmField
+    var patterns = 0
+
+    @Label("Matches")
+    @Description("The number of matches or captures that were returned")
+    @JvmField
+    var matches = 0
+
+    @Label("Predicate Rejections")
+    @Description("The number of matches that were rejected by a predicate")
+    @JvmField
+    var predicateRejections = 0
+
+    @Label("Exceeded Match Limit")
+    @JvmField
+    var didExceedMatchLimit = false
+}
+
+@Name("io.github.treesitter.ktreesitter.NativeMemory")
+@Label("Native Memory")
+@Category("Tree-sitter")
+@Description("The memory that is allocated by the tracking or pooled allocator")
+@StackTrace(false)
+@Period("1 s")
+internal class NativeMemoryEvent : Event() {
+    @Label("Allocated")
+    @DataAmount
+    @JvmField
+    var allocatedBytes = 0L
+
+    @Label("Peak Allocated")
+    @DataAmount
+    @JvmField
+    var peakAllocatedBytes = 0L
+
+    @Label("Allocations")
+    @JvmField
+    var allocationCount = 0L
+
+    @Label("Growth")
+    @Description("The change of the allocated memory since the previous event")
+    @DataAmount
+    @JvmField
+    var growthBytes = 0L
+}
@@ -0,0 +1,257 @@
+package io.github.treesitter.ktreesitter
+
+import java.lang.invoke.MethodHandle
+import java.lang.invoke.MethodType
+import java.lang.reflect.Array as ReflectArray
+
+/**
+ * A backend that calls the hot native functions through the
+ * [Foreign Function & Memory API](https://openjdk.org/jeps/454) instead of JNI.
+ *
+ * The backend is enabled by setting the `ktreesitter.backend` system property
+ * to `foreign` when running on JDK 22 or newer. Otherwise every call goes through
+ * JNI, and a warning is logged if the backend was requested but cannot be linked.
+ * The JVM may print a warning unless native access is enabled with
+ * `--enable-native-access=ALL-UNNAMED`.
+ *
+ * Since the library targets JDK 17, the API is accessed through reflection
+ * once, when the backend is initialized. The resulting downcall handles are
+ * stored in constant fields, so that the JIT compiler can inline them.
+ *
+ * Nodes are passed to the native functions as their scalar fields,
+ * like the JNI getters, so that no memory is allocated per call.
+ */
+internal object ForeignBackend {
+    private const val BACKEND_PROPERTY = "ktreesitter.backend"
+
+    private const val MIN_JAVA_VERSION = 22
+
+    // The indices of the functions in the table of jni/tree_sitter.c
+    private const val NODE_SYMBOL = 0
+    private const val NODE_GRAMMAR_SYMBOL = 1
+    private const val NODE_IS_NAMED = 2
+    private const val NODE_IS_EXTRA = 3
+    private const val NODE_IS_ERROR = 4
+    private const val NODE_IS_MISSING = 5
+    private const val NODE_HAS_ERROR = 6
+    private const val NODE_HAS_CHANGES = 7
+    private const val NODE_PARSE_STATE = 8
+    private const val NODE_NEXT_PARSE_STATE = 9
+    private const val NODE_START_BYTE = 10
+    private const val NODE_END_BYTE = 11
+    private const val NODE_CHILD_COUNT = 12
+    private const val NODE_NAMED_CHILD_COUNT = 13
+    private const val NODE_DESCENDANT_COUNT = 14
+    private const val CURSOR_CURRENT_DEPTH = 15
+    private const val CURSOR_CURRENT_FIELD_ID = 16
+    private const val CURSOR_CURRENT_DESCENDANT_INDEX = 17
+    private const val CURSOR_GOTO_FIRST_CHILD = 18
+    private const val CURSOR_GOTO_LAST_CHILD = 19
+    private const val CURSOR_GOTO_PARENT = 20
+    private const val CURSOR_GOTO_NEXT_SIBLING = 21
+    private const val CURSOR_GOTO_PREVIOUS_SIBLING = 22
+
+    private val handles = if (System.getProperty(BACKEND_PROPERTY) != "foreign") {
+        null
+    } else {
+        try {
+            link()
+        } catch (ex: ReflectiveOperationException) {
+            warn(ex)
+        } catch (ex: RuntimeException) {
+            warn(ex)
+        } catch (ex: LinkageError) {
+            warn(ex)
+        }
+    }
+
+    /** Whether the functions are called through the foreign function backend. */
+    @JvmField
+    val enabled = handles != null
+
+    @JvmField
+    val nodeSymbol = handles?.get(NODE_SYMBOL)
+
+    @JvmField
+    val nodeGrammarSymbol = handles?.get(NODE_GRAMMAR_SYMBOL)
+
+    @JvmField
+    val nodeIsNamed = handles?.get(NODE_IS_NAMED)
+
+    @JvmField
+    val nodeIsExtra = handles?.get(NODE_IS_EXTRA)
+
+    @JvmField
+    val nodeIsError = handles?.get(NODE_IS_ERROR)
+
+    @JvmField
+    val nodeIsMissing = handles?.get(NODE_IS_MISSING)
+
+    @JvmField
+    val nodeHasError = handles?.get(NODE_HAS_ERROR)
+
+    @JvmField
+    val nodeHasChanges = handles?.get(NODE_HAS_CHANGES)
+
+    @JvmField
+    val nodeParseState = handles?.get(NODE_PARSE_STATE)
+
+    @JvmField
+    val nodeNextParseState = handles?.get(NODE_NEXT_PARSE_STATE)
+
+    @JvmField
+    val nodeStartByte = handles?.get(NODE_START_BYTE)
+
+    @JvmField
+    val nodeEndByte = handles?.get(NODE_END_BYTE)
+
+    @JvmField
+    val nodeChildCount = handles?.get(NODE_CHILD_COUNT)
+
+    @JvmField
+    val nodeNamedChildCount = handles?.get(NODE_NAMED_CHILD_COUNT)
+
+    @JvmField
+    val nodeDescendantCount = handles?.get(NODE_DESCENDANT_COUNT)
+
+    @JvmField
+    val cursorCurrentDepth = handles?.get(CURSOR_CURRENT_DEPTH)
+
+    @JvmField
+    val cursorCurrentFieldId = handles?.get(CURSOR_CURRENT_FIELD_ID)
+
+    @JvmField
+    val cursorCurrentDescendantIndex = handles?.get(CURSOR_CURRENT_DESCENDANT_INDEX)
+
+    @JvmField
+    val cursorGotoFirstChild = handles?.get(CURSOR_GOTO_FIRST_CHILD)
+
+    @JvmField
+    val cursorGotoLastChild = handles?.get(CURSOR_GOTO_LAST_CHILD)
+
+    @JvmField
+    val cursorGotoParent = handles?.get(CURSOR_GOTO_PARENT)
+
+    @JvmField
+    val cursorGotoNextSibling = handles?.get(CURSOR_GOTO_NEXT_SIBLING)
+
+    @JvmField
+    val cursorGotoPreviousSibling = handles?.get(CURSOR_GOTO_PREVIOUS_SIBLING)
+
+    /** Call a node function, which takes the fields of a node and returns an [Int]. */
+    @JvmStatic
+    fun callNode(handle: MethodHandle?, id: Long, context: IntArray, tree: Long) =
+        handle!!.invokeExact(id, context[0], context[1], context[2], context[3], tree) as Int
+
+    /** Call a cursor function, which takes a cursor pointer and returns an [Int]. */
+    @JvmStatic
+    fun callCursor(handle: MethodHandle?, cursor: Long) = handle!!.invokeExact(cursor) as Int
+
+    /** Log that the backend was requested but could not be linked. */
+    private fun warn(cause: Throwable): List<MethodHandle>? {
+        System.getLogger(ForeignBackend::class.java.name).log(
+            System.Logger.Level.WARNING,
+            "The foreign function backend could not be linked, falling back to JNI",
+            cause
+        )
+        return null
+    }
+
+    /** Create the downcall handles. */
+    @Throws(ReflectiveOperationException::class)
+    private fun link(): List<MethodHandle> {
+        if (Runtime.version().feature() < MIN_JAVA_VERSION)
+            throw UnsupportedOperationException("The backend requires JDK $MIN_JAVA_VERSION")
+
+        val layoutClass = Class.forName("java.lang.foreign.MemoryLayout")
+        val valueLayoutClass = Class.forName("java.lang.foreign.ValueLayout")
+        val descriptorClass = Class.forName("java.lang.foreign.FunctionDescriptor")
+        val segmentClass = Class.forName("java.lang.foreign.MemorySegment")
+        val linkerClass = Class.forName("java.lang.foreign.Linker")
+        val optionClass = Class.forName("java.lang.foreign.Linker\$Option")
+
+        fun typedArray(type: Class<*>, vararg elements: Any): Any {
+            val array = ReflectArray.newInstance(type, elements.size)
+            elements.forEachIndexed { index, element -> ReflectArray.set(array, index, element) }
+            return array
+        }
+
+        fun layout(name: String) = valueLayoutClass.getField(name).get(null)
+
+        val byteLayout = layout("JAVA_BYTE")
+        val shortLayout = layout("JAVA_SHORT")
+        val intLayout = layout("JAVA_INT")
+        val longLayout = layout("JAVA_LONG")
+        // Pointers are passed as longs, which have the same ABI on 64-bit platforms
+        val nodeArguments = arrayOf(
+            longLayout,
+            intLayout,
+            intLayout,
+            intLayout,
+            intLayout,
+            longLayout
+        )
+
+        val linker = linkerClass.getMethod("nativeLinker").invoke(null)
+        val options = typedArray(
+            optionClass,
+            optionClass.getMethod("critical", Boolean::class.java).invoke(null, false)
+        )
+        val descriptorOf = descriptorClass.getMethod("of", layoutClass, layoutClass.arrayType())
+        val ofAddress = segmentClass.getMethod("ofAddress", Long::class.java)
+        val downcallHandle = linkerClass.getMethod(
+            "downcallHandle",
+            segmentClass,
+            descriptorClass,
+            optionClass.arrayType()
+        )
+        val nodeType = MethodType.methodType(
+            Int::class.java,
+            Long::class.java,
+            Int::class.java,
+            Int::class.java,
+            Int::class.java,
+            Int::class.java,
+            Long::class.java
+        )
+        val cursorType = MethodType.methodType(Int::class.java, Long::class.java)
+        val addresses = TreeSitter.foreignFunctions()
+
+        fun downcall(index: Int, result: Any, vararg arguments: Any): MethodHandle {
+            val address = ofAddress.invoke(null, addresses[index])
+            val descriptor = descriptorOf.invoke(null, result, typedArray(layoutClass, *arguments))
+            return downcallHandle.invoke(linker, address, descriptor, options) as MethodHandle
+        }
+
+        fun node(index: Int, result: Any) = downcall(index, result, *nodeArguments).asType(nodeType)
+
+        fun cursor(index: Int, result: Any) = downcall(index, result, longLayout).asType(cursorType)
+
+        // C booleans are read as bytes, so that every handle returns an int
+        return listOf(
+            node(NODE_SYMBOL, shortLayout),
+            node(NODE_GRAMMAR_SYMBOL, shortLayout),
+            node(NODE_IS_NAMED, byteLayout),
+            node(NODE_IS_EXTRA, byteLayout),
+            node(NODE_IS_ERROR, byteLayout),
+            node(NODE_IS_MISSING, byteLayout),
+            node(NODE_HAS_ERROR, byteLayout),
+            node(NODE_HAS_CHANGES, byteLayout),
+            node(NODE_PARSE_STATE, shortLayout),
+            node(NODE_NEXT_PARSE_STATE, shortLayout),
+            node(NODE_START_BYTE, intLayout),
+            node(NODE_END_BYTE, intLayout),
+            node(NODE_CHILD_COUNT, intLayout),
+            node(NODE_NAMED_CHILD_COUNT, intLayout),
+            node(NODE_DESCENDANT_COUNT, intLayout),
+            cursor(CURSOR_CURRENT_DEPTH, intLayout),
+            cursor(CURSOR_CURRENT_FIELD_ID, shortLayout),
+            cursor(CURSOR_CURRENT_DESCENDANT_INDEX, intLayout),
+            cursor(CURSOR_GOTO_FIRST_CHILD, byteLayout),
+            cursor(CURSOR_GOTO_LAST_CHILD, byteLayout),
+            cursor(CURSOR_GOTO_PARENT, byteLayout),
+            cursor(CURSOR_GOTO_NEXT_SIBLING, byteLayout),
+            cursor(CURSOR_GOTO_PREVIOUS_SIBLING, byteLayout)
+        )
+    }
+}
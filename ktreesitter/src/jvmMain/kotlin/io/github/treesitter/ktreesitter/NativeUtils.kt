@@ -1,10 +1,40 @@
 package io.github.treesitter.ktreesitter
 
+import java.io.File
 import java.io.File.createTempFile
+import java.io.IOException
+import java.net.URL
+import java.nio.file.FileAlreadyExistsException
+import java.nio.file.Files
+import java.nio.file.LinkOption
+import java.nio.file.StandardCopyOption
+import java.nio.file.attribute.PosixFileAttributes
+import java.nio.file.attribute.PosixFilePermissions
+import java.security.MessageDigest
 
 internal object NativeUtils {
     private const val LIB_NAME = "ktreesitter"
 
+    /** A resource that names a grammar bundle which replaces the library. */
+    private const val BUNDLE_RESOURCE = "/META-INF/ktreesitter/library"
+
+    /** The system property that overrides the directory of extracted libraries. */
+    private const val CACHE_PROPERTY = "ktreesitter.cache.dir"
+
+    private val libName: String by lazy {
+        javaClass.getResource(BUNDLE_RESOURCE)?.readText()?.trim()?.ifEmpty { null } ?: LIB_NAME
+    }
+
+    private val library = lazy {
+        try {
+            System.loadLibrary(libName)
+        } catch (ex: UnsatisfiedLinkError) {
+            @Suppress("UnsafeDynamicallyLoadedCode")
+            System.load(libPath() ?: throw ex)
+        }
+        FlightEvents.register()
+    }
+
     @JvmStatic
     @Throws(UnsupportedOperationException::class)
     private fun libPath(): String? {
@@ -41,21 +71,80 @@ internal object NativeUtils {
             "aarch64" in archName || "arm64" in archName -> "aarch64"
             else -> throw UnsupportedOperationException("Unsupported architecture: $archName")
         }
-        val libUrl = javaClass.getResource("/lib/$os/$arch/$prefix$LIB_NAME.$ext") ?: return null
-        return createTempFile("$prefix$LIB_NAME", ".$ext").apply {
-            writeBytes(libUrl.openStream().use { it.readAllBytes() })
-            deleteOnExit()
-        }.path
+        val libUrl = javaClass.getResource("/lib/$os/$arch/$prefix$libName.$ext") ?: return null
+        return extract(libUrl, "$prefix$libName.$ext")
     }
 
+    /**
+     * Extract the library to a cache directory that is named after the hash of its
+     * contents, so that it is only written once rather than every time the process starts.
+     *
+     * An existing file is only loaded if its hash matches, and it is rewritten otherwise.
+     */
     @JvmStatic
-    @Throws(UnsatisfiedLinkError::class)
-    internal fun loadLibrary() {
+    @Throws(IOException::class)
+    private fun extract(url: URL, fileName: String): String {
+        val bytes = url.openStream().use { it.readAllBytes() }
+        val digest = sha256(bytes)
+        val hash = digest.joinToString("", limit = 16, truncated = "") { "%02x".format(it) }
+        val file = cacheDir().resolve(hash).resolve(fileName)
+        if (file.isFile && MessageDigest.isEqual(sha256(file.readBytes()), digest)) return file.path
+
+        // Write to a temporary file first, so that concurrent
+        // processes never load a partially written library.
+        file.parentFile.mkdirs()
+        val tempFile = createTempFile(fileName, null, file.parentFile)
         try {
-            System.loadLibrary(LIB_NAME)
-        } catch (ex: UnsatisfiedLinkError) {
-            @Suppress("UnsafeDynamicallyLoadedCode")
-            System.load(libPath() ?: throw ex)
+            tempFile.writeBytes(bytes)
+            Files.move(tempFile.toPath(), file.toPath(), StandardCopyOption.ATOMIC_MOVE)
+        } catch (ex: IOException) {
+            tempFile.delete()
+            if (!MessageDigest.isEqual(sha256(file.readBytes()), digest)) throw ex
+        }
+        return file.path
+    }
+
+    /**
+     * Get the directory of extracted libraries.
+     *
+     * Unless it is configured, this is a directory in the temporary directory that
+     * only the current user can access, so that other users cannot replace a library
+     * between the time it is checked and the time it is loaded. If that directory
+     * belongs to another user, a new temporary directory is used instead.
+     */
+    @JvmStatic
+    @Throws(IOException::class)
+    private fun cacheDir(): File {
+        System.getProperty(CACHE_PROPERTY)?.let { return File(it) }
+        val user = System.getProperty("user.name")
+        val dir = File(System.getProperty("java.io.tmpdir"), "$LIB_NAME-$user").toPath()
+        if ("posix" !in dir.fileSystem.supportedFileAttributeViews()) return dir.toFile()
+
+        val permissions = PosixFilePermissions.fromString("rwx------")
+        try {
+            Files.createDirectory(dir, PosixFilePermissions.asFileAttribute(permissions))
+        } catch (_: FileAlreadyExistsException) {
+        }
+        val attributes = Files.readAttributes(
+            dir,
+            PosixFileAttributes::class.java,
+            LinkOption.NOFOLLOW_LINKS
+        )
+        if (attributes.isDirectory &&
+            attributes.owner().name == user &&
+            attributes.permissions() == permissions
+        ) {
+            return dir.toFile()
         }
+        return Files.createTempDirectory(LIB_NAME).toFile()
+    }
+
+    @JvmStatic
+    private fun sha256(bytes: ByteArray) = MessageDigest.getInstance("SHA-256").digest(bytes)
+
+    @JvmStatic
+    @Throws(UnsatisfiedLinkError::class)
+    internal fun loadLibrary() {
+        library.value
     }
 }
@@ -1,5 +1,7 @@
 package io.github.treesitter.ktreesitter
 
+import java.lang.invoke.MethodHandle
+
 /** A single node within a [syntax tree][Tree]. */
 @Suppress("unused")
 actual class Node internal constructor(
@@ -22,7 +24,7 @@ actual class Node internal constructor(
     /** The numerical ID of the node's type. */
     @get:JvmName("getSymbol")
     actual val symbol: UShort
-        external get
+        get() = fields(ForeignBackend.nodeSymbol, ::nativeSymbol, Int::toShort).toUShort()
 
     /**
      * The numerical ID of the node's type,
@@ -30,7 +32,11 @@ actual class Node internal constructor(
      */
     @get:JvmName("getGrammarSymbol")
     actual val grammarSymbol: UShort
-        external get
+        get() = fields(
+            ForeignBackend.nodeGrammarSymbol,
+            ::nativeGrammarSymbol,
+            Int::toShort
+        ).toUShort()
 
     /** The type of the node. */
     actual val type: String
@@ -50,7 +56,7 @@ actual class Node internal constructor(
      * whereas _anonymous_ nodes correspond to string literals.
      */
     actual val isNamed: Boolean
-        external get
+        get() = fields(ForeignBackend.nodeIsNamed, ::nativeIsNamed) { it != 0 }
 
     /**
      * Check if the node is _extra_.
@@ -59,11 +65,11 @@ actual class Node internal constructor(
      * by the grammar but can appear anywhere (e.g. whitespace).
      */
     actual val isExtra: Boolean
-        external get
+        get() = fields(ForeignBackend.nodeIsExtra, ::nativeIsExtra) { it != 0 }
 
     /** Check if the node is a syntax error. */
     actual val isError: Boolean
-        external get
+        get() = fields(ForeignBackend.nodeIsError, ::nativeIsError) { it != 0 }
 
     /**
      * Check if the node is _missing_.
@@ -72,12 +78,12 @@ actual class Node internal constructor(
      * to recover from certain kinds of syntax errors.
      */
     actual val isMissing: Boolean
-        external get
+        get() = fields(ForeignBackend.nodeIsMissing, ::nativeIsMissing) { it != 0 }
 
     /** Check if the node has been edited. */
     @get:JvmName("hasChanges")
     actual val hasChanges: Boolean
-        external get
+        get() = fields(ForeignBackend.nodeHasChanges, ::nativeHasChanges) { it != 0 }
 
     /**
      * Check if the node is a syntax error,
@@ -85,27 +91,31 @@ actual class Node internal constructor(
      */
     @get:JvmName("hasError")
     actual val hasError: Boolean
-        external get
+        get() = fields(ForeignBackend.nodeHasError, ::nativeHasError) { it != 0 }
 
     /** The parse state of this node. */
     @get:JvmName("getParseState")
     actual val parseState: UShort
-        external get
+        get() = fields(ForeignBackend.nodeParseState, ::nativeParseState, Int::toShort).toUShort()
 
     /** The parse state after this node. */
     @get:JvmName("getNextParseState")
     actual val nextParseState: UShort
-        external get
+        get() = fields(
+            ForeignBackend.nodeNextParseState,
+            ::nativeNextParseState,
+            Int::toShort
+        ).toUShort()
 
     /** The start byte of the node. */
     @get:JvmName("getStartByte")
     actual val startByte: UInt
-        external get
+        get() = fields(ForeignBackend.nodeStartByte, ::nativeStartByte) { it }.toUInt()
 
     /** The end byte of the node. */
     @get:JvmName("getEndByte")
     actual val endByte: UInt
-        external get
+        get() = fields(ForeignBackend.nodeEndByte, ::nativeEndByte) { it }.toUInt()
 
     /** The range of the node in terms of bytes. */
     actual val byteRange: UIntRange
@@ -126,12 +136,12 @@ actual class Node internal constructor(
     /** The number of this node's children. */
     @get:JvmName("getChildCount")
     actual val childCount: UInt
-        external get
+        get() = fields(ForeignBackend.nodeChildCount, ::nativeChildCount) { it }.toUInt()
 
     /** The number of this node's _named_ children. */
     @get:JvmName("getNamedChildCount")
     actual val namedChildCount: UInt
-        external get
+        get() = fields(ForeignBackend.nodeNamedChildCount, ::nativeNamedChildCount) { it }.toUInt()
 
     /**
      * The number of this node's descendants,
@@ -139,7 +149,7 @@ actual class Node internal constructor(
      */
     @get:JvmName("getDescendantCount")
     actual val descendantCount: UInt
-        external get
+        get() = fields(ForeignBackend.nodeDescendantCount, ::nativeDescendantCount) { it }.toUInt()
 
     /** The node's immediate parent, if any. */
     actual val parent: Node?
@@ -316,6 +326,20 @@ actual class Node internal constructor(
     /** Get the S-expression of the node. */
     actual external fun sexp(): String
 
+    /**
+     * Count the nodes of each symbol in the subtree of this node, including itself.
+     *
+     * The result is indexed by the [symbol] of the nodes and has the size of the
+     * [symbol count][Language.symbolCount] of the language. Only the visible nodes,
+     * which are the ones that queries can match, are counted in a single native pass.
+     *
+     * @see QueryPlanner
+     * @since 0.26.0
+     */
+    @JvmName("symbolHistogram")
+    @OptIn(ExperimentalUnsignedTypes::class)
+    actual external fun symbolHistogram(): UIntArray
+
     actual override fun equals(other: Any?) =
         this === other || (other is Node && nativeEquals(other))
 
@@ -324,4 +348,179 @@ actual class Node internal constructor(
     override fun toString() = "Node(type=$type, startByte=$startByte, endByte=$endByte)"
 
     private external fun nativeEquals(that: Node): Boolean
+
+    /**
+     * Call a getter with the fields of the node, so that the
+     * native function does not have to look them up through JNI.
+     *
+     * If the [foreign function backend][ForeignBackend] is enabled,
+     * the given [handle] is called instead and its [result] is converted.
+     */
+    private inline fun <T> fields(
+        handle: MethodHandle?,
+        getter: (Long, Int, Int, Int, Int, Long) -> T,
+        result: (Int) -> T
+    ): T {
+        val context = context
+        try {
+            if (ForeignBackend.enabled) {
+                return result(ForeignBackend.callNode(handle, id.toLong(), context, tree.self))
+            }
+            return getter(id.toLong(), context[0], context[1], context[2], context[3], tree.self)
+        } finally {
+            RefCleaner.keepAlive(tree)
+        }
+    }
+
+    private companion object {
+        @JvmStatic
+        private external fun nativeSymbol(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Short
+
+        @JvmStatic
+        private external fun nativeGrammarSymbol(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Short
+
+        @JvmStatic
+        private external fun nativeIsNamed(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Boolean
+
+        @JvmStatic
+        private external fun nativeIsExtra(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Boolean
+
+        @JvmStatic
+        private external fun nativeIsError(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Boolean
+
+        @JvmStatic
+        private external fun nativeIsMissing(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Boolean
+
+        @JvmStatic
+        private external fun nativeHasError(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Boolean
+
+        @JvmStatic
+        private external fun nativeHasChanges(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Boolean
+
+        @JvmStatic
+        private external fun nativeParseState(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Short
+
+        @JvmStatic
+        private external fun nativeNextParseState(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Short
+
+        @JvmStatic
+        private external fun nativeStartByte(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Int
+
+        @JvmStatic
+        private external fun nativeEndByte(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Int
+
+        @JvmStatic
+        private external fun nativeChildCount(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Int
+
+        @JvmStatic
+        private external fun nativeNamedChildCount(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Int
+
+        @JvmStatic
+        private external fun nativeDescendantCount(
+            id: Long,
+            context0: Int,
+            context1: Int,
+            context2: Int,
+            context3: Int,
+            tree: Long
+        ): Int
+    }
 }
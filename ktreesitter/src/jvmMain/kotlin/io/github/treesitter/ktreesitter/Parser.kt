@@ -49,6 +49,81 @@ actual class Parser actual constructor() {
         external get
         external set
 
+    /**
+     * The maximum number of bytes that a single parse
+     * may allocate, or `0` if there is no limit.
+     *
+     * When the limit is exceeded, parsing is halted and
+     * a [MemoryLimitExceededException] is thrown.
+     *
+     * Default: `0`
+     *
+     * @throws [IllegalStateException]
+     *  If a limit is set while the [allocator][TreeSitter.allocator] does not track memory.
+     * @since 0.26.0
+     */
+    @get:JvmName("getMemoryLimitBytes")
+    @set:JvmName("setMemoryLimitBytes")
+    @set:Throws(IllegalStateException::class)
+    actual var memoryLimitBytes: ULong = 0UL
+        set(value) {
+            checkMemoryLimit(value)
+            field = value
+        }
+
+    /**
+     * The number of bytes of native memory that are held by the parser,
+     * not including the syntax trees that it has produced.
+     *
+     * This is always `0` when the [allocator][TreeSitter.allocator] is [NativeAllocator.SYSTEM].
+     *
+     * @since 0.26.0
+     */
+    @get:JvmName("getNativeSizeBytes")
+    actual val nativeSizeBytes: ULong
+        external get
+
+    /**
+     * A listener that can halt any parse, including the parses of strings.
+     *
+     * Unlike a [ParseProgressCallback], the listener receives unboxed arguments and is
+     * only called once every [progressIntervalBytes] or [progressIntervalMicros], so it
+     * is cheap enough to be kept around for cancellation. When it returns `true`,
+     * parsing is halted and can be resumed like a parse halted by a callback.
+     *
+     * @since 0.26.0
+     */
+    actual var progressListener: ParseProgressListener? = null
+
+    /**
+     * The number of bytes that must be parsed before
+     * the [progressListener] is called again.
+     *
+     * If both this and [progressIntervalMicros] are `0`, the listener is called
+     * every time the parser checks its progress. Otherwise, it is called as soon
+     * as either of the intervals has passed.
+     *
+     * Default: `0`
+     *
+     * @since 0.26.0
+     */
+    @get:JvmName("getProgressIntervalBytes")
+    @set:JvmName("setProgressIntervalBytes")
+    actual var progressIntervalBytes: UInt = 0U
+
+    /**
+     * The number of microseconds that must pass before
+     * the [progressListener] is called again.
+     *
+     * Default: `0`
+     *
+     * @see progressIntervalBytes
+     * @since 0.26.0
+     */
+    @get:JvmName("getProgressIntervalMicros")
+    @set:JvmName("setProgressIntervalMicros")
+    actual var progressIntervalMicros: ULong = 0UL
+
     /**
      * The logger that the parser will use during parsing.
      *
@@ -75,6 +150,17 @@ actual class Parser actual constructor() {
     actual var logger: LogFunction? = null
         external set
 
+    /**
+     * The buffer that records the log messages of the parser in native memory.
+     *
+     * A parser has either a [logger] or a log buffer,
+     * so setting one of them replaces the other.
+     *
+     * @since 0.26.0
+     */
+    actual var logBuffer: LogBuffer? = null
+        external set
+
     /**
      * Parse a source code string and create a syntax tree.
      *
@@ -86,9 +172,13 @@ actual class Parser actual constructor() {
      *
      * @throws [IllegalStateException]
      *  If the parser does not have a [language] assigned or if parsing was halted.
+     * @throws [MemoryLimitExceededException] If the [memory limit][memoryLimitBytes] is exceeded.
      */
     @Throws(IllegalStateException::class)
-    actual external fun parse(source: String, encoding: InputEncoding, oldTree: Tree?): Tree
+    actual fun parse(source: String, encoding: InputEncoding, oldTree: Tree?): Tree =
+        record(oldTree != null, { source.byteLength(encoding) }) {
+            nativeParse(source, encoding, oldTree)
+        }.also { it.encoding = encoding }
 
     /**
      * Parse source code from a callback and create a syntax tree.
@@ -101,14 +191,46 @@ actual class Parser actual constructor() {
      *
      * @throws [IllegalStateException]
      *  If the parser does not have a [language] assigned or if parsing was halted.
+     * @throws [MemoryLimitExceededException] If the [memory limit][memoryLimitBytes] is exceeded.
      */
     @Throws(IllegalStateException::class)
-    actual external fun parse(
+    actual fun parse(
         encoding: InputEncoding,
         oldTree: Tree?,
         progressCallback: ParseProgressCallback?,
         readCallback: ParseReadCallback
-    ): Tree
+    ): Tree = record(oldTree != null, { it?.rootNode?.endByte?.toLong() ?: 0L }) {
+        nativeParse(encoding, oldTree, progressCallback, readCallback)
+    }
+
+    /**
+     * Parse a new version of the source code of an old syntax tree.
+     *
+     * The changes between the [source text][Tree.text] of the old tree and [newSource]
+     * are computed and applied to a copy of the old tree, so that the unchanged parts
+     * of it can be reused without having to call [Tree.edit] manually. The old tree
+     * itself is left untouched. The edits are computed line by line and fall back
+     * to a single edit that spans all the changes when the versions differ too much.
+     * The old tree must have been parsed as [UTF-8][InputEncoding.UTF_8],
+     * and the new tree is parsed as UTF-8 as well.
+     *
+     * @throws [IllegalArgumentException]
+     *  If the old tree has no source text or was not parsed as UTF-8.
+     * @throws [IllegalStateException]
+     *  If the parser does not have a [language] assigned or if parsing was halted.
+     * @throws [MemoryLimitExceededException] If the [memory limit][memoryLimitBytes] is exceeded.
+     * @since 0.26.0
+     */
+    @Throws(IllegalArgumentException::class, IllegalStateException::class)
+    actual fun reparse(oldTree: Tree, newSource: String): Tree {
+        requireNotNull(oldTree.text()) { "The old tree has no source text" }
+        require(oldTree.encoding == InputEncoding.UTF_8) {
+            "The old tree was not parsed as UTF-8"
+        }
+        return record(true, { newSource.byteLength(InputEncoding.UTF_8) }) {
+            nativeReparse(oldTree, newSource)
+        }
+    }
 
     /**
      * Instruct the parser to start the next [parse] from the beginning.
@@ -125,6 +247,53 @@ actual class Parser actual constructor() {
     @Suppress("unused")
     actual enum class LogType { LEX, PARSE }
 
+    /** Record a [ParseEvent] for the given parse, if the event is enabled. */
+    private inline fun record(
+        incremental: Boolean,
+        bytes: (Tree?) -> Long,
+        parse: () -> Tree
+    ): Tree {
+        if (!FlightEvents.available) return parse()
+        val event = ParseEvent()
+        event.begin()
+        var tree: Tree? = null
+        try {
+            tree = parse()
+            return tree
+        } finally {
+            if (event.shouldCommit()) {
+                event.language = language?.name
+                event.bytes = bytes(tree)
+                event.incremental = incremental
+                event.halted = tree == null
+                event.commit()
+            }
+        }
+    }
+
+    /** Get the number of bytes of the string in the given encoding. */
+    private fun String.byteLength(encoding: InputEncoding): Long {
+        if (encoding != InputEncoding.UTF_8) return length * 2L
+        return sumOf {
+            when {
+                it.code < 0x80 -> 1L
+                it.code < 0x800 || it.isSurrogate() -> 2L
+                else -> 3L
+            }
+        }
+    }
+
+    private external fun nativeParse(source: String, encoding: InputEncoding, oldTree: Tree?): Tree
+
+    private external fun nativeParse(
+        encoding: InputEncoding,
+        oldTree: Tree?,
+        progressCallback: ParseProgressCallback?,
+        readCallback: ParseReadCallback
+    ): Tree
+
+    private external fun nativeReparse(oldTree: Tree, source: String): Tree
+
     private class CleanAction(private val ptr: Long) : Runnable {
         override fun run() = delete(ptr)
     }
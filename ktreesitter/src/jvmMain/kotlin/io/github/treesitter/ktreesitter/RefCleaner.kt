@@ -3,12 +3,19 @@
 package io.github.treesitter.ktreesitter
 
 import java.lang.ref.Cleaner
+import java.lang.ref.Reference
 
 internal object RefCleaner {
     private val INSTANCE: Cleaner = Cleaner.create()
 
     @JvmName("register")
-    operator fun invoke(obj: Any, action: Runnable) {
+    operator fun invoke(obj: Any, action: Runnable): Cleaner.Cleanable =
         INSTANCE.register(obj, action)
-    }
+
+    /**
+     * Keep the object from being cleaned until this point, so that a native
+     * call which only received its pointer cannot outlive the object.
+     */
+    @JvmStatic
+    fun keepAlive(obj: Any) = Reference.reachabilityFence(obj)
 }
@@ -3,22 +3,40 @@ package io.github.treesitter.ktreesitter
 /** A class that represents a syntax tree. */
 @Suppress("CanBeParameter")
 actual class Tree internal constructor(
-    private val self: Long,
+    internal val self: Long,
     private var source: String?,
     /** The language that was used to parse the syntax tree. */
     actual val language: Language
 ) {
-    init {
-        RefCleaner(this, CleanAction(self))
-    }
+    private val cleanable = RefCleaner(this, CleanAction(self))
 
     /** The root node of the syntax tree. */
     actual val rootNode: Node
         external get
 
+    private var lineIndex: LineIndex? = null
+
+    /** The encoding that the source code of the syntax tree was parsed with. */
+    internal var encoding = InputEncoding.UTF_8
+
     /** The included ranges that were used to parse the syntax tree. */
     actual val includedRanges by lazy { nativeIncludedRanges() }
 
+    /**
+     * The number of bytes of native memory that were allocated for the syntax tree.
+     *
+     * Subtrees that were reused from other trees, such as the trees that this
+     * tree was [copied][copy] from or incrementally parsed from, are not included.
+     * This is read without walking the tree, and it is always `0` when the
+     * [allocator][TreeSitter.allocator] is [NativeAllocator.SYSTEM].
+     * Use [TreeSitter.nativeSizeBytes] to measure the whole memory of several trees.
+     *
+     * @since 0.26.0
+     */
+    @get:JvmName("getNativeSizeBytes")
+    actual val nativeSizeBytes: ULong
+        external get
+
     /**
      * Get the root node of the syntax tree, but with
      * its position shifted forward by the given offset.
@@ -32,13 +50,27 @@ actual class Tree internal constructor(
      */
     actual external fun edit(edit: InputEdit)
 
+    /**
+     * Edit the syntax tree with a batch of edits, which are applied in order.
+     *
+     * This is equivalent to calling [edit] for every edit, and [Node.edit]
+     * for every edit on each of the given [nodes], but it is much faster.
+     *
+     * @param nodes The nodes that should also be kept in sync with the edits.
+     * @since 0.26.0
+     */
+    @JvmOverloads
+    actual fun edit(edits: List<InputEdit>, nodes: List<Node>) {
+        if (edits.isNotEmpty()) nativeEdit(edits.pack(), nodes.toTypedArray())
+    }
+
     /**
      * Create a shallow copy of the syntax tree.
      *
      * You need to copy a syntax tree in order to use it on multiple
      * threads or coroutines, as syntax trees are not thread safe.
      */
-    actual fun copy() = Tree(copy(self), source, language)
+    actual fun copy() = Tree(copy(self), source, language).also { it.encoding = encoding }
 
     /** Create a new tree cursor starting from the node of the tree. */
     actual fun walk() = TreeCursor(rootNode)
@@ -46,6 +78,18 @@ actual class Tree internal constructor(
     /** Get the source code of the syntax tree, if available. */
     actual fun text(): CharSequence? = source
 
+    /**
+     * Get a [line index][LineIndex] of the source code of the syntax tree, if available.
+     *
+     * The index is created on the first call and reused afterwards.
+     *
+     * @since 0.26.0
+     */
+    actual fun lineIndex(): LineIndex? {
+        val source = source ?: return null
+        return lineIndex ?: LineIndex(source).also { lineIndex = it }
+    }
+
     /**
      * Compare an old edited syntax tree to a new
      * syntax tree representing the same document.
@@ -57,10 +101,30 @@ actual class Tree internal constructor(
      */
     actual external fun changedRanges(newTree: Tree): List<Range>
 
+    /**
+     * Compute the structural differences between the named nodes
+     * of an old edited syntax tree and a new syntax tree.
+     *
+     * For this to work correctly, this tree must have been edited
+     * such that its ranges match up to the new tree, and the new
+     * tree must have been parsed with this tree as the old tree.
+     *
+     * @throws [IllegalStateException] If the differences could not be allocated.
+     * @since 0.26.0
+     */
+    @Throws(IllegalStateException::class)
+    actual fun diff(newTree: Tree) = TreeDiff(nativeDiff(newTree))
+
     override fun toString() = "Tree(language=$language, source=$source)"
 
+    internal actual fun release() = cleanable.clean()
+
     private external fun nativeIncludedRanges(): List<Range>
 
+    private external fun nativeEdit(edits: IntArray, nodes: Array<Node>)
+
+    private external fun nativeDiff(newTree: Tree): IntArray
+
     private class CleanAction(private val ptr: Long) : Runnable {
         override fun run() = delete(ptr)
     }
@@ -1,5 +1,7 @@
 package io.github.treesitter.ktreesitter
 
+import java.lang.invoke.MethodHandle
+
 /** A class that can be used to efficiently walk a [syntax tree][Tree]. */
 actual class TreeCursor private constructor(
     private val self: Long,
@@ -26,7 +28,7 @@ actual class TreeCursor private constructor(
      */
     @get:JvmName("getCurrentDepth")
     actual val currentDepth: UInt
-        external get
+        get() = call(ForeignBackend.cursorCurrentDepth, ::nativeCurrentDepth).toUInt()
 
     /**
      * The field ID of the tree cursor's current node, or `0`.
@@ -36,7 +38,9 @@ actual class TreeCursor private constructor(
      */
     @get:JvmName("getCurrentFieldId")
     actual val currentFieldId: UShort
-        external get
+        get() = call(ForeignBackend.cursorCurrentFieldId) {
+            nativeCurrentFieldId(it).toInt()
+        }.toUShort()
 
     /**
      * The field name of the tree cursor's current node, if available.
@@ -52,7 +56,10 @@ actual class TreeCursor private constructor(
      */
     @get:JvmName("getCurrentDescendantIndex")
     actual val currentDescendantIndex: UInt
-        external get
+        get() = call(
+            ForeignBackend.cursorCurrentDescendantIndex,
+            ::nativeCurrentDescendantIndex
+        ).toUInt()
 
     /** Create a shallow copy of the tree cursor. */
     actual fun copy() = TreeCursor(copy(self), tree)
@@ -70,7 +77,11 @@ actual class TreeCursor private constructor(
      *  `true` if the cursor successfully moved,
      *  or `false` if there were no children.
      */
-    actual external fun gotoFirstChild(): Boolean
+    actual fun gotoFirstChild(): Boolean {
+        if (!move(ForeignBackend.cursorGotoFirstChild, ::nativeGotoFirstChild)) return false
+        internalNode = null
+        return true
+    }
 
     /**
      * Move the cursor to the last child of its current node.
@@ -79,7 +90,11 @@ actual class TreeCursor private constructor(
      *  `true` if the cursor successfully moved,
      *  or `false` if there were no children.
      */
-    actual external fun gotoLastChild(): Boolean
+    actual fun gotoLastChild(): Boolean {
+        if (!move(ForeignBackend.cursorGotoLastChild, ::nativeGotoLastChild)) return false
+        internalNode = null
+        return true
+    }
 
     /**
      * Move the cursor to the parent of its current node.
@@ -88,7 +103,11 @@ actual class TreeCursor private constructor(
      *  `true` if the cursor successfully moved,
      *  or `false` if there was no parent node.
      */
-    actual external fun gotoParent(): Boolean
+    actual fun gotoParent(): Boolean {
+        if (!move(ForeignBackend.cursorGotoParent, ::nativeGotoParent)) return false
+        internalNode = null
+        return true
+    }
 
     /**
      * Move the cursor to the next sibling of its current node.
@@ -97,7 +116,11 @@ actual class TreeCursor private constructor(
      *  `true` if the cursor successfully moved,
      *  or `false` if there was no next sibling node.
      */
-    actual external fun gotoNextSibling(): Boolean
+    actual fun gotoNextSibling(): Boolean {
+        if (!move(ForeignBackend.cursorGotoNextSibling, ::nativeGotoNextSibling)) return false
+        internalNode = null
+        return true
+    }
 
     /**
      * Move the cursor to the previous sibling of its current node.
@@ -110,7 +133,12 @@ actual class TreeCursor private constructor(
      *  `true` if the cursor successfully moved,
      *  or `false` if there was no previous sibling node.
      */
-    actual external fun gotoPreviousSibling(): Boolean
+    actual fun gotoPreviousSibling(): Boolean {
+        val moved = move(ForeignBackend.cursorGotoPreviousSibling, ::nativeGotoPreviousSibling)
+        if (!moved) return false
+        internalNode = null
+        return true
+    }
 
     /**
      * Move the cursor to the node that is the nth descendant of
@@ -118,7 +146,14 @@ actual class TreeCursor private constructor(
      * where `0` represents the original node itself.
      */
     @JvmName("gotoDescendant")
-    actual external fun gotoDescendant(index: UInt)
+    actual fun gotoDescendant(index: UInt) {
+        try {
+            nativeGotoDescendant(self, index.toInt())
+        } finally {
+            RefCleaner.keepAlive(this)
+        }
+        internalNode = null
+    }
 
     /**
      * Move the cursor to the first child of its current
@@ -128,7 +163,11 @@ actual class TreeCursor private constructor(
      */
     @JvmName("gotoFirstChildForByte")
     actual fun gotoFirstChildForByte(byte: UInt): UInt? {
-        val result = nativeGotoFirstChildForByte(byte)
+        val result = try {
+            nativeGotoFirstChildForByte(self, byte.toInt())
+        } finally {
+            RefCleaner.keepAlive(this)
+        }
         if (result == -1L) return null
         internalNode = null
         return result.toUInt()
@@ -150,8 +189,25 @@ actual class TreeCursor private constructor(
 
     override fun toString() = "TreeCursor(tree=$tree)"
 
-    @JvmName("nativeGotoFirstChildForByte")
-    private external fun nativeGotoFirstChildForByte(byte: UInt): Long
+    /** Move the cursor through the [foreign backend][ForeignBackend] if it is enabled. */
+    private inline fun move(handle: MethodHandle?, native: (Long) -> Boolean) =
+        call(handle) { if (native(it)) 1 else 0 } != 0
+
+    /**
+     * Call a cursor function through the [foreign backend][ForeignBackend] if it is enabled,
+     * keeping the cursor alive until the call has returned, since it only receives the pointer.
+     */
+    private inline fun call(handle: MethodHandle?, native: (Long) -> Int): Int {
+        try {
+            return if (ForeignBackend.enabled) {
+                ForeignBackend.callCursor(handle, self)
+            } else {
+                native(self)
+            }
+        } finally {
+            RefCleaner.keepAlive(this)
+        }
+    }
 
     @JvmName("nativeGotoFirstChildForPoint")
     private external fun nativeGotoFirstChildForPoint(point: Point): Long
@@ -169,5 +225,35 @@ actual class TreeCursor private constructor(
 
         @JvmStatic
         private external fun delete(self: Long)
+
+        @JvmStatic
+        private external fun nativeCurrentDepth(self: Long): Int
+
+        @JvmStatic
+        private external fun nativeCurrentFieldId(self: Long): Short
+
+        @JvmStatic
+        private external fun nativeCurrentDescendantIndex(self: Long): Int
+
+        @JvmStatic
+        private external fun nativeGotoFirstChild(self: Long): Boolean
+
+        @JvmStatic
+        private external fun nativeGotoLastChild(self: Long): Boolean
+
+        @JvmStatic
+        private external fun nativeGotoParent(self: Long): Boolean
+
+        @JvmStatic
+        private external fun nativeGotoNextSibling(self: Long): Boolean
+
+        @JvmStatic
+        private external fun nativeGotoPreviousSibling(self: Long): Boolean
+
+        @JvmStatic
+        private external fun nativeGotoDescendant(self: Long, index: Int)
+
+        @JvmStatic
+        private external fun nativeGotoFirstChildForByte(self: Long, byte: Int): Long
     }
 }
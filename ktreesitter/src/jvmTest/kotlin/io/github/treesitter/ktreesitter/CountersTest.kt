@@ -0,0 +1,30 @@
+package io.github.treesitter.ktreesitter
+
+import io.github.treesitter.ktreesitter.java.TreeSitterJava
+import io.kotest.core.spec.style.FunSpec
+import io.kotest.matchers.*
+import io.kotest.matchers.comparables.*
+
+class CountersTest : FunSpec({
+    val language = Language(TreeSitterJava.language())
+
+    test("counters") {
+        TreeSitter.resetCounters()
+        TreeSitter.countersEnabled = true
+        try {
+            val cursor = Parser(language).parse("class Foo {}").walk()
+            val points = mutableListOf(cursor.currentNode.startPoint)
+            while (cursor.gotoFirstChild()) points.add(cursor.currentNode.startPoint)
+            points.size shouldBe 3
+            TreeSitter.jniCalls shouldBeGreaterThan 0UL
+            TreeSitter.nodesMarshaled shouldBeGreaterThan 0UL
+            TreeSitter.objectsMarshaled shouldBeGreaterThan 0UL
+        } finally {
+            TreeSitter.countersEnabled = false
+        }
+        TreeSitter.resetCounters()
+        TreeSitter.jniCalls shouldBe 0UL
+        TreeSitter.nodesMarshaled shouldBe 0UL
+        TreeSitter.objectsMarshaled shouldBe 0UL
+    }
+})
@@ -0,0 +1,11 @@
+package io.github.treesitter.ktreesitter
+
+import io.kotest.core.spec.style.FunSpec
+import io.kotest.matchers.*
+
+class ForeignBackendTest : FunSpec({
+    test("enabled") {
+        val requested = System.getProperty("ktreesitter.backend") == "foreign"
+        ForeignBackend.enabled shouldBe requested
+    }
+})
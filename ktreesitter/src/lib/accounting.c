@@ -0,0 +1,339 @@
+#include <stdlib.h>
+
+#include "accounting.h"
+#include "subtree.h"
+#include "tree.h"
+
+// Only kts_tree_size reads the private layout of the subtrees and trees of tree-sitter,
+// which must be checked again whenever the language ABI of tree-sitter changes.
+#if TREE_SITTER_LANGUAGE_VERSION != 15
+#error "The subtree layout has not been checked against this version of tree-sitter"
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/** The initial capacity of the pointer tables, which must be a power of two. */
+#define INITIAL_CAPACITY 64
+
+// The tables in this file use the system allocator directly,
+// so that the bookkeeping is not accounted for by itself.
+
+typedef struct {
+    const void *key;
+    uint32_t kind;
+    int64_t bytes;
+} Entry;
+
+typedef struct {
+    Entry *entries;
+    uint32_t capacity;
+    uint32_t size;
+} PointerTable;
+
+/** The number of registry shards, which must be a power of two. */
+#define SHARD_COUNT 16
+
+#ifdef _WIN32
+typedef SRWLOCK Lock;
+#define LOCK_INIT SRWLOCK_INIT
+#define LOCK(shard) AcquireSRWLockExclusive(&(shard)->lock)
+#define UNLOCK(shard) ReleaseSRWLockExclusive(&(shard)->lock)
+#else
+typedef pthread_mutex_t Lock;
+#define LOCK_INIT PTHREAD_MUTEX_INITIALIZER
+#define LOCK(shard) pthread_mutex_lock(&(shard)->lock)
+#define UNLOCK(shard) pthread_mutex_unlock(&(shard)->lock)
+#endif
+
+/**
+ * A part of the registry of tracked objects.
+ *
+ * Objects are spread over the shards by their address, so that threads
+ * which create and delete different objects rarely wait for each other.
+ */
+typedef struct {
+    Lock lock;
+    PointerTable table;
+} Shard;
+
+#define SHARD_INIT {LOCK_INIT, {0}}
+#define SHARDS_4 SHARD_INIT, SHARD_INIT, SHARD_INIT, SHARD_INIT
+
+static Shard shards[SHARD_COUNT] = {SHARDS_4, SHARDS_4, SHARDS_4, SHARDS_4};
+
+// The statistics of every kind are updated atomically, outside of the shard locks.
+static KtsObjectStats kind_stats[KTS_OBJECT_KIND_COUNT] = {{0}};
+
+static inline void atomic_add(uint64_t *ptr, uint64_t value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    _InterlockedExchangeAdd64((volatile int64_t *)ptr, (int64_t)value);
+#else
+    __atomic_add_fetch(ptr, value, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline uint64_t atomic_get(uint64_t *ptr) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (uint64_t)_InterlockedOr64((volatile int64_t *)ptr, 0);
+#else
+    return __atomic_load_n(ptr, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline uint32_t hash_pointer(const void *key, uint32_t capacity) {
+    uint64_t hash = (uint64_t)(uintptr_t)key * UINT64_C(0x9E3779B97F4A7C15);
+    return (uint32_t)(hash >> 32) & (capacity - 1);
+}
+
+static inline Shard *shard_for(const void *key) {
+    uint64_t hash = (uint64_t)(uintptr_t)key * UINT64_C(0x9E3779B97F4A7C15);
+    // The low bits of the hash select the slot within the table of the shard
+    return &shards[(hash >> 60) & (SHARD_COUNT - 1)];
+}
+
+static inline Entry *table_find(const PointerTable *table, const void *key) {
+    if (table->capacity == 0)
+        return NULL;
+    uint32_t index = hash_pointer(key, table->capacity);
+    while (table->entries[index].key != NULL) {
+        if (table->entries[index].key == key)
+            return &table->entries[index];
+        index = (index + 1) & (table->capacity - 1);
+    }
+    return NULL;
+}
+
+static bool table_grow(PointerTable *table) {
+    uint32_t capacity = table->capacity ? table->capacity * 2 : INITIAL_CAPACITY;
+    Entry *entries = calloc(capacity, sizeof(Entry));
+    if (entries == NULL)
+        return false;
+    for (uint32_t i = 0; i < table->capacity; ++i) {
+        if (table->entries[i].key == NULL)
+            continue;
+        uint32_t index = hash_pointer(table->entries[i].key, capacity);
+        while (entries[index].key != NULL)
+            index = (index + 1) & (capacity - 1);
+        entries[index] = table->entries[i];
+    }
+    free(table->entries);
+    table->entries = entries;
+    table->capacity = capacity;
+    return true;
+}
+
+/** Insert the key if it's not present, and return its entry or `NULL` on failure. */
+static Entry *table_insert(PointerTable *table, const void *key, bool *inserted) {
+    if ((table->size + 1) * 4 > table->capacity * 3 && !table_grow(table))
+        return NULL;
+    uint32_t index = hash_pointer(key, table->capacity);
+    while (table->entries[index].key != NULL) {
+        if (table->entries[index].key == key) {
+            *inserted = false;
+            return &table->entries[index];
+        }
+        index = (index + 1) & (table->capacity - 1);
+    }
+    table->entries[index].key = key;
+    table->size += 1;
+    *inserted = true;
+    return &table->entries[index];
+}
+
+static void table_remove(PointerTable *table, Entry *entry) {
+    uint32_t mask = table->capacity - 1;
+    uint32_t hole = (uint32_t)(entry - table->entries);
+    uint32_t index = hole;
+    table->entries[hole].key = NULL;
+    table->size -= 1;
+    // Shift the following entries back so that no probe sequence is broken.
+    for (;;) {
+        index = (index + 1) & mask;
+        if (table->entries[index].key == NULL)
+            return;
+        uint32_t home = hash_pointer(table->entries[index].key, table->capacity);
+        if (((index - home) & mask) >= ((index - hole) & mask)) {
+            table->entries[hole] = table->entries[index];
+            table->entries[index].key = NULL;
+            hole = index;
+        }
+    }
+}
+
+static inline uint64_t clamp_bytes(int64_t bytes) { return bytes > 0 ? (uint64_t)bytes : 0; }
+
+/** Update the statistics of a kind, where a negative change wraps around. */
+static inline void update_stats(uint32_t kind, int64_t objects, int64_t bytes) {
+    if (objects != 0)
+        atomic_add(&kind_stats[kind].live_objects, (uint64_t)objects);
+    if (bytes != 0)
+        atomic_add(&kind_stats[kind].bytes, (uint64_t)bytes);
+}
+
+void kts_memory_scope_enter(KtsMemoryScope *scope, uint64_t limit) {
+    scope->budget.limit = limit ? limit : UINT64_MAX;
+    scope->budget.used = 0;
+    scope->budget.exceeded = false;
+    scope->previous_budget = kts_allocator_swap_budget(&scope->budget);
+}
+
+int64_t kts_memory_scope_leave(KtsMemoryScope *scope) {
+    kts_allocator_swap_budget(scope->previous_budget);
+    if (scope->previous_budget != NULL) {
+        // Nested scopes are also charged to the enclosing scope.
+        scope->previous_budget->used += scope->budget.used;
+        if (scope->previous_budget->used > 0 &&
+            (uint64_t)scope->previous_budget->used > scope->previous_budget->limit)
+            scope->previous_budget->exceeded = true;
+    }
+    return scope->budget.used;
+}
+
+void kts_memory_track(uint32_t kind, const void *object, int64_t bytes) {
+    if (object == NULL || kind >= KTS_OBJECT_KIND_COUNT)
+        return;
+    Shard *shard = shard_for(object);
+    LOCK(shard);
+    bool inserted;
+    Entry *entry = table_insert(&shard->table, object, &inserted);
+    if (entry != NULL) {
+        // The address of an object that was never untracked may be reused.
+        if (!inserted)
+            update_stats(entry->kind, -1, -(int64_t)clamp_bytes(entry->bytes));
+        entry->kind = kind;
+        entry->bytes = bytes;
+        update_stats(kind, 1, (int64_t)clamp_bytes(bytes));
+    }
+    UNLOCK(shard);
+}
+
+void kts_memory_charge(const void *object, int64_t bytes) {
+    if (object == NULL || bytes == 0)
+        return;
+    Shard *shard = shard_for(object);
+    LOCK(shard);
+    Entry *entry = table_find(&shard->table, object);
+    if (entry != NULL) {
+        uint64_t previous = clamp_bytes(entry->bytes);
+        entry->bytes += bytes;
+        update_stats(entry->kind, 0, (int64_t)(clamp_bytes(entry->bytes) - previous));
+    }
+    UNLOCK(shard);
+}
+
+void kts_memory_untrack(const void *object) {
+    if (object == NULL)
+        return;
+    Shard *shard = shard_for(object);
+    LOCK(shard);
+    Entry *entry = table_find(&shard->table, object);
+    if (entry != NULL) {
+        update_stats(entry->kind, -1, -(int64_t)clamp_bytes(entry->bytes));
+        table_remove(&shard->table, entry);
+    }
+    UNLOCK(shard);
+}
+
+uint64_t kts_memory_size(const void *object) {
+    Shard *shard = shard_for(object);
+    LOCK(shard);
+    Entry *entry = table_find(&shard->table, object);
+    uint64_t bytes = entry != NULL ? clamp_bytes(entry->bytes) : 0;
+    UNLOCK(shard);
+    return bytes;
+}
+
+void kts_memory_stats(uint32_t kind, KtsObjectStats *stats) {
+    if (kind >= KTS_OBJECT_KIND_COUNT) {
+        stats->live_objects = stats->bytes = 0;
+        return;
+    }
+    stats->live_objects = atomic_get(&kind_stats[kind].live_objects);
+    stats->bytes = atomic_get(&kind_stats[kind].bytes);
+}
+
+static inline uint64_t heap_subtree_size(const SubtreeHeapData *data) {
+    uint64_t size = (uint64_t)data->child_count * sizeof(Subtree) + sizeof(SubtreeHeapData);
+    if (data->child_count == 0 && data->has_external_tokens &&
+        data->external_scanner_state.length > sizeof(data->external_scanner_state.short_data))
+        size += data->external_scanner_state.length;
+    return size;
+}
+
+static inline uint64_t tree_struct_size(const TSTree *tree) {
+    return sizeof(TSTree) + (uint64_t)tree->included_range_count * sizeof(TSRange);
+}
+
+/**
+ * Sum up the sizes of the heap subtrees that are reachable from the root.
+ *
+ * The `visited` table is shared between calls in order to skip duplicates.
+ */
+static uint64_t subtree_size(Subtree root, PointerTable *visited) {
+    if (root.data.is_inline)
+        return 0;
+
+    uint64_t size = 0;
+    uint32_t stack_size = 0, stack_capacity = INITIAL_CAPACITY;
+    const SubtreeHeapData **stack = malloc(stack_capacity * sizeof(SubtreeHeapData *));
+    if (stack == NULL)
+        return 0;
+    stack[stack_size++] = root.ptr;
+
+    while (stack_size > 0) {
+        const SubtreeHeapData *data = stack[--stack_size];
+        bool inserted;
+        if (table_insert(visited, data, &inserted) == NULL)
+            break;
+        if (!inserted)
+            continue;
+
+        size += heap_subtree_size(data);
+        const Subtree *children = (const Subtree *)data - data->child_count;
+        for (uint32_t i = 0; i < data->child_count; ++i) {
+            if (children[i].data.is_inline)
+                continue;
+            if (stack_size == stack_capacity) {
+                stack_capacity *= 2;
+                const SubtreeHeapData **new_stack =
+                    realloc(stack, stack_capacity * sizeof(SubtreeHeapData *));
+                if (new_stack == NULL) {
+                    free(stack);
+                    return size;
+                }
+                stack = new_stack;
+            }
+            stack[stack_size++] = children[i].ptr;
+        }
+    }
+
+    free(stack);
+    return size;
+}
+
+uint64_t kts_tree_size(const TSTree *const *trees, uint32_t count) {
+    PointerTable visited = {0};
+    uint64_t size = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        size += tree_struct_size(trees[i]);
+        size += subtree_size(trees[i]->root, &visited);
+    }
+    free(visited.entries);
+    return size;
+}
+
+void kts_memory_track_parse(const TSParser *parser, const TSTree *tree, int64_t allocated) {
+    if (tree == NULL) {
+        kts_memory_charge(parser, allocated);
+        return;
+    }
+    // Reused subtrees were allocated by earlier parses, so the net allocations
+    // of this parse are the new subtrees, along with any growth of the parser.
+    int64_t tree_bytes = allocated > 0 ? allocated : 0;
+    kts_memory_track(KTS_OBJECT_TREE, tree, tree_bytes);
+    kts_memory_charge(parser, allocated - tree_bytes);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+#include "allocator.h"
+
+#define KTS_OBJECT_PARSER 0
+#define KTS_OBJECT_TREE 1
+#define KTS_OBJECT_QUERY 2
+
+/** The number of object kinds that are accounted for. */
+#define KTS_OBJECT_KIND_COUNT 3
+
+typedef struct {
+    uint64_t live_objects;
+    uint64_t bytes;
+} KtsObjectStats;
+
+/**
+ * A region of code whose allocations are charged to a single object.
+ *
+ * Scopes nest with the memory budgets of the allocator,
+ * so an optional limit can be enforced at the same time.
+ */
+typedef struct {
+    KtsMemoryBudget budget;
+    KtsMemoryBudget *previous_budget;
+} KtsMemoryScope;
+
+/**
+ * Start charging the allocations of the current thread to the given scope.
+ *
+ * A `limit` of `0` means that the scope is unlimited.
+ */
+void kts_memory_scope_enter(KtsMemoryScope *scope, uint64_t limit);
+
+/** Stop charging allocations to the scope and return the net number of bytes. */
+int64_t kts_memory_scope_leave(KtsMemoryScope *scope);
+
+/** Start tracking a newly created object of the given kind. */
+void kts_memory_track(uint32_t kind, const void *object, int64_t bytes);
+
+/** Adjust the number of bytes that are attributed to a tracked object. */
+void kts_memory_charge(const void *object, int64_t bytes);
+
+/** Stop tracking an object that is about to be deleted. */
+void kts_memory_untrack(const void *object);
+
+/** Get the number of bytes that are attributed to a tracked object. */
+uint64_t kts_memory_size(const void *object);
+
+/**
+ * Get the statistics of all the live objects of the given kind.
+ *
+ * The counters are updated concurrently, so they may be slightly out of sync.
+ */
+void kts_memory_stats(uint32_t kind, KtsObjectStats *stats);
+
+/**
+ * Get the number of bytes that are held by the given syntax trees.
+ *
+ * Subtrees that are shared between the trees are only counted once.
+ * This walks all the trees, unlike kts_memory_size.
+ */
+uint64_t kts_tree_size(const TSTree *const *trees, uint32_t count);
+
+/**
+ * Account for a tree that was returned by the given parser.
+ *
+ * The net `allocated` bytes of the parse are attributed to the new tree, without
+ * walking it, since they consist of the subtrees that were not reused. If they are
+ * negative, or if there is no tree, they are attributed to the parser instead.
+ */
+void kts_memory_track_parse(const TSParser *parser, const TSTree *tree, int64_t allocated);
@@ -0,0 +1,407 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tree_sitter/api.h>
+
+#include "accounting.h"
+#include "allocator.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+/** The size of the header that precedes every tracked block. */
+#define HEADER_SIZE sizeof(BlockHeader)
+
+/** The granularity of the pooled size classes. */
+#define SIZE_CLASS_STEP 16
+
+/** The number of pooled size classes, which covers blocks of up to 512 bytes. */
+#define SIZE_CLASS_COUNT 32
+
+/** The kind that is set while an allocator is being installed. */
+#define KIND_INSTALLING UINT32_MAX
+
+/** The maximum number of free blocks that a thread keeps per size class. */
+#define MAX_CACHED_BLOCKS 64
+
+#define HEADER(ptr) ((BlockHeader *)((char *)(ptr) - HEADER_SIZE))
+#define DATA(header) ((void *)((char *)(header) + HEADER_SIZE))
+
+typedef struct {
+    uint64_t size;
+    uint32_t size_class;
+    uint32_t reserved;
+} BlockHeader;
+
+typedef struct FreeBlock {
+    struct FreeBlock *next;
+} FreeBlock;
+
+typedef struct {
+    FreeBlock *blocks[SIZE_CLASS_COUNT];
+    uint32_t counts[SIZE_CLASS_COUNT];
+} ThreadCache;
+
+static uint32_t installed_kind = KTS_ALLOCATOR_SYSTEM;
+
+static KtsAllocatorStats global_stats = {0};
+
+static THREAD_LOCAL ThreadCache *thread_cache = NULL;
+
+static THREAD_LOCAL KtsMemoryBudget *thread_budget = NULL;
+
+#ifdef _WIN32
+static DWORD thread_cache_key = FLS_OUT_OF_INDEXES;
+#else
+static pthread_key_t thread_cache_key;
+#endif
+
+static inline uint64_t atomic_add(uint64_t *ptr, uint64_t value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (uint64_t)_InterlockedExchangeAdd64((volatile int64_t *)ptr, (int64_t)value) + value;
+#else
+    return __atomic_add_fetch(ptr, value, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline uint64_t atomic_sub(uint64_t *ptr, uint64_t value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (uint64_t)_InterlockedExchangeAdd64((volatile int64_t *)ptr, -(int64_t)value) - value;
+#else
+    return __atomic_sub_fetch(ptr, value, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline uint64_t atomic_get(uint64_t *ptr) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (uint64_t)_InterlockedOr64((volatile int64_t *)ptr, 0);
+#else
+    return __atomic_load_n(ptr, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline bool atomic_swap_if(uint64_t *ptr, uint64_t expected, uint64_t desired) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _InterlockedCompareExchange64((volatile int64_t *)ptr, (int64_t)desired,
+                                         (int64_t)expected) == (int64_t)expected;
+#else
+    return __atomic_compare_exchange_n(ptr, &expected, desired, true, __ATOMIC_RELAXED,
+                                       __ATOMIC_RELAXED);
+#endif
+}
+
+static inline uint32_t get_kind(void) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return (uint32_t)_InterlockedOr((volatile long *)&installed_kind, 0);
+#else
+    return __atomic_load_n(&installed_kind, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void set_kind(uint32_t kind) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    _InterlockedExchange((volatile long *)&installed_kind, (long)kind);
+#else
+    __atomic_store_n(&installed_kind, kind, __ATOMIC_RELEASE);
+#endif
+}
+
+static inline bool swap_kind_if(uint32_t expected, uint32_t desired) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _InterlockedCompareExchange((volatile long *)&installed_kind, (long)desired,
+                                       (long)expected) == (long)expected;
+#else
+    return __atomic_compare_exchange_n(&installed_kind, &expected, desired, false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+#endif
+}
+
+/** Check if any parser, tree or query that was allocated by tree-sitter is still alive. */
+static bool has_live_objects(void) {
+    for (uint32_t kind = 0; kind < KTS_OBJECT_KIND_COUNT; ++kind) {
+        KtsObjectStats stats;
+        kts_memory_stats(kind, &stats);
+        if (stats.live_objects != 0)
+            return true;
+    }
+    return false;
+}
+
+static inline void *check_alloc(void *ptr, size_t size) {
+    if (ptr == NULL && size > 0) {
+        fprintf(stderr, "tree-sitter failed to allocate %zu bytes", size);
+        abort();
+    }
+    return ptr;
+}
+
+static inline void update_peak(uint64_t current) {
+    uint64_t peak = atomic_get(&global_stats.peak_allocated_bytes);
+    while (current > peak && !atomic_swap_if(&global_stats.peak_allocated_bytes, peak, current))
+        peak = atomic_get(&global_stats.peak_allocated_bytes);
+}
+
+static inline void charge_budget(int64_t size) {
+    KtsMemoryBudget *budget = thread_budget;
+    if (budget == NULL)
+        return;
+    budget->used += size;
+    if (budget->used > 0 && (uint64_t)budget->used > budget->limit)
+        budget->exceeded = true;
+}
+
+static inline void track_alloc(size_t size) {
+    atomic_add(&global_stats.allocation_count, 1);
+    update_peak(atomic_add(&global_stats.allocated_bytes, size));
+    charge_budget((int64_t)size);
+}
+
+static inline void track_free(size_t size) {
+    atomic_sub(&global_stats.allocation_count, 1);
+    atomic_sub(&global_stats.allocated_bytes, size);
+    charge_budget(-(int64_t)size);
+}
+
+static inline void track_resize(size_t old_size, size_t new_size) {
+    if (new_size > old_size)
+        update_peak(atomic_add(&global_stats.allocated_bytes, new_size - old_size));
+    else
+        atomic_sub(&global_stats.allocated_bytes, old_size - new_size);
+    charge_budget((int64_t)new_size - (int64_t)old_size);
+}
+
+static void *tracking_malloc(size_t size) {
+    BlockHeader *header = check_alloc(malloc(HEADER_SIZE + size), HEADER_SIZE + size);
+    header->size = size;
+    header->size_class = 0;
+    track_alloc(size);
+    return DATA(header);
+}
+
+static void *tracking_calloc(size_t count, size_t size) {
+    if (size != 0 && count > (SIZE_MAX - HEADER_SIZE) / size)
+        return check_alloc(NULL, SIZE_MAX);
+    BlockHeader *header =
+        check_alloc(calloc(1, HEADER_SIZE + count * size), HEADER_SIZE + count * size);
+    header->size = count * size;
+    header->size_class = 0;
+    track_alloc(count * size);
+    return DATA(header);
+}
+
+static void *tracking_realloc(void *ptr, size_t size) {
+    if (ptr == NULL)
+        return tracking_malloc(size);
+    size_t old_size = HEADER(ptr)->size;
+    BlockHeader *header =
+        check_alloc(realloc(HEADER(ptr), HEADER_SIZE + size), HEADER_SIZE + size);
+    header->size = size;
+    track_resize(old_size, size);
+    return DATA(header);
+}
+
+static void tracking_free(void *ptr) {
+    if (ptr == NULL)
+        return;
+    BlockHeader *header = HEADER(ptr);
+    track_free(header->size);
+    free(header);
+}
+
+static void thread_cache_destroy(void *data) {
+    ThreadCache *cache = (ThreadCache *)data;
+    for (uint32_t i = 0; i < SIZE_CLASS_COUNT; ++i) {
+        FreeBlock *block = cache->blocks[i];
+        while (block != NULL) {
+            FreeBlock *next = block->next;
+            free(block);
+            block = next;
+        }
+    }
+    if (thread_cache == cache)
+        thread_cache = NULL;
+    free(cache);
+}
+
+#ifdef _WIN32
+static void WINAPI thread_cache_release(void *data) {
+    if (data != NULL)
+        thread_cache_destroy(data);
+}
+#endif
+
+static inline ThreadCache *get_thread_cache(void) {
+    ThreadCache *cache = thread_cache;
+    if (cache != NULL)
+        return cache;
+
+    cache = calloc(1, sizeof(ThreadCache));
+    if (cache == NULL)
+        return NULL;
+#ifdef _WIN32
+    FlsSetValue(thread_cache_key, cache);
+#else
+    pthread_setspecific(thread_cache_key, cache);
+#endif
+    thread_cache = cache;
+    return cache;
+}
+
+static inline uint32_t size_class_for(size_t size) {
+    if (size > SIZE_CLASS_STEP * SIZE_CLASS_COUNT)
+        return 0;
+    return size == 0 ? 1 : (uint32_t)((size + SIZE_CLASS_STEP - 1) / SIZE_CLASS_STEP);
+}
+
+static void *pooled_malloc(size_t size) {
+    uint32_t size_class = size_class_for(size);
+    if (size_class == 0)
+        return tracking_malloc(size);
+
+    BlockHeader *header;
+    uint32_t index = size_class - 1;
+    ThreadCache *cache = get_thread_cache();
+    if (cache != NULL && cache->blocks[index] != NULL) {
+        header = (BlockHeader *)cache->blocks[index];
+        cache->blocks[index] = cache->blocks[index]->next;
+        cache->counts[index] -= 1;
+    } else {
+        size_t block_size = HEADER_SIZE + (size_t)size_class * SIZE_CLASS_STEP;
+        header = check_alloc(malloc(block_size), block_size);
+    }
+    header->size = size;
+    header->size_class = size_class;
+    track_alloc(size);
+    return DATA(header);
+}
+
+static void *pooled_calloc(size_t count, size_t size) {
+    if (size != 0 && count > (SIZE_MAX - HEADER_SIZE) / size)
+        return check_alloc(NULL, SIZE_MAX);
+    if (size_class_for(count * size) == 0)
+        return tracking_calloc(count, size);
+
+    void *ptr = pooled_malloc(count * size);
+    memset(ptr, 0, count * size);
+    return ptr;
+}
+
+static void pooled_free(void *ptr) {
+    if (ptr == NULL)
+        return;
+
+    BlockHeader *header = HEADER(ptr);
+    if (header->size_class == 0) {
+        tracking_free(ptr);
+        return;
+    }
+
+    track_free(header->size);
+    uint32_t index = header->size_class - 1;
+    ThreadCache *cache = get_thread_cache();
+    if (cache != NULL && cache->counts[index] < MAX_CACHED_BLOCKS) {
+        FreeBlock *block = (FreeBlock *)header;
+        block->next = cache->blocks[index];
+        cache->blocks[index] = block;
+        cache->counts[index] += 1;
+    } else {
+        free(header);
+    }
+}
+
+static void *pooled_realloc(void *ptr, size_t size) {
+    if (ptr == NULL)
+        return pooled_malloc(size);
+
+    BlockHeader *header = HEADER(ptr);
+    if (header->size_class == 0 && size_class_for(size) == 0)
+        return tracking_realloc(ptr, size);
+    if (header->size_class != 0 && size <= (size_t)header->size_class * SIZE_CLASS_STEP) {
+        track_resize(header->size, size);
+        header->size = size;
+        return ptr;
+    }
+
+    void *new_ptr = pooled_malloc(size);
+    memcpy(new_ptr, ptr, header->size < size ? header->size : size);
+    pooled_free(ptr);
+    return new_ptr;
+}
+
+bool kts_allocator_install(uint32_t kind) {
+    // Claim the installation, so that concurrent calls cannot install different allocators.
+    while (!swap_kind_if(KTS_ALLOCATOR_SYSTEM, KIND_INSTALLING)) {
+        uint32_t current = get_kind();
+        if (current != KIND_INSTALLING && current != KTS_ALLOCATOR_SYSTEM)
+            return current == kind;
+    }
+
+    // The blocks of the system allocator have no header, so
+    // they must not be freed by any other allocator.
+    if (kind != KTS_ALLOCATOR_SYSTEM && has_live_objects()) {
+        set_kind(KTS_ALLOCATOR_SYSTEM);
+        return false;
+    }
+
+    switch (kind) {
+        case KTS_ALLOCATOR_SYSTEM:
+            ts_set_allocator(malloc, calloc, realloc, free);
+            break;
+        case KTS_ALLOCATOR_TRACKING:
+            ts_set_allocator(tracking_malloc, tracking_calloc, tracking_realloc, tracking_free);
+            break;
+        case KTS_ALLOCATOR_POOLED:
+#ifdef _WIN32
+            thread_cache_key = FlsAlloc(thread_cache_release);
+            if (thread_cache_key == FLS_OUT_OF_INDEXES) {
+                set_kind(KTS_ALLOCATOR_SYSTEM);
+                return false;
+            }
+#else
+            if (pthread_key_create(&thread_cache_key, thread_cache_destroy) != 0) {
+                set_kind(KTS_ALLOCATOR_SYSTEM);
+                return false;
+            }
+#endif
+            ts_set_allocator(pooled_malloc, pooled_calloc, pooled_realloc, pooled_free);
+            break;
+        default:
+            set_kind(KTS_ALLOCATOR_SYSTEM);
+            return false;
+    }
+    set_kind(kind);
+    return true;
+}
+
+uint32_t kts_allocator_kind(void) {
+    uint32_t kind = get_kind();
+    return kind == KIND_INSTALLING ? KTS_ALLOCATOR_SYSTEM : kind;
+}
+
+void kts_allocator_stats(KtsAllocatorStats *stats) {
+    stats->allocated_bytes = atomic_get(&global_stats.allocated_bytes);
+    stats->peak_allocated_bytes = atomic_get(&global_stats.peak_allocated_bytes);
+    stats->allocation_count = atomic_get(&global_stats.allocation_count);
+}
+
+KtsMemoryBudget *kts_allocator_swap_budget(KtsMemoryBudget *budget) {
+    KtsMemoryBudget *previous = thread_budget;
+    thread_budget = budget;
+    return previous;
+}
+
+bool kts_allocator_budget_exceeded(void) {
+    KtsMemoryBudget *budget = thread_budget;
+    return budget != NULL && budget->exceeded;
+}
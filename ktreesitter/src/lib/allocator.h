@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Use the system allocator without any bookkeeping. */
+#define KTS_ALLOCATOR_SYSTEM 0
+/** Wrap the system allocator to keep track of the allocated bytes. */
+#define KTS_ALLOCATOR_TRACKING 1
+/** Serve small blocks from size-class pools with per-thread caches. */
+#define KTS_ALLOCATOR_POOLED 2
+
+typedef struct {
+    uint64_t allocated_bytes;
+    uint64_t peak_allocated_bytes;
+    uint64_t allocation_count;
+} KtsAllocatorStats;
+
+typedef struct {
+    uint64_t limit;
+    int64_t used;
+    bool exceeded;
+} KtsMemoryBudget;
+
+/**
+ * Install the allocator of the given kind as the tree-sitter allocator.
+ *
+ * This must be called before tree-sitter allocates any memory. It returns `false`
+ * if another allocator was already installed, or if a parser, tree or query that
+ * was allocated by the system allocator is still alive. Concurrent calls are safe.
+ */
+bool kts_allocator_install(uint32_t kind);
+
+/** Get the kind of the installed allocator. */
+uint32_t kts_allocator_kind(void);
+
+/** Get the statistics of the installed allocator. */
+void kts_allocator_stats(KtsAllocatorStats *stats);
+
+/**
+ * Charge the allocations of the current thread to the given budget.
+ *
+ * Pass `NULL` to stop charging. The previous budget is returned so that
+ * it can be restored afterwards. Allocations never fail because of the
+ * budget; it is only marked as exceeded, which should be checked with
+ * kts_allocator_budget_exceeded from a progress callback.
+ */
+KtsMemoryBudget *kts_allocator_swap_budget(KtsMemoryBudget *budget);
+
+/** Check if the budget of the current thread has been exceeded. */
+bool kts_allocator_budget_exceeded(void);
@@ -0,0 +1,248 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "diff.h"
+
+/** The maximum number of line insertions and deletions that the line diff explores. */
+#define MAX_DISTANCE (KTS_DIFF_MAX_EDITS * 2)
+
+/** The maximum number of lines in between the common prefix and suffix. */
+#define MAX_LINES (1U << 18)
+
+// The scratch memory in this file uses the system allocator directly,
+// since it never outlives a call and should not count towards any object.
+
+typedef struct {
+    uint32_t start;
+    uint32_t length;
+    uint32_t hash;
+} Line;
+
+typedef struct {
+    const char *text;
+    Line *lines;
+    uint32_t count;
+} Lines;
+
+typedef struct {
+    uint32_t old_start, old_end;
+    uint32_t new_start, new_end;
+} Hunk;
+
+static inline TSPoint advance(const char *text, uint32_t from, uint32_t to, TSPoint point) {
+    const char *ptr = text + from, *end = text + to;
+    while (ptr < end) {
+        const char *newline = memchr(ptr, '\n', (size_t)(end - ptr));
+        if (newline == NULL) {
+            point.column += (uint32_t)(end - ptr);
+            break;
+        }
+        point.row += 1;
+        point.column = 0;
+        ptr = newline + 1;
+    }
+    return point;
+}
+
+static bool split_lines(const char *text, uint32_t start, uint32_t end, Lines *result) {
+    uint32_t capacity = 16;
+    result->text = text;
+    result->count = 0;
+    result->lines = malloc(capacity * sizeof(Line));
+    if (result->lines == NULL)
+        return false;
+
+    while (start < end) {
+        if (result->count == MAX_LINES)
+            return false;
+        if (result->count == capacity) {
+            capacity *= 2;
+            Line *lines = realloc(result->lines, capacity * sizeof(Line));
+            if (lines == NULL)
+                return false;
+            result->lines = lines;
+        }
+        const char *newline = memchr(text + start, '\n', end - start);
+        uint32_t line_end = newline ? (uint32_t)(newline - text) + 1 : end;
+        uint32_t hash = 2166136261U;
+        for (uint32_t i = start; i < line_end; ++i)
+            hash = (hash ^ (uint8_t)text[i]) * 16777619U;
+        result->lines[result->count++] = (Line){start, line_end - start, hash};
+        start = line_end;
+    }
+    return true;
+}
+
+static inline bool lines_equal(const Lines *a, uint32_t i, const Lines *b, uint32_t j) {
+    const Line *x = &a->lines[i], *y = &b->lines[j];
+    return x->hash == y->hash && x->length == y->length &&
+           memcmp(a->text + x->start, b->text + y->start, x->length) == 0;
+}
+
+/**
+ * Mark the deleted and inserted lines with the greedy Myers algorithm.
+ *
+ * @return `false` if the lines differ by more than MAX_DISTANCE.
+ */
+static bool diff_lines(const Lines *old_lines, const Lines *new_lines, bool *deleted,
+                       bool *inserted) {
+    int32_t n = (int32_t)old_lines->count, m = (int32_t)new_lines->count;
+    int32_t width = 2 * MAX_DISTANCE + 1;
+    int32_t *trace = malloc((size_t)(MAX_DISTANCE + 1) * width * sizeof(int32_t));
+    if (trace == NULL)
+        return false;
+
+    int32_t *v = trace, distance = -1;
+    memset(v, 0, width * sizeof(int32_t));
+    for (int32_t d = 0; d <= MAX_DISTANCE && distance < 0; ++d) {
+        v = trace + d * width;
+        if (d > 0)
+            memcpy(v, v - width, width * sizeof(int32_t));
+        for (int32_t k = -d; k <= d; k += 2) {
+            int32_t x;
+            if (d == 0)
+                x = 0;
+            else if (k == -d || (k != d && v[k - 1 + MAX_DISTANCE] < v[k + 1 + MAX_DISTANCE]))
+                x = v[k + 1 + MAX_DISTANCE];
+            else
+                x = v[k - 1 + MAX_DISTANCE] + 1;
+            int32_t y = x - k;
+            while (x < n && y < m && lines_equal(old_lines, x, new_lines, y))
+                x += 1, y += 1;
+            v[k + MAX_DISTANCE] = x;
+            if (x >= n && y >= m) {
+                distance = d;
+                break;
+            }
+        }
+    }
+    if (distance < 0) {
+        free(trace);
+        return false;
+    }
+
+    int32_t x = n, y = m;
+    for (int32_t d = distance; d > 0; --d) {
+        const int32_t *prev = trace + (d - 1) * width;
+        int32_t k = x - y;
+        bool down = k == -d || (k != d && prev[k - 1 + MAX_DISTANCE] < prev[k + 1 + MAX_DISTANCE]);
+        int32_t prev_k = down ? k + 1 : k - 1;
+        int32_t prev_x = prev[prev_k + MAX_DISTANCE], prev_y = prev_x - prev_k;
+        while (x > prev_x && y > prev_y)
+            x -= 1, y -= 1;
+        if (down)
+            inserted[prev_y] = true;
+        else
+            deleted[prev_x] = true;
+        x = prev_x, y = prev_y;
+    }
+    free(trace);
+    return true;
+}
+
+static uint32_t collect_hunks(const Lines *old_lines, const Lines *new_lines, const bool *deleted,
+                              const bool *inserted, uint32_t old_end, uint32_t new_end,
+                              Hunk *hunks) {
+    uint32_t i = 0, j = 0, count = 0;
+    uint32_t n = old_lines->count, m = new_lines->count;
+    while (i < n || j < m) {
+        if (i < n && j < m && !deleted[i] && !inserted[j]) {
+            i += 1, j += 1;
+            continue;
+        }
+        if (count == KTS_DIFF_MAX_EDITS)
+            return UINT32_MAX;
+        Hunk *hunk = &hunks[count++];
+        hunk->old_start = i < n ? old_lines->lines[i].start : old_end;
+        hunk->new_start = j < m ? new_lines->lines[j].start : new_end;
+        while ((i < n && deleted[i]) || (j < m && inserted[j])) {
+            if (i < n && deleted[i])
+                i += 1;
+            if (j < m && inserted[j])
+                j += 1;
+        }
+        hunk->old_end = i < n ? old_lines->lines[i].start : old_end;
+        hunk->new_end = j < m ? new_lines->lines[j].start : new_end;
+    }
+    return count;
+}
+
+static inline void trim_hunk(const char *old_text, const char *new_text, Hunk *hunk) {
+    while (hunk->old_start < hunk->old_end && hunk->new_start < hunk->new_end &&
+           old_text[hunk->old_start] == new_text[hunk->new_start])
+        hunk->old_start += 1, hunk->new_start += 1;
+    while (hunk->old_end > hunk->old_start && hunk->new_end > hunk->new_start &&
+           old_text[hunk->old_end - 1] == new_text[hunk->new_end - 1])
+        hunk->old_end -= 1, hunk->new_end -= 1;
+}
+
+/** Find the hunks between the common prefix and suffix, or return UINT32_MAX. */
+static uint32_t diff_middle(const char *old_text, uint32_t old_start, uint32_t old_end,
+                            const char *new_text, uint32_t new_start, uint32_t new_end,
+                            Hunk *hunks) {
+    uint32_t count = UINT32_MAX;
+    Lines old_lines = {0}, new_lines = {0};
+    bool *deleted = NULL, *inserted = NULL;
+    if (!split_lines(old_text, old_start, old_end, &old_lines) ||
+        !split_lines(new_text, new_start, new_end, &new_lines))
+        goto exit;
+
+    deleted = calloc(old_lines.count + 1, sizeof(bool));
+    inserted = calloc(new_lines.count + 1, sizeof(bool));
+    if (deleted == NULL || inserted == NULL)
+        goto exit;
+    if (!diff_lines(&old_lines, &new_lines, deleted, inserted))
+        goto exit;
+    count = collect_hunks(&old_lines, &new_lines, deleted, inserted, old_end, new_end, hunks);
+
+exit:
+    free(old_lines.lines);
+    free(new_lines.lines);
+    free(deleted);
+    free(inserted);
+    return count;
+}
+
+uint32_t kts_diff(const char *old_text, uint32_t old_length, const char *new_text,
+                  uint32_t new_length, TSInputEdit *edits) {
+    uint32_t min_length = old_length < new_length ? old_length : new_length;
+    uint32_t prefix = 0, suffix = 0;
+    while (prefix < min_length && old_text[prefix] == new_text[prefix])
+        prefix += 1;
+    if (prefix == old_length && prefix == new_length)
+        return 0;
+    while (suffix < min_length - prefix &&
+           old_text[old_length - suffix - 1] == new_text[new_length - suffix - 1])
+        suffix += 1;
+
+    // Start the line diff at the beginning of the first changed line.
+    uint32_t line_start = prefix;
+    while (line_start > 0 && old_text[line_start - 1] != '\n')
+        line_start -= 1;
+
+    Hunk hunks[KTS_DIFF_MAX_EDITS];
+    uint32_t count = diff_middle(old_text, line_start, old_length - suffix, new_text, line_start,
+                                 new_length - suffix, hunks);
+    if (count == UINT32_MAX) {
+        count = 1;
+        hunks[0] = (Hunk){prefix, old_length - suffix, prefix, new_length - suffix};
+    }
+
+    uint32_t offset = 0;
+    TSPoint point = {0, 0};
+    for (uint32_t i = 0; i < count; ++i) {
+        Hunk *hunk = &hunks[i];
+        trim_hunk(old_text, new_text, hunk);
+        TSInputEdit *edit = &edits[count - i - 1];
+        point = advance(old_text, offset, hunk->old_start, point);
+        edit->start_byte = hunk->old_start;
+        edit->start_point = point;
+        edit->old_end_byte = hunk->old_end;
+        edit->old_end_point = advance(old_text, hunk->old_start, hunk->old_end, point);
+        edit->new_end_byte = hunk->old_start + (hunk->new_end - hunk->new_start);
+        edit->new_end_point = advance(new_text, hunk->new_start, hunk->new_end, point);
+        offset = hunk->old_start;
+    }
+    return count;
+}
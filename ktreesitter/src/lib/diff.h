@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+/** The maximum number of edits that kts_diff can produce. */
+#define KTS_DIFF_MAX_EDITS 64
+
+/**
+ * Compute the edits that turn the old text into the new text.
+ *
+ * The texts are compared with a common prefix and suffix scan, and the
+ * lines in between are compared with a diff that is bounded by the size
+ * of the `edits` buffer, which must hold KTS_DIFF_MAX_EDITS elements.
+ * If the lines differ too much, a single edit spanning them is produced.
+ *
+ * The edits are ordered from the end of the text to its start, so
+ * that they can be applied one after the other with ts_tree_edit.
+ *
+ * @return The number of edits, which is `0` if the texts are equal.
+ */
+uint32_t kts_diff(const char *old_text, uint32_t old_length, const char *new_text,
+                  uint32_t new_length, TSInputEdit *edits);
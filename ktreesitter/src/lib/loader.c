@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#include "loader.h"
+
+typedef const TSLanguage *(*LanguageFunction)(void);
+
+#ifdef _WIN32
+
+static void format_error(char *error, const char *message, const char *name) {
+    char reason[256] = {0};
+    DWORD code = GetLastError();
+    FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, NULL, code, 0,
+                   reason, sizeof reason, NULL);
+    snprintf(error, KTS_LOADER_ERROR_SIZE, "%s %s: %s", message, name, reason);
+}
+
+const TSLanguage *kts_language_load(const char *path, const char *symbol, char *error) {
+    int length = MultiByteToWideChar(CP_UTF8, 0, path, -1, NULL, 0);
+    if (length == 0) {
+        format_error(error, "Invalid library path", path);
+        return NULL;
+    }
+    wchar_t *wide_path = (wchar_t *)malloc(sizeof(wchar_t) * (size_t)length);
+    if (wide_path == NULL) {
+        snprintf(error, KTS_LOADER_ERROR_SIZE, "Failed to allocate the path %s", path);
+        return NULL;
+    }
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, wide_path, length);
+    HMODULE library = LoadLibraryW(wide_path);
+    free(wide_path);
+    if (library == NULL) {
+        format_error(error, "Failed to load the library", path);
+        return NULL;
+    }
+    LanguageFunction function = (LanguageFunction)GetProcAddress(library, symbol);
+    if (function == NULL) {
+        format_error(error, "Failed to find the symbol", symbol);
+        FreeLibrary(library);
+        return NULL;
+    }
+    return function();
+}
+
+#else
+
+const TSLanguage *kts_language_load(const char *path, const char *symbol, char *error) {
+    void *library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (library == NULL) {
+        snprintf(error, KTS_LOADER_ERROR_SIZE, "Failed to load the library: %s", dlerror());
+        return NULL;
+    }
+    // Clear any previous error, so that a failed lookup reports its own.
+    dlerror();
+    LanguageFunction function = (LanguageFunction)dlsym(library, symbol);
+    const char *reason = dlerror();
+    if (function == NULL) {
+        snprintf(error, KTS_LOADER_ERROR_SIZE, "Failed to find the symbol %s: %s", symbol,
+                 reason ? reason : "the symbol is NULL");
+        dlclose(library);
+        return NULL;
+    }
+    return function();
+}
+
+#endif
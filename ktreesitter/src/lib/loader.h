@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <tree_sitter/api.h>
+
+/** The size of the buffer that receives the error message of kts_language_load. */
+#define KTS_LOADER_ERROR_SIZE 512
+
+/**
+ * Load a language from the shared library at the given path, by calling the
+ * function with the given symbol name, which is usually `tree_sitter_<name>`.
+ *
+ * The library is never unloaded, since the language data lives in it and
+ * languages may be referenced for as long as the process runs. Loading the
+ * same library again only increments its reference count.
+ *
+ * @return The language, or `NULL` if the library or the symbol could not be
+ *  loaded, in which case an error message is written to the `error` buffer,
+ *  which must hold KTS_LOADER_ERROR_SIZE bytes.
+ */
+const TSLanguage *kts_language_load(const char *path, const char *symbol, char *error);
@@ -0,0 +1,142 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "log_buffer.h"
+
+// The buffer uses the system allocator directly, since it is owned
+// by the bindings rather than by a parser, tree or query.
+
+struct KtsLogBuffer {
+    char *data;
+    uint32_t capacity;
+    uint32_t start;
+    uint32_t size;
+    uint32_t count;
+    uint64_t dropped;
+    bool lex;
+    bool parse;
+};
+
+/** Copy bytes into the ring, starting at the given offset from the start. */
+static void ring_write(KtsLogBuffer *self, uint32_t offset, const void *bytes, uint32_t length) {
+    uint32_t position = (self->start + offset) % self->capacity;
+    uint32_t first = self->capacity - position;
+    if (first > length)
+        first = length;
+    memcpy(self->data + position, bytes, first);
+    memcpy(self->data, (const char *)bytes + first, length - first);
+}
+
+/** Copy bytes out of the ring, starting at the given offset from the start. */
+static void ring_read(const KtsLogBuffer *self, uint32_t offset, void *bytes, uint32_t length) {
+    uint32_t position = (self->start + offset) % self->capacity;
+    uint32_t first = self->capacity - position;
+    if (first > length)
+        first = length;
+    memcpy(bytes, self->data + position, first);
+    memcpy((char *)bytes + first, self->data, length - first);
+}
+
+static void read_header(const KtsLogBuffer *self, TSLogType *type, uint32_t *length) {
+    unsigned char header[KTS_LOG_HEADER_SIZE];
+    ring_read(self, 0, header, KTS_LOG_HEADER_SIZE);
+    *type = (TSLogType)header[0];
+    *length = (uint32_t)header[1] | (uint32_t)header[2] << 8 | (uint32_t)header[3] << 16 |
+              (uint32_t)header[4] << 24;
+}
+
+static void drop_oldest(KtsLogBuffer *self) {
+    TSLogType type;
+    uint32_t length;
+    read_header(self, &type, &length);
+    uint32_t entry_size = KTS_LOG_HEADER_SIZE + length;
+    self->start = (self->start + entry_size) % self->capacity;
+    self->size -= entry_size;
+    self->count -= 1;
+}
+
+static void log_message(void *payload, TSLogType type, const char *message) {
+    KtsLogBuffer *self = (KtsLogBuffer *)payload;
+    if (type == TSLogTypeLex ? !self->lex : !self->parse)
+        return;
+
+    // Messages that do not fit in the buffer are truncated
+    // at the start of the UTF-8 sequence that does not fit.
+    uint32_t length = (uint32_t)strlen(message);
+    if (length > self->capacity - KTS_LOG_HEADER_SIZE) {
+        length = self->capacity - KTS_LOG_HEADER_SIZE;
+        while (length > 0 && ((unsigned char)message[length] & 0xC0) == 0x80)
+            length -= 1;
+    }
+    uint32_t entry_size = KTS_LOG_HEADER_SIZE + length;
+    while (self->capacity - self->size < entry_size) {
+        drop_oldest(self);
+        self->dropped += 1;
+    }
+
+    unsigned char header[KTS_LOG_HEADER_SIZE] = {
+        (unsigned char)type,
+        (unsigned char)length,
+        (unsigned char)(length >> 8),
+        (unsigned char)(length >> 16),
+        (unsigned char)(length >> 24),
+    };
+    ring_write(self, self->size, header, KTS_LOG_HEADER_SIZE);
+    ring_write(self, self->size + KTS_LOG_HEADER_SIZE, message, length);
+    self->size += entry_size;
+    self->count += 1;
+}
+
+KtsLogBuffer *kts_log_buffer_new(uint32_t capacity, bool lex, bool parse) {
+    if (capacity <= KTS_LOG_HEADER_SIZE)
+        return NULL;
+    KtsLogBuffer *self = (KtsLogBuffer *)calloc(1, sizeof(KtsLogBuffer));
+    if (self == NULL)
+        return NULL;
+    self->data = (char *)malloc(capacity);
+    if (self->data == NULL) {
+        free(self);
+        return NULL;
+    }
+    self->capacity = capacity;
+    self->lex = lex;
+    self->parse = parse;
+    return self;
+}
+
+void kts_log_buffer_delete(KtsLogBuffer *self) {
+    free(self->data);
+    free(self);
+}
+
+TSLogger kts_log_buffer_logger(KtsLogBuffer *self) {
+    return (TSLogger){.payload = (void *)self, .log = log_message};
+}
+
+bool kts_log_buffer_is_logger(TSLogger logger) {
+    return logger.log == log_message;
+}
+
+uint32_t kts_log_buffer_count(const KtsLogBuffer *self) {
+    return self->count;
+}
+
+uint64_t kts_log_buffer_dropped(const KtsLogBuffer *self) {
+    return self->dropped;
+}
+
+bool kts_log_buffer_shift(KtsLogBuffer *self, TSLogType *type, char *message, uint32_t *length) {
+    if (self->count == 0)
+        return false;
+    read_header(self, type, length);
+    ring_read(self, KTS_LOG_HEADER_SIZE, message, *length);
+    drop_oldest(self);
+    return true;
+}
+
+void kts_log_buffer_clear(KtsLogBuffer *self) {
+    self->start = 0;
+    self->size = 0;
+    self->count = 0;
+    self->dropped = 0;
+}
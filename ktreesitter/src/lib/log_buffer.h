@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+/** The number of bytes that are stored in front of every message. */
+#define KTS_LOG_HEADER_SIZE 5
+
+/**
+ * A ring buffer of parser log messages with a fixed capacity in bytes.
+ *
+ * Every message is stored as a header with its type and length, followed
+ * by its bytes. When the buffer is full, the oldest messages are dropped.
+ * The buffer is not thread safe, so it must not be drained during a parse.
+ */
+typedef struct KtsLogBuffer KtsLogBuffer;
+
+/**
+ * Create a log buffer with the given capacity, which records the given types of messages.
+ *
+ * @return The buffer, or `NULL` if the capacity is too small or the allocation failed.
+ */
+KtsLogBuffer *kts_log_buffer_new(uint32_t capacity, bool lex, bool parse);
+
+/** Delete a log buffer that is no longer used by any parser. */
+void kts_log_buffer_delete(KtsLogBuffer *self);
+
+/** Get a parser logger that records messages in the buffer. */
+TSLogger kts_log_buffer_logger(KtsLogBuffer *self);
+
+/** Check if the given parser logger records messages in a log buffer. */
+bool kts_log_buffer_is_logger(TSLogger logger);
+
+/** Get the number of messages in the buffer. */
+uint32_t kts_log_buffer_count(const KtsLogBuffer *self);
+
+/** Get the number of messages that have been dropped since the last call to clear. */
+uint64_t kts_log_buffer_dropped(const KtsLogBuffer *self);
+
+/**
+ * Remove the oldest message from the buffer and copy it into `message`,
+ * which must be able to hold as many bytes as the capacity of the buffer.
+ *
+ * @return `false` if the buffer is empty.
+ */
+bool kts_log_buffer_shift(KtsLogBuffer *self, TSLogType *type, char *message, uint32_t *length);
+
+/** Remove all the messages from the buffer and reset its dropped count. */
+void kts_log_buffer_clear(KtsLogBuffer *self);
@@ -0,0 +1,25 @@
+#include "symbols.h"
+
+uint32_t kts_symbol_histogram(TSNode node, uint32_t *counts, uint32_t count) {
+    if (ts_node_is_null(node))
+        return 0;
+
+    // The cursor only visits the visible nodes, which are the ones that queries can match.
+    TSTreeCursor cursor = ts_tree_cursor_new(node);
+    uint32_t visited = 0;
+    for (;;) {
+        TSSymbol symbol = ts_node_symbol(ts_tree_cursor_current_node(&cursor));
+        if (symbol < count)
+            counts[symbol] += 1;
+        visited += 1;
+
+        if (ts_tree_cursor_goto_first_child(&cursor))
+            continue;
+        while (!ts_tree_cursor_goto_next_sibling(&cursor)) {
+            if (!ts_tree_cursor_goto_parent(&cursor)) {
+                ts_tree_cursor_delete(&cursor);
+                return visited;
+            }
+        }
+    }
+}
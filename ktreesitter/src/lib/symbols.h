@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+/**
+ * Count the nodes of each symbol in the subtree of the given node.
+ *
+ * The `counts` buffer must hold `count` elements, which is normally the
+ * symbol count of the language, and is incremented rather than cleared.
+ * Nodes whose symbol does not fit in the buffer, such as errors, are skipped.
+ *
+ * @return The total number of nodes that were visited.
+ */
+uint32_t kts_symbol_histogram(TSNode node, uint32_t *counts, uint32_t count);
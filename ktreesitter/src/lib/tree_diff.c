@@ -0,0 +1,401 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "tree_diff.h"
+
+/** The number of old children that are searched for a child with the same symbol. */
+#define MATCH_WINDOW 64
+
+#define NONE UINT32_MAX
+
+// The scratch memory in this file uses the system allocator directly,
+// since it never outlives a call and should not count towards any object.
+
+typedef struct {
+    void *contents;
+    uint32_t size;
+    uint32_t capacity;
+} Array;
+
+typedef struct {
+    TSNode node;
+    /** The index of the paired child in the other list, or NONE. */
+    uint32_t pair;
+    /** Whether the child is the same subtree as its pair. */
+    bool reused;
+    /** Whether the child is part of the longest run that kept its order. */
+    bool ordered;
+} Child;
+
+typedef struct {
+    TSNode old_node;
+    TSNode new_node;
+} NodePair;
+
+typedef struct {
+    uintptr_t id;
+    uint32_t index;
+} IdEntry;
+
+typedef struct {
+    TSNode node;
+    bool moved;
+} Removed;
+
+typedef struct {
+    TSTreeCursor cursor;
+    Array edits;
+    Array stack;
+    Array old_children;
+    Array new_children;
+    Array old_tokens;
+    Array new_tokens;
+    Array ids;
+    Array tails;
+    Array previous;
+    Array deleted;
+    Array inserted;
+    Array removed;
+    uint32_t *table;
+    uint32_t table_mask;
+} Context;
+
+#define AT(array, type, index) (((type *)(array)->contents)[index])
+
+static bool reserve(Array *self, uint32_t additional, size_t element_size) {
+    if (self->size + additional <= self->capacity)
+        return true;
+    uint32_t capacity = self->capacity ? self->capacity : 16;
+    while (capacity < self->size + additional)
+        capacity *= 2;
+    void *contents = realloc(self->contents, capacity * element_size);
+    if (contents == NULL)
+        return false;
+    self->contents = contents;
+    self->capacity = capacity;
+    return true;
+}
+
+#define PUSH(array, type, value)                                                                   \
+    (reserve((array), 1, sizeof(type)) && (AT(array, type, (array)->size++) = (value), true))
+
+static inline uintptr_t node_id(TSNode node) {
+    return (uintptr_t)node.id;
+}
+
+static bool emit(Context *self, int32_t kind, TSNode old_node, TSNode new_node) {
+    if (!reserve(&self->edits, KTS_TREE_DIFF_EDIT_SIZE, sizeof(int32_t)))
+        return false;
+    bool has_old = !ts_node_is_null(old_node), has_new = !ts_node_is_null(new_node);
+    int32_t *edit = &AT(&self->edits, int32_t, self->edits.size);
+    edit[0] = kind;
+    edit[1] = (int32_t)ts_node_symbol(has_new ? new_node : old_node);
+    edit[2] = has_old ? (int32_t)ts_node_start_byte(old_node) : -1;
+    edit[3] = has_old ? (int32_t)ts_node_end_byte(old_node) : -1;
+    edit[4] = has_new ? (int32_t)ts_node_start_byte(new_node) : -1;
+    edit[5] = has_new ? (int32_t)ts_node_end_byte(new_node) : -1;
+    edit[6] = has_old ? (int32_t)ts_node_start_point(old_node).row : -1;
+    edit[7] = has_new ? (int32_t)ts_node_start_point(new_node).row : -1;
+    self->edits.size += KTS_TREE_DIFF_EDIT_SIZE;
+    return true;
+}
+
+/** Collect the named children of the node, and the symbols of its anonymous children. */
+static bool collect_children(TSTreeCursor *cursor, TSNode node, Array *children, Array *tokens) {
+    children->size = 0;
+    tokens->size = 0;
+    ts_tree_cursor_reset(cursor, node);
+    if (!ts_tree_cursor_goto_first_child(cursor))
+        return true;
+    do {
+        TSNode child = ts_tree_cursor_current_node(cursor);
+        if (ts_node_is_named(child)) {
+            Child entry = {child, NONE, false, false};
+            if (!PUSH(children, Child, entry))
+                return false;
+        } else if (!PUSH(tokens, TSSymbol, ts_node_symbol(child))) {
+            return false;
+        }
+    } while (ts_tree_cursor_goto_next_sibling(cursor));
+    return true;
+}
+
+static int compare_ids(const void *a, const void *b) {
+    uintptr_t id_a = ((const IdEntry *)a)->id, id_b = ((const IdEntry *)b)->id;
+    return (id_a > id_b) - (id_a < id_b);
+}
+
+/** Pair the children that are the same subtree in both trees. */
+static bool pair_reused(Context *self, Child *old_children, uint32_t old_count,
+                        Child *new_children, uint32_t new_count) {
+    self->ids.size = 0;
+    if (!reserve(&self->ids, old_count, sizeof(IdEntry)))
+        return false;
+    for (uint32_t i = 0; i < old_count; ++i) {
+        IdEntry entry = {node_id(old_children[i].node), i};
+        AT(&self->ids, IdEntry, self->ids.size++) = entry;
+    }
+    qsort(self->ids.contents, old_count, sizeof(IdEntry), compare_ids);
+
+    for (uint32_t j = 0; j < new_count; ++j) {
+        IdEntry key = {node_id(new_children[j].node), 0};
+        IdEntry *found = bsearch(&key, self->ids.contents, old_count, sizeof(IdEntry), compare_ids);
+        if (found == NULL || old_children[found->index].pair != NONE)
+            continue;
+        old_children[found->index].pair = j;
+        new_children[j].pair = found->index;
+        old_children[found->index].reused = new_children[j].reused = true;
+    }
+    return true;
+}
+
+/** Pair the remaining children that have the same symbol, in order. */
+static void pair_by_symbol(Child *old_children, uint32_t old_count, Child *new_children,
+                           uint32_t new_count) {
+    uint32_t next = 0;
+    for (uint32_t j = 0; j < new_count; ++j) {
+        if (new_children[j].pair != NONE)
+            continue;
+        TSSymbol symbol = ts_node_symbol(new_children[j].node);
+        for (uint32_t i = next; i < old_count && i < next + MATCH_WINDOW; ++i) {
+            if (old_children[i].pair == NONE && ts_node_symbol(old_children[i].node) == symbol) {
+                old_children[i].pair = j;
+                new_children[j].pair = i;
+                next = i + 1;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Mark the paired children that are part of the longest increasing
+ * subsequence of old positions, so that the others are moved.
+ */
+static bool mark_ordered(Context *self, Child *new_children, uint32_t new_count) {
+    self->tails.size = 0;
+    self->previous.size = 0;
+    if (!reserve(&self->tails, new_count, sizeof(uint32_t)) ||
+        !reserve(&self->previous, new_count, sizeof(uint32_t)))
+        return false;
+    uint32_t *tails = self->tails.contents, *previous = self->previous.contents;
+    uint32_t length = 0;
+    for (uint32_t j = 0; j < new_count; ++j) {
+        previous[j] = NONE;
+        uint32_t position = new_children[j].pair;
+        if (position == NONE)
+            continue;
+        uint32_t low = 0, high = length;
+        while (low < high) {
+            uint32_t mid = (low + high) / 2;
+            if (new_children[tails[mid]].pair < position)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        previous[j] = low > 0 ? tails[low - 1] : NONE;
+        tails[low] = j;
+        if (low == length)
+            length += 1;
+    }
+    for (uint32_t j = length ? tails[length - 1] : NONE; j != NONE; j = previous[j])
+        new_children[j].ordered = true;
+    return true;
+}
+
+/** Compare the children of two paired nodes, and queue their paired children. */
+static bool diff_children(Context *self, TSNode old_node, TSNode new_node) {
+    if (!collect_children(&self->cursor, old_node, &self->old_children, &self->old_tokens) ||
+        !collect_children(&self->cursor, new_node, &self->new_children, &self->new_tokens))
+        return false;
+    Child *old_children = self->old_children.contents, *new_children = self->new_children.contents;
+    uint32_t old_count = self->old_children.size, new_count = self->new_children.size;
+
+    bool updated = self->old_tokens.size != self->new_tokens.size ||
+                   (self->old_tokens.size > 0 &&
+                    memcmp(self->old_tokens.contents, self->new_tokens.contents,
+                           self->old_tokens.size * sizeof(TSSymbol)) != 0);
+    if (!updated && old_count == 0 && new_count == 0) {
+        // Without the text, an edited leaf is assumed to have changed
+        uint32_t old_length = ts_node_end_byte(old_node) - ts_node_start_byte(old_node);
+        uint32_t new_length = ts_node_end_byte(new_node) - ts_node_start_byte(new_node);
+        updated = ts_node_has_changes(old_node) || old_length != new_length;
+    }
+    if (updated && !emit(self, KTS_TREE_DIFF_UPDATED, old_node, new_node))
+        return false;
+
+    if (!pair_reused(self, old_children, old_count, new_children, new_count))
+        return false;
+    pair_by_symbol(old_children, old_count, new_children, new_count);
+    if (!mark_ordered(self, new_children, new_count))
+        return false;
+
+    // The children are queued in reverse, so that they are compared in order
+    if (!reserve(&self->stack, new_count, sizeof(NodePair)))
+        return false;
+    for (uint32_t j = new_count; j-- > 0;) {
+        Child *child = &new_children[j];
+        if (child->pair == NONE)
+            continue;
+        TSNode old_child = old_children[child->pair].node;
+        if (!child->ordered && !emit(self, KTS_TREE_DIFF_MOVED, old_child, child->node))
+            return false;
+        if (!child->reused) {
+            NodePair pair = {old_child, child->node};
+            AT(&self->stack, NodePair, self->stack.size++) = pair;
+        }
+    }
+    for (uint32_t j = 0; j < new_count; ++j) {
+        if (new_children[j].pair == NONE && !PUSH(&self->inserted, TSNode, new_children[j].node))
+            return false;
+    }
+    for (uint32_t i = 0; i < old_count; ++i) {
+        if (old_children[i].pair == NONE && !PUSH(&self->deleted, TSNode, old_children[i].node))
+            return false;
+    }
+    return true;
+}
+
+static inline uint32_t hash_id(uintptr_t id) {
+    uint64_t hash = (uint64_t)id * 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)(hash >> 32);
+}
+
+static uint32_t *table_slot(Context *self, uintptr_t id) {
+    uint32_t slot = hash_id(id) & self->table_mask;
+    while (self->table[slot] != NONE &&
+           node_id(AT(&self->removed, Removed, self->table[slot]).node) != id)
+        slot = (slot + 1) & self->table_mask;
+    return &self->table[slot];
+}
+
+/** Collect the named nodes of the deleted subtrees, and index them by their ids. */
+static bool index_removed(Context *self) {
+    TSNode *deleted = self->deleted.contents;
+    for (uint32_t i = 0; i < self->deleted.size; ++i) {
+        ts_tree_cursor_reset(&self->cursor, deleted[i]);
+        for (;;) {
+            TSNode node = ts_tree_cursor_current_node(&self->cursor);
+            Removed entry = {node, false};
+            if (ts_node_is_named(node) && !PUSH(&self->removed, Removed, entry))
+                return false;
+            if (ts_tree_cursor_goto_first_child(&self->cursor))
+                continue;
+            while (!ts_tree_cursor_goto_next_sibling(&self->cursor)) {
+                if (!ts_tree_cursor_goto_parent(&self->cursor))
+                    goto next;
+            }
+        }
+    next:;
+    }
+
+    uint32_t capacity = 16;
+    while (capacity < self->removed.size * 2)
+        capacity *= 2;
+    self->table = malloc(capacity * sizeof(uint32_t));
+    if (self->table == NULL)
+        return false;
+    memset(self->table, 0xFF, capacity * sizeof(uint32_t));
+    self->table_mask = capacity - 1;
+    for (uint32_t i = 0; i < self->removed.size; ++i)
+        *table_slot(self, node_id(AT(&self->removed, Removed, i).node)) = i;
+    return true;
+}
+
+/**
+ * Report the inserted and deleted subtrees, after finding
+ * the subtrees that were moved from a deleted one.
+ */
+static bool diff_removed(Context *self) {
+    if (self->deleted.size > 0 && self->inserted.size > 0 && !index_removed(self))
+        return false;
+
+    TSNode *inserted = self->inserted.contents;
+    for (uint32_t i = 0; i < self->inserted.size; ++i) {
+        bool moved = false;
+        if (self->table != NULL) {
+            ts_tree_cursor_reset(&self->cursor, inserted[i]);
+            for (;;) {
+                TSNode node = ts_tree_cursor_current_node(&self->cursor);
+                uint32_t index = ts_node_is_named(node) ? *table_slot(self, node_id(node)) : NONE;
+                Removed *removed = index != NONE ? &AT(&self->removed, Removed, index) : NULL;
+                if (removed != NULL && !removed->moved) {
+                    removed->moved = true;
+                    moved = moved || ts_node_eq(node, inserted[i]);
+                    if (!emit(self, KTS_TREE_DIFF_MOVED, removed->node, node))
+                        return false;
+                } else if (ts_tree_cursor_goto_first_child(&self->cursor)) {
+                    continue;
+                }
+                while (!ts_tree_cursor_goto_next_sibling(&self->cursor)) {
+                    if (!ts_tree_cursor_goto_parent(&self->cursor))
+                        goto done;
+                }
+            }
+        }
+    done:
+        if (!moved && !emit(self, KTS_TREE_DIFF_INSERTED, (TSNode){0}, inserted[i]))
+            return false;
+    }
+
+    TSNode *deleted = self->deleted.contents;
+    for (uint32_t i = 0; i < self->deleted.size; ++i) {
+        if (self->table != NULL) {
+            uint32_t index = *table_slot(self, node_id(deleted[i]));
+            if (index != NONE && AT(&self->removed, Removed, index).moved)
+                continue;
+        }
+        if (!emit(self, KTS_TREE_DIFF_DELETED, deleted[i], (TSNode){0}))
+            return false;
+    }
+    return true;
+}
+
+static bool diff_trees(Context *self, TSNode old_root, TSNode new_root) {
+    NodePair root = {old_root, new_root};
+    if (!PUSH(&self->stack, NodePair, root))
+        return false;
+    while (self->stack.size > 0) {
+        NodePair pair = AT(&self->stack, NodePair, --self->stack.size);
+        if (node_id(pair.old_node) == node_id(pair.new_node))
+            continue;
+        if (!diff_children(self, pair.old_node, pair.new_node))
+            return false;
+    }
+    return diff_removed(self);
+}
+
+bool kts_tree_diff(const TSTree *old_tree, const TSTree *new_tree, int32_t **edits,
+                   uint32_t *count) {
+    TSNode old_root = ts_tree_root_node(old_tree), new_root = ts_tree_root_node(new_tree);
+    Context self;
+    memset(&self, 0, sizeof self);
+    self.cursor = ts_tree_cursor_new(new_root);
+
+    bool result = diff_trees(&self, old_root, new_root);
+
+    ts_tree_cursor_delete(&self.cursor);
+    free(self.stack.contents);
+    free(self.old_children.contents);
+    free(self.new_children.contents);
+    free(self.old_tokens.contents);
+    free(self.new_tokens.contents);
+    free(self.ids.contents);
+    free(self.tails.contents);
+    free(self.previous.contents);
+    free(self.deleted.contents);
+    free(self.inserted.contents);
+    free(self.removed.contents);
+    free(self.table);
+    if (!result) {
+        free(self.edits.contents);
+        return false;
+    }
+    *edits = self.edits.contents;
+    *count = self.edits.size / KTS_TREE_DIFF_EDIT_SIZE;
+    return true;
+}
+
+void kts_tree_diff_free(int32_t *edits) {
+    free(edits);
+}
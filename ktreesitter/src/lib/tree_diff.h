@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <tree_sitter/api.h>
+
+/** The number of integers in every edit that kts_tree_diff produces. */
+#define KTS_TREE_DIFF_EDIT_SIZE 8
+
+/** A named node of the new tree that has no counterpart in the old tree. */
+#define KTS_TREE_DIFF_INSERTED 0
+/** A named node of the old tree that has no counterpart in the new tree. */
+#define KTS_TREE_DIFF_DELETED 1
+/** A named node whose own tokens changed, such as a renamed identifier or another operator. */
+#define KTS_TREE_DIFF_UPDATED 2
+/** A named node that was reused under another parent, or in another order among its siblings. */
+#define KTS_TREE_DIFF_MOVED 3
+
+/**
+ * Compute the edit script that turns the named nodes of an old tree into those of a new tree.
+ *
+ * The old tree must have been edited to match the new tree, which must have been
+ * parsed with it, so that the subtrees that were reused have the same ids in both
+ * trees. Those subtrees are matched without being walked, and the remaining children
+ * of two matched nodes are matched by their symbols, in order.
+ *
+ * Inserted and deleted subtrees are only reported by their root, except for the
+ * subtrees inside them that were moved. Every edit is packed into
+ * KTS_TREE_DIFF_EDIT_SIZE integers: the kind, the symbol, the start and end bytes
+ * of the old node, the start and end bytes of the new node, and the start rows
+ * of the old and the new node. The fields of a missing node are `-1`.
+ *
+ * @return `false` if memory could not be allocated. Otherwise, `edits` points
+ *  to the edits, which must be freed with kts_tree_diff_free, and `count`
+ *  contains their number.
+ */
+bool kts_tree_diff(const TSTree *old_tree, const TSTree *new_tree, int32_t **edits,
+                   uint32_t *count);
+
+/** Free the edits that were produced by kts_tree_diff. */
+void kts_tree_diff_free(int32_t *edits);
@@ -166,6 +166,34 @@ import kotlinx.cinterop.*
     @Throws(IllegalArgumentException::class)
     actual fun lookaheadIterator(state: UShort) = LookaheadIterator(this, state)
 
+    /**
+     * Get the symbols that are valid in the given parse state.
+     *
+     * This is equivalent to collecting the [symbols][LookaheadIterator.symbols]
+     * of a [lookaheadIterator], but the array is filled in a single native call.
+     *
+     * @throws [IllegalArgumentException] If the state is invalid for this language.
+     * @see ValidSymbolsCache
+     * @since 0.26.0
+     */
+    @Throws(IllegalArgumentException::class)
+    @OptIn(ExperimentalUnsignedTypes::class)
+    actual fun validSymbols(state: UShort): UShortArray {
+        val lookahead = ts_lookahead_iterator_new(self, state)
+            ?: throw IllegalArgumentException("State $state is not valid for $this")
+        try {
+            var length = 0
+            while (ts_lookahead_iterator_next(lookahead)) length += 1
+            ts_lookahead_iterator_reset_state(lookahead, state)
+            return UShortArray(length) {
+                ts_lookahead_iterator_next(lookahead)
+                ts_lookahead_iterator_current_symbol(lookahead)
+            }
+        } finally {
+            ts_lookahead_iterator_delete(lookahead)
+        }
+    }
+
     /**
      * Create a new [Query] from a string containing one or more S-expression
      * [patterns](https://tree-sitter.github.io/tree-sitter/using-parsers/queries/1-syntax.html).
@@ -202,4 +230,33 @@ import kotlinx.cinterop.*
             append("\")")
         }
     }
+
+    /** The methods that load a language at runtime. */
+    actual companion object {
+        /**
+         * Load a language from the shared library at the given [path].
+         *
+         * The language is returned by the function with the given [symbolName],
+         * which defaults to `tree_sitter_<name>`, where the name is derived from
+         * the file name of the library by removing its `lib` and `tree-sitter-`
+         * prefixes and its extension. For example, `libtree-sitter-c-sharp.so`
+         * defines `tree_sitter_c_sharp`.
+         *
+         * The library is never unloaded, and loading it again returns the same language.
+         *
+         * @throws [IllegalArgumentException]
+         *  If the library or the symbol could not be loaded,
+         *  or if the [version][abiVersion] is incompatible.
+         * @see LanguageRegistry
+         * @since 0.26.0
+         */
+        @Throws(IllegalArgumentException::class)
+        actual fun load(path: String, symbolName: String?): Language = memScoped {
+            val error = allocArray<ByteVar>(KTS_LOADER_ERROR_SIZE)
+            val symbol = symbolName ?: languageSymbolName(path)
+            val language = kts_language_load(path, symbol, error)
+                ?: throw IllegalArgumentException(error.toKString())
+            Language(language)
+        }
+    }
 }
@@ -0,0 +1,80 @@
+package io.github.treesitter.ktreesitter
+
+import io.github.treesitter.ktreesitter.internal.*
+import kotlin.experimental.ExperimentalNativeApi
+import kotlin.native.ref.createCleaner
+import kotlinx.cinterop.*
+
+/**
+ * A buffer that records the log messages of a [parser][Parser.logBuffer] in native memory.
+ *
+ * Unlike a [logger][Parser.logger], which calls into Kotlin for every message,
+ * the buffer copies each message into a ring of [capacity] bytes without leaving
+ * native code, and drops the oldest messages once it is full. The messages
+ * can then be [drained][drain] in bulk, for example only when a parse fails,
+ * so logging can be left enabled at a low cost.
+ *
+ * A buffer must only be used by one parser at a time, and it must not be drained
+ * while that parser is parsing. Messages longer than the capacity are truncated.
+ *
+ * @constructor Create a new buffer that records the messages of the given [types].
+ * @throws [IllegalArgumentException]
+ *  If the capacity is less than `64` bytes or if there are no types.
+ * @since 0.26.0
+ */
+@OptIn(ExperimentalForeignApi::class)
+actual class LogBuffer @Throws(IllegalArgumentException::class) actual constructor(
+    actual val capacity: Int,
+    types: Set<Parser.LogType>
+) {
+    /** The types of messages that are recorded. */
+    actual val types: Set<Parser.LogType> = types.toSet()
+
+    init {
+        require(capacity >= 64) { "The capacity must be at least 64 bytes" }
+        require(types.isNotEmpty()) { "At least one type must be recorded" }
+    }
+
+    internal val self = kts_log_buffer_new(
+        capacity.convert(),
+        Parser.LogType.LEX in types,
+        Parser.LogType.PARSE in types
+    ) ?: throw OutOfMemoryError("Failed to allocate the log buffer")
+
+    @Suppress("unused")
+    @OptIn(ExperimentalNativeApi::class)
+    private val cleaner = createCleaner(self, ::kts_log_buffer_delete)
+
+    /** The number of messages in the buffer. */
+    actual val size: Int
+        get() = kts_log_buffer_count(self).toInt()
+
+    /** The number of messages that were dropped to make room since the buffer was cleared. */
+    actual val droppedCount: Long
+        get() = kts_log_buffer_dropped(self).toLong()
+
+    /**
+     * Remove every message from the buffer, from the oldest to the newest,
+     * and pass it to the given [function].
+     *
+     * @return The number of messages that were drained.
+     */
+    actual fun drain(function: LogFunction): Int = memScoped {
+        val message = ByteArray(capacity)
+        val type = alloc<TSLogType.Var>()
+        val length = alloc<UIntVar>()
+        var count = 0
+        message.usePinned {
+            while (kts_log_buffer_shift(self, type.ptr, it.addressOf(0), length.ptr)) {
+                function(type.value.convert(), message.decodeToString(0, length.value.toInt()))
+                count += 1
+            }
+        }
+        count
+    }
+
+    /** Remove every message from the buffer and reset the [dropped count][droppedCount]. */
+    actual fun clear() = kts_log_buffer_clear(self)
+
+    override fun toString() = "LogBuffer(capacity=$capacity, types=$types)"
+}
@@ -364,6 +364,23 @@ actual class Node internal constructor(
         return result
     }
 
+    /**
+     * Count the nodes of each symbol in the subtree of this node, including itself.
+     *
+     * The result is indexed by the [symbol] of the nodes and has the size of the
+     * [symbol count][Language.symbolCount] of the language. Only the visible nodes,
+     * which are the ones that queries can match, are counted in a single native pass.
+     *
+     * @see QueryPlanner
+     * @since 0.26.0
+     */
+    @OptIn(ExperimentalUnsignedTypes::class)
+    actual fun symbolHistogram(): UIntArray {
+        val counts = UIntArray(tree.language.symbolCount.toInt())
+        kts_symbol_histogram(self, counts.refTo(0), counts.size.convert())
+        return counts
+    }
+
     actual override fun equals(other: Any?) =
         this === other || (other is Node && ts_node_eq(self, other.self))
 
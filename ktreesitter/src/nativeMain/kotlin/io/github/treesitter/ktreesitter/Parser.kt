@@ -16,12 +16,13 @@ actual class Parser actual constructor() {
         this.language = language
     }
 
-    private val self = ts_parser_new()
+    private val self = tracked(KTS_OBJECT_PARSER) { ts_parser_new() }!!
 
     @Suppress("unused")
     @OptIn(ExperimentalNativeApi::class)
     private val cleaner = createCleaner(self) {
         freeLogger(ts_parser_logger(it))
+        kts_memory_untrack(it)
         ts_parser_delete(it)
     }
 
@@ -32,7 +33,7 @@ actual class Parser actual constructor() {
      */
     actual var language: Language? = null
         set(value) {
-            ts_parser_set_language(self, value?.self)
+            chargedTo(self) { ts_parser_set_language(self, value?.self) }
             field = value
         }
 
@@ -54,13 +55,15 @@ actual class Parser actual constructor() {
                 val ranges = arena.allocArray<TSRange>(size) {
                     arena.alloc<TSRange>().from(value[it])
                 }
-                val result = ts_parser_set_included_ranges(self, ranges, size.convert())
+                val result = chargedTo(self) {
+                    ts_parser_set_included_ranges(self, ranges, size.convert())
+                }
                 arena.clear()
                 require(result) {
                     "Included ranges must be in ascending order and must not overlap"
                 }
             } else {
-                ts_parser_set_included_ranges(self, null, 0U)
+                chargedTo(self) { ts_parser_set_included_ranges(self, null, 0U) }
             }
             field = value
         }
@@ -74,19 +77,86 @@ actual class Parser actual constructor() {
         get() = ts_parser_timeout_micros(self)
         set(value) = ts_parser_set_timeout_micros(self, value)
 
+    /**
+     * The maximum number of bytes that a single parse
+     * may allocate, or `0` if there is no limit.
+     *
+     * When the limit is exceeded, parsing is halted and
+     * a [MemoryLimitExceededException] is thrown.
+     *
+     * Default: `0`
+     *
+     * @throws [IllegalStateException]
+     *  If a limit is set while the [allocator][TreeSitter.allocator] does not track memory.
+     * @since 0.26.0
+     */
+    @set:Throws(IllegalStateException::class)
+    actual var memoryLimitBytes: ULong = 0UL
+        set(value) {
+            checkMemoryLimit(value)
+            field = value
+        }
+
+    /**
+     * The number of bytes of native memory that are held by the parser,
+     * not including the syntax trees that it has produced.
+     *
+     * This is always `0` when the [allocator][TreeSitter.allocator] is [NativeAllocator.SYSTEM].
+     *
+     * @since 0.26.0
+     */
+    actual val nativeSizeBytes: ULong
+        get() = kts_memory_size(self)
+
+    /**
+     * A listener that can halt any parse, including the parses of strings.
+     *
+     * Unlike a [ParseProgressCallback], the listener receives unboxed arguments and is
+     * only called once every [progressIntervalBytes] or [progressIntervalMicros], so it
+     * is cheap enough to be kept around for cancellation. When it returns `true`,
+     * parsing is halted and can be resumed like a parse halted by a callback.
+     *
+     * @since 0.26.0
+     */
+    actual var progressListener: ParseProgressListener? = null
+
+    /**
+     * The number of bytes that must be parsed before
+     * the [progressListener] is called again.
+     *
+     * If both this and [progressIntervalMicros] are `0`, the listener is called
+     * every time the parser checks its progress. Otherwise, it is called as soon
+     * as either of the intervals has passed.
+     *
+     * Default: `0`
+     *
+     * @since 0.26.0
+     */
+    actual var progressIntervalBytes: UInt = 0U
+
+    /**
+     * The number of microseconds that must pass before
+     * the [progressListener] is called again.
+     *
+     * Default: `0`
+     *
+     * @see progressIntervalBytes
+     * @since 0.26.0
+     */
+    actual var progressIntervalMicros: ULong = 0UL
+
     /** The logger that the parser will use during parsing. */
     @get:Deprecated("The logger can't be called directly.", level = DeprecationLevel.HIDDEN)
     actual var logger: LogFunction? = null
         set(value) {
-            if (field != null)
-                freeLogger(ts_parser_logger(self))
+            freeLogger(ts_parser_logger(self))
             val logger = cValue<TSLogger> {
                 if (value != null) {
                     payload = StableRef.create(value).asCPointer()
                     log = staticCFunction { payload, type, message ->
                         val callback = payload?.asStableRef<LogFunction>()?.get()
                         if (callback != null && message != null)
-                            callback(LogType.entries[type.ordinal], message.toKString())
+                            callback(type.convert(), message.toKString())
                     }
                 } else {
                     payload = null
@@ -94,9 +164,28 @@ actual class Parser actual constructor() {
                 }
             }
             ts_parser_set_logger(self, logger)
+            currentLogBuffer = null
             field = value
         }
 
+    private var currentLogBuffer: LogBuffer? = null
+
+    /**
+     * The buffer that records the log messages of the parser in native memory.
+     *
+     * A parser has either a [logger] or a log buffer,
+     * so setting one of them replaces the other.
+     *
+     * @since 0.26.0
+     */
+    actual var logBuffer: LogBuffer?
+        get() = currentLogBuffer
+        set(value) {
+            logger = null
+            if (value != null) ts_parser_set_logger(self, kts_log_buffer_logger(value.self))
+            currentLogBuffer = value
+        }
+
     /**
      * Parse a source code string and create a syntax tree.
      *
@@ -108,21 +197,38 @@ actual class Parser actual constructor() {
      *
      * @throws [IllegalStateException]
      *  If the parser does not have a [language] assigned or if parsing was halted.
+     * @throws [MemoryLimitExceededException] If the [memory limit][memoryLimitBytes] is exceeded.
      */
     @Throws(IllegalStateException::class)
     actual fun parse(source: String, encoding: InputEncoding, oldTree: Tree?): Tree {
         val language = checkNotNull(language) {
             "The parser has no language assigned"
         }
-        val tree = ts_parser_parse_string_encoding(
-            self,
-            oldTree?.self,
-            source,
-            source.length.convert(),
-            encoding.value
-        )
+        val length = source.sumOf { it.encodedSize() }
+        val tree = withMemoryScope {
+            withProgress(null) { options ->
+                if (options == null) {
+                    ts_parser_parse_string_encoding(
+                        self,
+                        oldTree?.self,
+                        source,
+                        length.convert(),
+                        encoding.value
+                    )
+                } else {
+                    kts_parser_parse_string_with_options(
+                        self,
+                        oldTree?.self,
+                        source,
+                        length.convert(),
+                        encoding.value,
+                        options
+                    )
+                }
+            }
+        }
         checkNotNull(tree) { "Parsing failed" }
-        return Tree(tree, source, language)
+        return Tree(tree, source, language).also { it.encoding = encoding }
     }
 
     /**
@@ -136,6 +242,7 @@ actual class Parser actual constructor() {
      *
      * @throws [IllegalStateException]
      *  If the parser does not have a [language] assigned or if parsing was halted.
+     * @throws [MemoryLimitExceededException] If the [memory limit][memoryLimitBytes] is exceeded.
      */
     @Throws(IllegalStateException::class)
     actual fun parse(
@@ -155,32 +262,74 @@ actual class Parser actual constructor() {
             read = staticCFunction { payload, index, point, bytes ->
                 val data = payload!!.asStableRef<ParsePayload>().get()
                 val result = data.callback(index, point.useContents { convert() })
-                bytes!!.pointed.value = result?.length?.convert() ?: 0U
-                result?.toString()?.cstr?.getPointer(data.memScope)
+                    ?.toString()?.encodeToByteArray()
+                bytes!!.pointed.value = result?.size?.convert() ?: 0U
+                result?.toCValues()?.getPointer(data.memScope)
             }
         }
-        var progressRef: StableRef<ParseProgressCallback>? = null
-        val tree = if (progressCallback == null) {
-            ts_parser_parse(self, oldTree?.self, input)
-        } else {
-            progressRef = StableRef.create(progressCallback)
-            val options = cValue<TSParseOptions> {
-                payload = progressRef.asCPointer()
-                progress_callback = staticCFunction { state ->
-                    val callback = state!!.pointed.payload!!
-                        .asStableRef<ParseProgressCallback>().get()
-                    callback(state.pointed.current_byte_offset, state.pointed.has_error)
+        val tree = try {
+            withMemoryScope {
+                withProgress(progressCallback) { options ->
+                    if (options == null) {
+                        ts_parser_parse(self, oldTree?.self, input)
+                    } else {
+                        ts_parser_parse_with_options(self, oldTree?.self, input, options)
+                    }
                 }
             }
-            ts_parser_parse_with_options(self, oldTree?.self, input, options)
+        } finally {
+            arena.clear()
+            payloadRef.dispose()
         }
-        arena.clear()
-        payloadRef.dispose()
-        progressRef?.dispose()
         checkNotNull(tree) { "Parsing failed" }
         return Tree(tree, null, language)
     }
 
+    /**
+     * Parse a new version of the source code of an old syntax tree.
+     *
+     * The changes between the [source text][Tree.text] of the old tree and [newSource]
+     * are computed and applied to a copy of the old tree, so that the unchanged parts
+     * of it can be reused without having to call [Tree.edit] manually. The old tree
+     * itself is left untouched. The edits are computed line by line and fall back
+     * to a single edit that spans all the changes when the versions differ too much.
+     * The old tree must have been parsed as [UTF-8][InputEncoding.UTF_8],
+     * and the new tree is parsed as UTF-8 as well.
+     *
+     * @throws [IllegalArgumentException]
+     *  If the old tree has no source text or was not parsed as UTF-8.
+     * @throws [IllegalStateException]
+     *  If the parser does not have a [language] assigned or if parsing was halted.
+     * @throws [MemoryLimitExceededException] If the [memory limit][memoryLimitBytes] is exceeded.
+     * @since 0.26.0
+     */
+    @Throws(IllegalArgumentException::class, IllegalStateException::class)
+    actual fun reparse(oldTree: Tree, newSource: String): Tree {
+        val oldSource = requireNotNull(oldTree.text()) {
+            "The old tree has no source text"
+        }.toString()
+        require(oldTree.encoding == InputEncoding.UTF_8) {
+            "The old tree was not parsed as UTF-8"
+        }
+        val editedTree = oldTree.copy()
+        memScoped {
+            val oldText = oldSource.cstr
+            val newText = newSource.cstr
+            val edits = allocArray<TSInputEdit>(KTS_DIFF_MAX_EDITS)
+            val count = kts_diff(
+                oldText.ptr,
+                (oldText.size - 1).convert(),
+                newText.ptr,
+                (newText.size - 1).convert(),
+                edits
+            )
+            chargedTo(editedTree.self) {
+                for (i in 0 until count.toInt()) ts_tree_edit(editedTree.self, edits[i].ptr)
+            }
+        }
+        return parse(newSource, InputEncoding.UTF_8, editedTree)
+    }
+
     /**
      * Instruct the parser to start the next [parse] from the beginning.
      *
@@ -188,25 +337,98 @@ actual class Parser actual constructor() {
      * it left off. If you don't want to resume, and instead intend to use this
      * parser to parse some other document, you must call this method first.
      */
-    actual fun reset() = ts_parser_reset(self)
+    actual fun reset() = chargedTo(self) { ts_parser_reset(self) }
 
     override fun toString() = "Parser(language=$language)"
 
     /** The type of a log message. */
     actual enum class LogType { LEX, PARSE }
 
+    @Throws(MemoryLimitExceededException::class)
+    private inline fun withMemoryScope(block: () -> CPointer<TSTree>?): CPointer<TSTree>? =
+        memScoped {
+            val scope = alloc<KtsMemoryScope>()
+            kts_memory_scope_enter(scope.ptr, memoryLimitBytes)
+            var tree = try {
+                block()
+            } catch (e: Throwable) {
+                kts_memory_charge(self, kts_memory_scope_leave(scope.ptr))
+                throw e
+            }
+            val exceeded = scope.budget.exceeded
+            if (exceeded) {
+                tree?.let(::ts_tree_delete)
+                ts_parser_reset(self)
+                tree = null
+            }
+            kts_memory_track_parse(self, tree, kts_memory_scope_leave(scope.ptr))
+            if (exceeded) {
+                throw MemoryLimitExceededException(
+                    "Memory limit of $memoryLimitBytes bytes exceeded"
+                )
+            }
+            tree
+        }
+
+    /**
+     * Call [parse] with the options for the progress [callback] and
+     * [progressListener], or with `null` if there is nothing to check.
+     */
+    private inline fun withProgress(
+        callback: ParseProgressCallback?,
+        parse: (CValue<TSParseOptions>?) -> CPointer<TSTree>?
+    ): CPointer<TSTree>? {
+        val listener = progressListener
+        if (callback == null && listener == null && memoryLimitBytes == 0UL) return parse(null)
+        val interval = listener?.let {
+            ProgressInterval(progressIntervalBytes, progressIntervalMicros)
+        }
+        val progressRef = StableRef.create(ProgressPayload(callback, listener, interval))
+        try {
+            return parse(
+                cValue<TSParseOptions> {
+                    payload = progressRef.asCPointer()
+                    progress_callback = checkProgress
+                }
+            )
+        } finally {
+            progressRef.dispose()
+        }
+    }
+
+    private class ProgressPayload(
+        val callback: ParseProgressCallback?,
+        val listener: ParseProgressListener?,
+        val interval: ProgressInterval?
+    ) {
+        operator fun invoke(offset: UInt, hasError: Boolean): Boolean {
+            if (kts_allocator_budget_exceeded()) return true
+            if (listener != null && interval!!.isDue(offset) &&
+                listener.onProgress(offset.toInt(), hasError)
+            ) {
+                return true
+            }
+            return callback?.invoke(offset, hasError) == true
+        }
+    }
+
     private class ParsePayload(
         val memScope: AutofreeScope,
         val callback: ParseReadCallback
     )
 
     private companion object {
+        private val checkProgress = staticCFunction { state: CPointer<TSParseState>? ->
+            state!!.pointed.payload!!.asStableRef<ProgressPayload>().get()(
+                state.pointed.current_byte_offset,
+                state.pointed.has_error
+            )
+        }
+
         private fun freeLogger(logger: CValue<TSLogger>) {
-            val arena = Arena()
-            interpretNullablePointed<TSLogger>(
-                arena.alloc(logger.size, logger.align).rawPtr
-            )?.payload?.asStableRef<TSLogger>()?.dispose()
-            arena.clear()
+            // Log buffers are owned by their own objects.
+            if (kts_log_buffer_is_logger(logger)) return
+            logger.useContents { payload?.asStableRef<LogFunction>()?.dispose() }
         }
     }
 }
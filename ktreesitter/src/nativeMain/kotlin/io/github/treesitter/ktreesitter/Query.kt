@@ -20,6 +20,16 @@ actual class Query @Throws(QueryError::class) actual constructor(
 ) {
     internal val self = init(language, source)
 
+    /**
+     * The number of bytes of native memory that are held by the query.
+     *
+     * This is always `0` when the [allocator][TreeSitter.allocator] is [NativeAllocator.SYSTEM].
+     *
+     * @since 0.26.0
+     */
+    actual val nativeSizeBytes: ULong
+        get() = kts_memory_size(self)
+
     /** The number of patterns in the query. */
     actual val patternCount: UInt = ts_query_pattern_count(self)
 
@@ -28,7 +38,7 @@ actual class Query @Throws(QueryError::class) actual constructor(
     actual val captureCount: UInt
         get() = ts_query_capture_count(self)
 
-    internal val predicates = List(patternCount.toInt()) { mutableListOf<QueryPredicate>() }
+    internal actual val predicates = List(patternCount.toInt()) { mutableListOf<QueryPredicate>() }
 
     private val settings = List(patternCount.toInt()) { mutableMapOf<String, String?>() }
 
@@ -288,7 +298,10 @@ actual class Query @Throws(QueryError::class) actual constructor(
 
     @Suppress("unused")
     @OptIn(ExperimentalNativeApi::class)
-    private val cleaner = createCleaner(self, ::ts_query_delete)
+    private val cleaner = createCleaner(self) {
+        kts_memory_untrack(it)
+        ts_query_delete(it)
+    }
 
     /**
      * Execute the query on the given [Node].
@@ -435,13 +448,15 @@ actual class Query @Throws(QueryError::class) actual constructor(
         private fun init(language: Language, source: String) = memScoped {
             val errorOffset = alloc<UIntVar>()
             val errorType = alloc<TSQueryError.Var>()
-            val query = ts_query_new(
-                language.self,
-                source,
-                source.length.convert(),
-                errorOffset.ptr,
-                errorType.ptr
-            )
+            val query = tracked(KTS_OBJECT_QUERY) {
+                ts_query_new(
+                    language.self,
+                    source,
+                    source.length.convert(),
+                    errorOffset.ptr,
+                    errorType.ptr
+                )
+            }
             if (query != null)
                 return@memScoped query
 
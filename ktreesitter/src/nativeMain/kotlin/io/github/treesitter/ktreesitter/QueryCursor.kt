@@ -18,28 +18,41 @@ actual class QueryCursor internal constructor(
 ) {
     internal val self = ts_query_cursor_new()!!
 
-    init {
-        if (progressCallback == null) {
-            ts_query_cursor_exec(self, query.self, node.self)
-        } else {
-            val progressRef = StableRef.create(progressCallback)
-            val options = cValue<TSQueryCursorOptions> {
-                payload = progressRef.asCPointer()
-                progress_callback = staticCFunction { state ->
-                    val callback = state!!.pointed.payload!!
-                        .asStableRef<QueryProgressCallback>().get()
-                    callback(state.pointed.current_byte_offset)
-                }
-            }
-            ts_query_cursor_exec_with_options(self, query.self, node.self, options)
-            progressRef.dispose()
+    // The cursor keeps a pointer to its options until the next exec,
+    // so they must be kept alive for as long as the cursor is.
+    private val arena = Arena()
+
+    private val progress = ProgressPayload(progressCallback)
+
+    private val progressRef = StableRef.create(progress)
+
+    private val budget = arena.alloc<KtsMemoryBudget>()
+
+    private val options = arena.alloc<TSQueryCursorOptions> {
+        payload = progressRef.asCPointer()
+        progress_callback = staticCFunction { state ->
+            state!!.pointed.payload!!.asStableRef<ProgressPayload>().get()(
+                state.pointed.current_byte_offset
+            )
         }
     }
 
+    init {
+        ts_query_cursor_exec_with_options(self, query.self, node.self, options.ptr)
+    }
+
     @Suppress("unused")
     @OptIn(ExperimentalNativeApi::class)
     private val cleaner = createCleaner(self, ::ts_query_cursor_delete)
 
+    @Suppress("unused")
+    @OptIn(ExperimentalNativeApi::class)
+    private val arenaCleaner = createCleaner(arena, Arena::clear)
+
+    @Suppress("unused")
+    @OptIn(ExperimentalNativeApi::class)
+    private val progressCleaner = createCleaner(progressRef) { it.dispose() }
+
     /**
      * The maximum duration in microseconds that query
      * execution should be allowed to take before halting.
@@ -83,6 +96,62 @@ actual class QueryCursor internal constructor(
             field = value
         }
 
+    /**
+     * The maximum number of bytes that a single execution
+     * of the query may allocate, or `0` if there is no limit.
+     *
+     * When the limit is exceeded, the execution is halted and iterating over
+     * the [matches] or [captures] throws a [MemoryLimitExceededException].
+     *
+     * Default: `0`
+     *
+     * @throws [IllegalStateException]
+     *  If a limit is set while the [allocator][TreeSitter.allocator] does not track memory.
+     * @since 0.26.0
+     */
+    @set:Throws(IllegalStateException::class)
+    actual var memoryLimitBytes: ULong = 0UL
+        set(value) {
+            checkMemoryLimit(value)
+            field = value
+        }
+
+    /**
+     * A listener that can halt the execution of the query.
+     *
+     * Unlike a [QueryProgressCallback], the listener receives an unboxed argument and is
+     * only called once every [progressIntervalBytes] or [progressIntervalMicros], so it
+     * is cheap enough to be kept around for cancellation.
+     *
+     * @since 0.26.0
+     */
+    actual var progressListener: QueryProgressListener? = null
+
+    /**
+     * The number of bytes that the cursor must advance
+     * before the [progressListener] is called again.
+     *
+     * If both this and [progressIntervalMicros] are `0`, the listener is called
+     * every time the cursor checks its progress. Otherwise, it is called as soon
+     * as either of the intervals has passed.
+     *
+     * Default: `0`
+     *
+     * @since 0.26.0
+     */
+    actual var progressIntervalBytes: UInt = 0U
+
+    /**
+     * The number of microseconds that must pass before
+     * the [progressListener] is called again.
+     *
+     * Default: `0`
+     *
+     * @see progressIntervalBytes
+     * @since 0.26.0
+     */
+    actual var progressIntervalMicros: ULong = 0UL
+
     /**
      * The range of bytes in which the query will be executed.
      *
@@ -134,6 +203,24 @@ actual class QueryCursor internal constructor(
     actual val didExceedMatchLimit: Boolean
         get() = ts_query_cursor_did_exceed_match_limit(self)
 
+    /**
+     * The profile that records the statistics of every pattern
+     * that is matched by this cursor, or `null` if it is not profiled.
+     *
+     * Default: `null`
+     *
+     * @throws [IllegalArgumentException] If the profile was created for a different query.
+     * @since 0.26.0
+     */
+    @set:Throws(IllegalArgumentException::class)
+    actual var profile: QueryProfile? = null
+        set(value) {
+            require(value == null || value.query === query) {
+                "The profile was created for a different query"
+            }
+            field = value
+        }
+
     /**
      * Iterate over all the matches in the order that they were found.
      *
@@ -153,10 +240,11 @@ actual class QueryCursor internal constructor(
     actual fun matches(predicate: QueryPredicate.(QueryMatch) -> Boolean) = sequence<QueryMatch> {
         memScoped {
             val match = alloc<TSQueryMatch>()
-            while (ts_query_cursor_next_match(self, match.ptr)) {
+            while (withMemoryLimit { ts_query_cursor_next_match(self, match.ptr) }) {
                 match.convert(predicate)?.let { yield(it) }
             }
         }
+        profile?.finish(didExceedMatchLimit)
     }
 
     /**
@@ -171,16 +259,61 @@ actual class QueryCursor internal constructor(
             memScoped {
                 val match = alloc<TSQueryMatch>()
                 val index = alloc<UIntVar>()
-                while (ts_query_cursor_next_capture(self, match.ptr, index.ptr)) {
-                    match.convert(predicate)?.let { yield(index.value to it) }
+                while (
+                    withMemoryLimit { ts_query_cursor_next_capture(self, match.ptr, index.ptr) }
+                ) {
+                    // The same match is returned for each of its captures, in order
+                    val isLast = index.value == match.capture_count.toUInt() - 1U
+                    match.convert(predicate, isLast)?.let { yield(index.value to it) }
                 }
             }
+            profile?.finish(didExceedMatchLimit)
         }
 
     override fun toString() = "QueryCursor(query=$query, node=$node)"
 
+    @Throws(MemoryLimitExceededException::class)
+    private inline fun withMemoryLimit(block: () -> Boolean): Boolean {
+        val listener = progressListener
+        progress.listener = listener
+        if (listener != null) {
+            progress.interval = ProgressInterval(progressIntervalBytes, progressIntervalMicros)
+        }
+        if (memoryLimitBytes == 0UL) return block()
+        budget.limit = memoryLimitBytes
+        val previousBudget = kts_allocator_swap_budget(budget.ptr)
+        val result = try {
+            block()
+        } finally {
+            kts_allocator_swap_budget(previousBudget)
+        }
+        if (budget.exceeded) {
+            throw MemoryLimitExceededException("Memory limit of $memoryLimitBytes bytes exceeded")
+        }
+        return result
+    }
+
+    private class ProgressPayload(private val callback: QueryProgressCallback?) {
+        var listener: QueryProgressListener? = null
+
+        var interval: ProgressInterval? = null
+
+        operator fun invoke(offset: UInt): Boolean {
+            if (kts_allocator_budget_exceeded()) return true
+            val listener = listener
+            if (listener != null && interval!!.isDue(offset) &&
+                listener.onProgress(offset.toInt())
+            ) {
+                return true
+            }
+            return callback?.invoke(offset) == true
+        }
+    }
+
+    /** Convert the match and evaluate its predicates, recording it in the profile if [record]. */
     private fun TSQueryMatch.convert(
-        predicate: QueryPredicate.(QueryMatch) -> Boolean
+        predicate: QueryPredicate.(QueryMatch) -> Boolean,
+        record: Boolean = true
     ): QueryMatch? {
         val index = pattern_index.convert<UInt>()
         val captures = (UShort.MIN_VALUE..<capture_count).map {
@@ -190,11 +323,17 @@ actual class QueryCursor internal constructor(
                 query.captureNames[c.index.toInt()]
             )
         }
-        return QueryMatch(index, captures).takeIf { match ->
-            node.tree.text() == null ||
-                query.predicates[index.toInt()].all {
-                    if (it !is QueryPredicate.Generic) it(match) else predicate(it, match)
-                }
+        val match = QueryMatch(index, captures)
+        val profile = profile?.takeIf { record } ?: return match.takeIf { it.evaluate(predicate) }
+        return match.takeIf { profile.record(it) { it.evaluate(predicate) } }
+    }
+
+    private inline fun QueryMatch.evaluate(
+        predicate: QueryPredicate.(QueryMatch) -> Boolean
+    ): Boolean {
+        if (node.tree.text() == null) return true
+        return query.predicates[patternIndex.toInt()].all {
+            if (it !is QueryPredicate.Generic) it(this) else predicate(it, this)
         }
     }
 }
@@ -0,0 +1,7 @@
+package io.github.treesitter.ktreesitter
+
+internal actual fun Char.encodedSize() = when {
+    this < '\u0080' -> 1
+    this < '\u0800' || isSurrogate() -> 2
+    else -> 3
+}
@@ -14,13 +14,27 @@ actual class Tree internal constructor(
     /** The language that was used to parse the syntax tree. */
     actual val language: Language
 ) {
+    /** The pointer that the cleaner frees, which is cleared when the tree is released. */
+    private val handle = nativeHeap.alloc<COpaquePointerVar>().apply { value = self }
+
     @Suppress("unused")
     @OptIn(ExperimentalNativeApi::class)
-    private val cleaner = createCleaner(self, ::ts_tree_delete)
+    private val cleaner = createCleaner(handle) {
+        it.value?.reinterpret<TSTree>()?.let { tree ->
+            kts_memory_untrack(tree)
+            ts_tree_delete(tree)
+        }
+        nativeHeap.free(it)
+    }
 
     /** The root node of the syntax tree. */
     actual val rootNode = Node(ts_tree_root_node(self), this)
 
+    private var lineIndex: LineIndex? = null
+
+    /** The encoding that the source code of the syntax tree was parsed with. */
+    internal var encoding = InputEncoding.UTF_8
+
     /** The included ranges of the syntax tree. */
     actual val includedRanges by lazy {
         memScoped {
@@ -32,6 +46,20 @@ actual class Tree internal constructor(
         }
     }
 
+    /**
+     * The number of bytes of native memory that were allocated for the syntax tree.
+     *
+     * Subtrees that were reused from other trees, such as the trees that this
+     * tree was [copied][copy] from or incrementally parsed from, are not included.
+     * This is read without walking the tree, and it is always `0` when the
+     * [allocator][TreeSitter.allocator] is [NativeAllocator.SYSTEM].
+     * Use [TreeSitter.nativeSizeBytes] to measure the whole memory of several trees.
+     *
+     * @since 0.26.0
+     */
+    actual val nativeSizeBytes: ULong
+        get() = kts_memory_size(self)
+
     /**
      * Get the root node of the syntax tree, but with
      * its position shifted forward by the given offset.
@@ -47,7 +75,28 @@ actual class Tree internal constructor(
      */
     actual fun edit(edit: InputEdit) {
         val inputEdit = cValue<TSInputEdit> { from(edit) }
-        ts_tree_edit(self, inputEdit)
+        chargedTo(self) { ts_tree_edit(self, inputEdit) }
+        source = null
+    }
+
+    /**
+     * Edit the syntax tree with a batch of edits, which are applied in order.
+     *
+     * This is equivalent to calling [edit] for every edit, and [Node.edit]
+     * for every edit on each of the given [nodes], but it is much faster.
+     *
+     * @param nodes The nodes that should also be kept in sync with the edits.
+     * @since 0.26.0
+     */
+    @OptIn(ExperimentalMultiplatform::class)
+    actual fun edit(edits: List<InputEdit>, nodes: List<Node>) {
+        if (edits.isEmpty()) return
+        chargedTo(self) {
+            for (edit in edits) {
+                ts_tree_edit(self, cValue<TSInputEdit> { from(edit) })
+                for (node in nodes) node.edit(edit)
+            }
+        }
         source = null
     }
 
@@ -57,7 +106,10 @@ actual class Tree internal constructor(
      * You need to copy a syntax tree in order to use it on multiple
      * threads or coroutines, as syntax trees are not thread safe.
      */
-    actual fun copy() = Tree(ts_tree_copy(self)!!, source, language)
+    actual fun copy() =
+        Tree(tracked(KTS_OBJECT_TREE) { ts_tree_copy(self) }!!, source, language).also {
+            it.encoding = encoding
+        }
 
     /** Create a new tree cursor starting from the node of the tree. */
     actual fun walk() = TreeCursor(rootNode)
@@ -65,6 +117,18 @@ actual class Tree internal constructor(
     /** Get the source code of the syntax tree, if available. */
     actual fun text(): CharSequence? = source
 
+    /**
+     * Get a [line index][LineIndex] of the source code of the syntax tree, if available.
+     *
+     * The index is created on the first call and reused afterwards.
+     *
+     * @since 0.26.0
+     */
+    actual fun lineIndex(): LineIndex? {
+        val source = source ?: return null
+        return lineIndex ?: LineIndex(source).also { lineIndex = it }
+    }
+
     /**
      * Compare an old edited syntax tree to a new
      * syntax tree representing the same document.
@@ -83,5 +147,36 @@ actual class Tree internal constructor(
         return result
     }
 
+    /**
+     * Compute the structural differences between the named nodes
+     * of an old edited syntax tree and a new syntax tree.
+     *
+     * For this to work correctly, this tree must have been edited
+     * such that its ranges match up to the new tree, and the new
+     * tree must have been parsed with this tree as the old tree.
+     *
+     * @throws [IllegalStateException] If the differences could not be allocated.
+     * @since 0.26.0
+     */
+    @Throws(IllegalStateException::class)
+    actual fun diff(newTree: Tree): TreeDiff = memScoped {
+        val edits = alloc<CPointerVar<IntVar>>()
+        val count = alloc<UIntVar>()
+        check(kts_tree_diff(self, newTree.self, edits.ptr, count.ptr)) {
+            "Failed to allocate the tree diff"
+        }
+        val size = count.value.toInt() * KTS_TREE_DIFF_EDIT_SIZE
+        val result = IntArray(size) { edits.value!![it] }
+        kts_tree_diff_free(edits.value)
+        return TreeDiff(result)
+    }
+
     override fun toString() = "Tree(language=$language, source=$source)"
+
+    internal actual fun release() {
+        if (handle.value == null) return
+        handle.value = null
+        kts_memory_untrack(self)
+        ts_tree_delete(self)
+    }
 }
@@ -0,0 +1,96 @@
+package io.github.treesitter.ktreesitter
+
+import cnames.structs.TSTree
+import io.github.treesitter.ktreesitter.internal.*
+import kotlinx.cinterop.*
+
+/**
+ * Global settings and statistics of the native library.
+ *
+ * @since 0.26.0
+ */
+@OptIn(ExperimentalForeignApi::class)
+actual object TreeSitter {
+    /** The allocator that is used by the native library. */
+    actual val allocator: NativeAllocator
+        get() = NativeAllocator.entries[kts_allocator_kind().toInt()]
+
+    /**
+     * The number of bytes that are currently allocated by the native library.
+     *
+     * This is always `0` when the [allocator] is [NativeAllocator.SYSTEM].
+     */
+    actual val allocatedBytes: ULong
+        get() = stats { allocated_bytes }
+
+    /**
+     * The highest number of bytes that have been allocated at once.
+     *
+     * This is always `0` when the [allocator] is [NativeAllocator.SYSTEM].
+     */
+    actual val peakAllocatedBytes: ULong
+        get() = stats { peak_allocated_bytes }
+
+    /**
+     * The number of memory blocks that are currently allocated by the native library.
+     *
+     * This is always `0` when the [allocator] is [NativeAllocator.SYSTEM].
+     */
+    actual val allocationCount: ULong
+        get() = stats { allocation_count }
+
+    /**
+     * Get the native memory that is held by the live parsers, trees and queries.
+     */
+    actual fun nativeMemoryStats() = NativeMemoryStats(
+        objectStats(KTS_OBJECT_PARSER),
+        objectStats(KTS_OBJECT_TREE),
+        objectStats(KTS_OBJECT_QUERY)
+    )
+
+    /**
+     * Get the number of bytes of native memory that are held by the given trees.
+     *
+     * Unlike the sum of their [sizes][Tree.nativeSizeBytes],
+     * subtrees that are shared between the trees are only counted once.
+     */
+    actual fun nativeSizeBytes(trees: Collection<Tree>) = memScoped {
+        val pointers = allocArray<CPointerVar<TSTree>>(trees.size)
+        trees.forEachIndexed { i, tree -> pointers[i] = tree.self }
+        kts_tree_size(pointers, trees.size.convert())
+    }
+
+    /**
+     * Use the given [allocator] for the native library.
+     *
+     * This must be called before any other object of
+     * the library is created, and it can only be called once.
+     *
+     * @throws [IllegalStateException]
+     *  If a different allocator has already been installed, or if
+     *  a [Parser], [Tree] or [Query] has already been created.
+     */
+    @Throws(IllegalStateException::class)
+    fun useAllocator(allocator: NativeAllocator) {
+        check(kts_allocator_install(allocator.ordinal.convert())) {
+            if (this.allocator != NativeAllocator.SYSTEM) {
+                "The ${this.allocator} allocator has already been installed"
+            } else {
+                "The allocator cannot be changed while native objects are alive"
+            }
+        }
+    }
+
+    private fun objectStats(kind: Int) = memScoped {
+        val stats = alloc<KtsObjectStats>()
+        kts_memory_stats(kind.convert(), stats.ptr)
+        NativeMemoryStats.ObjectStats(stats.live_objects, stats.bytes)
+    }
+
+    private inline fun stats(block: KtsAllocatorStats.() -> ULong) = memScoped {
+        alloc<KtsAllocatorStats>().run {
+            kts_allocator_stats(ptr)
+            block()
+        }
+    }
+}
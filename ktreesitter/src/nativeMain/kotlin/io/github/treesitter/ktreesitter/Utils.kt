@@ -3,6 +3,8 @@
 package io.github.treesitter.ktreesitter
 
 import io.github.treesitter.ktreesitter.internal.*
+import kotlin.time.Duration.Companion.microseconds
+import kotlin.time.TimeSource
 import kotlinx.cinterop.*
 
 @ExperimentalForeignApi
@@ -43,3 +45,59 @@ internal inline fun CValue<TSNode>.convert(tree: Tree) =
 @ExperimentalForeignApi
 internal inline val <reified T : CVariable> CValue<T>.ptr: CPointer<T>
     get() = place(kts_malloc(sizeOf<T>().convert())!!.reinterpret())
+
+/** Create a native object and attribute the bytes allocated by [create] to it. */
+@ExperimentalForeignApi
+internal inline fun <T : CPointer<*>?> tracked(kind: Int, create: () -> T): T = memScoped {
+    val scope = alloc<KtsMemoryScope>()
+    kts_memory_scope_enter(scope.ptr, 0UL)
+    val result = create()
+    kts_memory_track(kind.convert(), result, kts_memory_scope_leave(scope.ptr))
+    result
+}
+
+/** Attribute the bytes allocated by [block] to the given native object. */
+@ExperimentalForeignApi
+internal inline fun <T> chargedTo(owner: CPointer<*>, block: () -> T): T = memScoped {
+    val scope = alloc<KtsMemoryScope>()
+    kts_memory_scope_enter(scope.ptr, 0UL)
+    try {
+        block()
+    } finally {
+        kts_memory_charge(owner, kts_memory_scope_leave(scope.ptr))
+    }
+}
+
+/** The intervals between the calls of a progress listener. */
+internal class ProgressInterval(private val bytes: UInt, micros: ULong) {
+    private val duration = micros.toLong().microseconds
+
+    private var nextOffset = 0U
+
+    private var deadline = TimeSource.Monotonic.markNow()
+
+    init {
+        start(0U)
+    }
+
+    /** Check if the listener is due at the given byte offset. */
+    fun isDue(offset: UInt): Boolean {
+        if (bytes == 0U && !duration.isPositive()) return true
+        if ((bytes != 0U && offset >= nextOffset) ||
+            (duration.isPositive() && deadline.hasPassedNow())
+        ) {
+            start(offset)
+            return true
+        }
+        return false
+    }
+
+    private fun start(offset: UInt) {
+        nextOffset = if (offset > UInt.MAX_VALUE - bytes) UInt.MAX_VALUE else offset + bytes
+        if (duration.isPositive()) deadline = TimeSource.Monotonic.markNow() + duration
+    }
+}
+
+@ExperimentalForeignApi
+internal inline fun TSLogType.convert() =
+    if (this == TSLogType.TSLogTypeLex) Parser.LogType.LEX else Parser.LogType.PARSE
@@ -39,6 +39,7 @@ grammar {
     grammarName = project.name
     className = "TreeSitterJava"
     packageName = "io.github.treesitter.ktreesitter.java"
+    nodeTypes = true
 }
 
 val generateTask = tasks.generateGrammarFiles.get()
@@ -79,6 +80,7 @@ kotlin {
 
             dependencies {
                 implementation(libs.kotlin.stdlib)
+                api(project(":ktreesitter"))
             }
         }
 
@@ -10,6 +10,8 @@ pluginManagement {
 }
 
 include(":ktreesitter")
+include(":ktreesitter-coroutines")
+include(":benchmarks")
 
 file("languages").listFiles { file -> file.isDirectory }?.forEach {
     include(":languages:${it.name}")